@@ -5,7 +5,11 @@
 .global write_csr_satp
 .global switch_context
 .global enable_interrupts
+.global interrupts_disable
+.global interrupts_restore
 .global wait_for_interrupt
+.global cpu_id
+.global read_time
 
 # SBI call function
 # struct sbiret sbi_call(long arg0, long arg1, long arg2, long arg3, long arg4, long arg5, long fid, long eid)
@@ -49,6 +53,13 @@ write_csr_satp:
     sfence.vma
     ret
 
+# Write STVEC CSR (trap vector, direct mode)
+# void write_csr_stvec(uint32_t value)
+.global write_csr_stvec
+write_csr_stvec:
+    csrw stvec, a0
+    ret
+
 # Read SCAUSE CSR
 # uint32_t read_csr_scause(void)
 .global read_csr_scause
@@ -132,15 +143,159 @@ enable_interrupts:
     csrsi sstatus, 0x2
     ret
 
+# Turn interrupts off, returning the previous sstatus.SIE
+# uint32_t interrupts_disable(void)
+interrupts_disable:
+    csrrci a0, sstatus, 0x2
+    andi a0, a0, 0x2
+    ret
+
+# Turn interrupts back on if interrupts_disable found them on
+# void interrupts_restore(uint32_t saved)
+interrupts_restore:
+    csrs sstatus, a0
+    ret
+
 # Wait for interrupt
 # void wait_for_interrupt(void)  
 wait_for_interrupt:
     wfi
     ret
 
+# Current hart id (boot copies the id OpenSBI passes in a0 into tp; callers index with % MAX_HARTS)
+# uint32_t cpu_id(void)
+cpu_id:
+    mv a0, tp
+    ret
+
+# Read the 64-bit time counter (re-read if the high word ticked over)
+# uint64_t read_time(void)
+read_time:
+    rdtimeh a1
+    rdtime a0
+    rdtimeh t0
+    bne a1, t0, read_time
+    ret
+
+# Turn on the vector unit if the hart has one: sstatus.VS stays 0 without V
+# uint32_t vector_probe(void)
+.global vector_probe
+vector_probe:
+    li t0, (1 << 9)        # VS = Initial
+    csrs sstatus, t0
+    csrr a0, sstatus
+    srli a0, a0, 9
+    andi a0, a0, 3
+    ret
+
+# RVV copy/fill loops, only called after vector_probe found V
+# (the rest of the kernel is built without V, so enable it just here)
+.option push
+.option arch, +v
+
+# void *memcpy_rvv(void *dst, const void *src, size_t n)
+.global memcpy_rvv
+memcpy_rvv:
+    mv t1, a0
+1:
+    vsetvli t0, a2, e8, m8, ta, ma
+    vle8.v v0, (a1)
+    vse8.v v0, (t1)
+    add a1, a1, t0
+    add t1, t1, t0
+    sub a2, a2, t0
+    bnez a2, 1b
+    ret
+
+# void *memset_rvv(void *s, int c, size_t n)
+.global memset_rvv
+memset_rvv:
+    mv t1, a0
+    vsetvli t0, a2, e8, m8, ta, ma
+    vmv.v.x v0, a1
+1:
+    vsetvli t0, a2, e8, m8, ta, ma
+    vse8.v v0, (t1)
+    add t1, t1, t0
+    sub a2, a2, t0
+    bnez a2, 1b
+    ret
+
+# String loops: fault-only-first loads stop at the end of mapped memory instead
+# of trapping, so reading ahead of the terminator is safe
+
+# size_t strlen_rvv(const char *s)
+.global strlen_rvv
+strlen_rvv:
+    mv t1, a0
+1:
+    vsetvli t0, zero, e8, m8, ta, ma
+    vle8ff.v v0, (t1)
+    csrr t0, vl
+    vmseq.vi v8, v0, 0
+    vfirst.m t2, v8
+    bgez t2, 2f
+    add t1, t1, t0
+    j 1b
+2:
+    add t1, t1, t2
+    sub a0, t1, a0
+    ret
+
+# int strcmp_rvv(const char *s1, const char *s2)
+.global strcmp_rvv
+strcmp_rvv:
+1:
+    vsetvli t0, zero, e8, m8, ta, ma
+    vle8ff.v v0, (a0)
+    vle8ff.v v8, (a1)          # vl is now what both loads could read
+    csrr t0, vl
+    vmsne.vv v16, v0, v8
+    vmseq.vi v17, v0, 0
+    vmor.mm v16, v16, v17
+    vfirst.m t2, v16
+    bgez t2, 2f
+    add a0, a0, t0
+    add a1, a1, t0
+    j 1b
+2:
+    add a0, a0, t2
+    add a1, a1, t2
+    lbu a0, 0(a0)
+    lbu a1, 0(a1)
+    sub a0, a0, a1
+    ret
+
+# char *strchr_rvv(const char *s, int c)
+.global strchr_rvv
+strchr_rvv:
+    andi a1, a1, 0xff
+1:
+    vsetvli t0, zero, e8, m8, ta, ma
+    vle8ff.v v0, (a0)
+    csrr t0, vl
+    vmseq.vx v8, v0, a1
+    vmseq.vi v9, v0, 0
+    vmor.mm v8, v8, v9
+    vfirst.m t2, v8
+    bgez t2, 2f
+    add a0, a0, t0
+    j 1b
+2:
+    add a0, a0, t2
+    lbu t2, 0(a0)
+    beq t2, a1, 3f
+    li a0, 0                   # Hit the terminator first
+3:
+    ret
+
+.option pop
+
 # Kernel entry function for trap handling
 # void kernel_entry(void)
+# stvec needs a 4-byte aligned address (the low bits select the mode)
 .global kernel_entry
+.balign 4
 kernel_entry:
     csrw sscratch, sp
     addi sp, sp, -4 * 31
@@ -219,7 +374,7 @@ kernel_entry:
 .global boot
 .section .text.boot
 boot:
-    mv tp, zero
+    mv tp, a0              # Hart id from OpenSBI, read back by cpu_id
     mv t0, zero
     mv t1, zero
     mv t2, zero
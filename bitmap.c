@@ -0,0 +1,127 @@
+#include "bitmap.h"
+
+// de Bruijn 수열로 최하위 비트 위치 계산 (Zbb의 ctz가 없어도 분기 없이 동작)
+static const uint8_t debruijn_ctz[32] = {
+    0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+    31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9,
+};
+
+int bitmap_ctz(uint32_t word) {
+    return debruijn_ctz[((word & -word) * 0x077CB531u) >> 27];
+}
+
+void bitmap_init(uint32_t *bitmap, int bits) {
+    for (int i = 0; i < (bits + 31) / 32; i++) {
+        bitmap[i] = 0;
+    }
+}
+
+void bitmap_set(uint32_t *bitmap, int bit) {
+    bitmap[bit / 32] |= (1u << (bit % 32));
+}
+
+void bitmap_clear(uint32_t *bitmap, int bit) {
+    bitmap[bit / 32] &= ~(1u << (bit % 32));
+}
+
+int bitmap_test(const uint32_t *bitmap, int bit) {
+    return (bitmap[bit / 32] & (1u << (bit % 32))) != 0;
+}
+
+// bit부터 end 전까지, 같은 워드 안에 들어가는 비트들의 마스크
+static uint32_t range_mask(int bit, int end, int *n) {
+    int shift = bit % 32;
+    int len = 32 - shift;
+    if (len > end - bit) {
+        len = end - bit;
+    }
+    *n = len;
+    return (len == 32 ? 0xFFFFFFFFu : ((1u << len) - 1)) << shift;
+}
+
+void bitmap_set_range(uint32_t *bitmap, int start, int count) {
+    int end = start + count;
+    int n;
+    for (int bit = start; bit < end; bit += n) {
+        bitmap[bit / 32] |= range_mask(bit, end, &n);
+    }
+}
+
+void bitmap_clear_range(uint32_t *bitmap, int start, int count) {
+    int end = start + count;
+    int n;
+    for (int bit = start; bit < end; bit += n) {
+        bitmap[bit / 32] &= ~range_mask(bit, end, &n);
+    }
+}
+
+int bitmap_find_zero(const uint32_t *bitmap, int start, int end) {
+    if (start >= end) {
+        return -1;
+    }
+
+    int i = start / 32;
+    int last = (end - 1) / 32;
+    uint32_t word = ~bitmap[i] & (0xFFFFFFFFu << (start % 32));
+
+    // Skip fully used words
+    while (word == 0) {
+        if (++i > last) {
+            return -1;
+        }
+        word = ~bitmap[i];
+    }
+
+    int bit = i * 32 + bitmap_ctz(word);
+    return bit < end ? bit : -1;
+}
+
+int bitmap_find_set(const uint32_t *bitmap, int start, int end) {
+    if (start >= end) {
+        return end;
+    }
+
+    int i = start / 32;
+    int last = (end - 1) / 32;
+    uint32_t word = bitmap[i] & (0xFFFFFFFFu << (start % 32));
+
+    // Skip fully free words
+    while (word == 0) {
+        if (++i > last) {
+            return end;
+        }
+        word = bitmap[i];
+    }
+
+    int bit = i * 32 + bitmap_ctz(word);
+    return bit < end ? bit : end;
+}
+
+int bitmap_find_free_run(const uint32_t *bitmap, int start, int end, int count, int *run_len) {
+    int best = -1;
+    int best_len = 0;
+    int pos = start;
+
+    while (pos < end) {
+        int run = bitmap_find_zero(bitmap, pos, end);
+        if (run < 0) {
+            break;
+        }
+
+        // Only look as far as count bits past the start of the run
+        int limit = end - run > count ? run + count : end;
+        int run_end = bitmap_find_set(bitmap, run, limit);
+
+        if (run_end - run > best_len) {
+            best = run;
+            best_len = run_end - run;
+            if (best_len == count) {
+                break;
+            }
+        }
+        pos = run_end;
+    }
+
+    *run_len = best_len;
+    return best;
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include "kernel.h"
+
+// 할당 비트맵 (비트 1 = 사용 중)
+// 검색은 32비트 워드 단위로 건너뛰고, 워드 안에서는 최하위 비트 위치로 바로 찾음
+
+// 워드에서 가장 낮은 1비트의 위치 (word != 0)
+int bitmap_ctz(uint32_t word);
+
+void bitmap_init(uint32_t *bitmap, int bits);
+void bitmap_set(uint32_t *bitmap, int bit);
+void bitmap_clear(uint32_t *bitmap, int bit);
+int bitmap_test(const uint32_t *bitmap, int bit);
+void bitmap_set_range(uint32_t *bitmap, int start, int count);
+void bitmap_clear_range(uint32_t *bitmap, int start, int count);
+
+// [start, end)에서 첫 번째 빈 비트 (없으면 -1)
+int bitmap_find_zero(const uint32_t *bitmap, int start, int end);
+
+// [start, end)에서 첫 번째 사용 중 비트 (없으면 end)
+int bitmap_find_set(const uint32_t *bitmap, int start, int end);
+
+// [start, end)에서 count개짜리 첫 빈 구간을 찾고, 없으면 가장 긴 빈 구간을 돌려줌
+// 구간 길이는 *run_len, 빈 비트가 하나도 없으면 -1 반환
+int bitmap_find_free_run(const uint32_t *bitmap, int start, int end, int count, int *run_len);
@@ -0,0 +1,117 @@
+#include "blkdev.h"
+#include "string.h"
+
+int blkdev_read(struct block_device *dev, uint32_t block, uint32_t count, void *buf) {
+    if (!dev || block >= dev->block_count || count > dev->block_count - block) {
+        printf("Error: %s: read of blocks %u+%u out of range\n", dev ? dev->name : "?", block, count);
+        return -1;
+    }
+    return dev->ops->read(dev, block, count, buf);
+}
+
+int blkdev_write(struct block_device *dev, uint32_t block, uint32_t count, const void *buf) {
+    if (!dev || block >= dev->block_count || count > dev->block_count - block) {
+        printf("Error: %s: write of blocks %u+%u out of range\n", dev ? dev->name : "?", block, count);
+        return -1;
+    }
+    return dev->ops->write(dev, block, count, buf);
+}
+
+// 조각 목록 검사 (범위 안이면 전체 블록 수, 아니면 -1)
+static int blkdev_check_segments(struct block_device *dev, uint32_t block, const struct blkdev_segment *segs,
+                                 int nsegs, const char *op) {
+    uint32_t count = 0;
+    for (int i = 0; i < nsegs; i++) {
+        count += segs[i].count;
+    }
+    if (!dev || nsegs <= 0 || nsegs > BLKDEV_MAX_SEGMENTS ||
+        block >= dev->block_count || count > dev->block_count - block) {
+        printf("Error: %s: %s of blocks %u+%u out of range\n", dev ? dev->name : "?", op, block, count);
+        return -1;
+    }
+    return (int)count;
+}
+
+int blkdev_read_segments(struct block_device *dev, uint32_t block, const struct blkdev_segment *segs, int nsegs) {
+    if (blkdev_check_segments(dev, block, segs, nsegs, "read") < 0) {
+        return -1;
+    }
+
+    if (dev->ops->read_segments) {
+        return dev->ops->read_segments(dev, block, segs, nsegs);
+    }
+    for (int i = 0; i < nsegs; i++) {
+        if (dev->ops->read(dev, block, segs[i].count, segs[i].buf) < 0) {
+            return -1;
+        }
+        block += segs[i].count;
+    }
+    return 0;
+}
+
+int blkdev_write_segments(struct block_device *dev, uint32_t block, const struct blkdev_segment *segs, int nsegs) {
+    if (blkdev_check_segments(dev, block, segs, nsegs, "write") < 0) {
+        return -1;
+    }
+
+    if (dev->ops->write_segments) {
+        return dev->ops->write_segments(dev, block, segs, nsegs);
+    }
+    for (int i = 0; i < nsegs; i++) {
+        if (dev->ops->write(dev, block, segs[i].count, segs[i].buf) < 0) {
+            return -1;
+        }
+        block += segs[i].count;
+    }
+    return 0;
+}
+
+int blkdev_flush(struct block_device *dev) {
+    if (!dev) {
+        return -1;
+    }
+    return dev->ops->flush ? dev->ops->flush(dev) : 0;
+}
+
+// RAM 디스크: 블록을 메모리에 그대로 보관
+static int ramdisk_read(struct block_device *dev, uint32_t block, uint32_t count, void *buf) {
+    memcpy(buf, (const uint8_t *)dev->ctx + block * BLKDEV_BLOCK_SIZE, count * BLKDEV_BLOCK_SIZE);
+    return 0;
+}
+
+static int ramdisk_write(struct block_device *dev, uint32_t block, uint32_t count, const void *buf) {
+    memcpy((uint8_t *)dev->ctx + block * BLKDEV_BLOCK_SIZE, buf, count * BLKDEV_BLOCK_SIZE);
+    return 0;
+}
+
+static struct block_device_ops ramdisk_ops = {
+    .read = ramdisk_read,
+    .write = ramdisk_write,
+};
+
+struct block_device *ramdisk_create(uint32_t block_count) {
+    struct block_device *dev = (struct block_device *)kmalloc(sizeof(struct block_device));
+    if (!dev) {
+        return NULL;
+    }
+
+    dev->ctx = kmalloc(block_count * BLKDEV_BLOCK_SIZE);
+    if (!dev->ctx) {
+        kfree(dev);
+        return NULL;
+    }
+    memset(dev->ctx, 0, block_count * BLKDEV_BLOCK_SIZE);
+
+    dev->name = "ramdisk";
+    dev->block_count = block_count;
+    dev->ops = &ramdisk_ops;
+    return dev;
+}
+
+void ramdisk_destroy(struct block_device *dev) {
+    if (!dev) {
+        return;
+    }
+    kfree(dev->ctx);
+    kfree(dev);
+}
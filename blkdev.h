@@ -0,0 +1,54 @@
+#pragma once
+#include "kernel.h"
+
+// 블록 장치 계층: 파일시스템은 블록 번호로만 장치를 읽고 씀
+// 블록 크기는 파일시스템 블록(FS_BLOCK_SIZE) 및 virtio 섹터와 같은 512바이트
+#define BLKDEV_BLOCK_SIZE 512
+
+// 요청 하나에 담을 수 있는 메모리 조각 수 (virtio 큐의 디스크립터 수에 맞춤)
+#define BLKDEV_MAX_SEGMENTS 8
+
+struct block_device;
+
+// 연속 블록 구간의 일부를 담은 메모리 조각
+struct blkdev_segment {
+    void *buf;
+    uint32_t count;                              // Blocks in this piece
+};
+
+// 장치별 연산 (count개의 연속 블록을 한 번에 전송)
+// *_segments와 flush는 선택: 없으면 조각마다 read/write, flush는 아무것도 하지 않음
+struct block_device_ops {
+    int (*read)(struct block_device *dev, uint32_t block, uint32_t count, void *buf);
+    int (*write)(struct block_device *dev, uint32_t block, uint32_t count, const void *buf);
+    int (*read_segments)(struct block_device *dev, uint32_t block,
+                         const struct blkdev_segment *segs, int nsegs);
+    int (*write_segments)(struct block_device *dev, uint32_t block,
+                          const struct blkdev_segment *segs, int nsegs);
+    int (*flush)(struct block_device *dev);
+};
+
+struct block_device {
+    const char *name;                            // 장치 이름 (출력용)
+    uint32_t block_count;                        // 전체 블록 수
+    struct block_device_ops *ops;                // 장치 연산
+    void *ctx;                                   // 장치별 상태
+};
+
+// 범위를 검사한 뒤 장치 연산 호출 (성공 0, 실패 -1)
+int blkdev_read(struct block_device *dev, uint32_t block, uint32_t count, void *buf);
+int blkdev_write(struct block_device *dev, uint32_t block, uint32_t count, const void *buf);
+
+// block부터 이어지는 블록을 흩어진 버퍼 조각들로/에서 한 요청으로 읽기/기록
+int blkdev_read_segments(struct block_device *dev, uint32_t block, const struct blkdev_segment *segs, int nsegs);
+int blkdev_write_segments(struct block_device *dev, uint32_t block, const struct blkdev_segment *segs, int nsegs);
+
+// 장치의 쓰기 캐시를 비워 기록한 블록을 영구 저장
+int blkdev_flush(struct block_device *dev);
+
+// kmalloc 메모리로 만든 RAM 디스크
+struct block_device *ramdisk_create(uint32_t block_count);
+void ramdisk_destroy(struct block_device *dev);
+
+// virtio-mmio 블록 장치 검색 및 초기화 (없으면 NULL)
+struct block_device *virtio_blk_probe(void);
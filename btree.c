@@ -1,11 +1,31 @@
 #include "btree.h"
 #include "kernel.h"
 
+// 에포크 기반 회수 상태
+// 읽기 구간에 있는 hart는 진입 시점의 에포크를 hart_epoch에 기록함 (0 = 비활성)
+// 교체된 옛 루트는 retire 리스트에 들어가고, 그보다 오래된 에포크의 reader가
+// 모두 빠져나간 뒤에만 해제됨
+// 읽기 구간은 hart 단위이므로 구간 동안 인터럽트를 막고, 그 안에서는 yield할 수 없음
+// (다른 태스크가 같은 hart에서 구간을 닫으면 첫 reader가 쥔 노드가 해제될 수 있음)
+struct btree_retired {
+    struct btree_node *node;
+    uint32_t epoch;
+    struct btree_retired *next;
+};
+
+static uint32_t global_epoch = 1;
+static uint32_t hart_epoch[MAX_HARTS];
+static int hart_read_depth[MAX_HARTS];
+static uint32_t hart_read_irq[MAX_HARTS];       // Interrupt state to restore when the section closes
+static struct btree_retired *retired_list = NULL;
+static struct spinlock reclaim_lock;
+
 // B-트리 초기화
 void btree_init(struct btree *tree) {
     tree->root = NULL;
     tree->height = 0;
     tree->num_nodes = 0;
+    spin_init(&tree->writer_lock);
 }
 
 // 새 B-트리 노드 생성
@@ -17,7 +37,7 @@ struct btree_node *btree_node_create(int is_leaf) {
 
     node->num_keys = 0;
     node->is_leaf = is_leaf;
-    node->parent = NULL;
+    node->refcount = 1;
 
     for (int i = 0; i < BTREE_MAX_KEYS; i++) {
         node->keys[i] = 0;
@@ -31,13 +51,154 @@ struct btree_node *btree_node_create(int is_leaf) {
     return node;
 }
 
-// B-트리에서 키 검색
-void *btree_search(struct btree *tree, uint32_t key) {
-    if (tree->root == NULL) {
+// 노드 참조 획득
+static void node_get(struct btree_node *node) {
+    __atomic_add_fetch(&node->refcount, 1, __ATOMIC_RELAXED);
+}
+
+// 노드 참조 해제 (마지막 참조면 노드를 해제하고 자식 참조도 놓음)
+static void node_put(struct btree_node *node) {
+    if (node == NULL) {
+        return;
+    }
+
+    if (__atomic_sub_fetch(&node->refcount, 1, __ATOMIC_ACQ_REL) != 0) {
+        return;
+    }
+
+    if (!node->is_leaf) {
+        for (int i = 0; i <= node->num_keys; i++) {
+            node_put(node->children[i]);
+        }
+    }
+
+    kfree(node);
+}
+
+// 노드 복사 (복사본은 원본의 자식들을 공유함)
+static struct btree_node *node_clone(struct btree_node *node) {
+    struct btree_node *copy = (struct btree_node *)kmalloc(sizeof(struct btree_node));
+    if (!copy) {
         return NULL;
     }
 
-    struct btree_node *node = tree->root;
+    *copy = *node;
+    copy->refcount = 1;
+
+    if (!copy->is_leaf) {
+        for (int i = 0; i <= copy->num_keys; i++) {
+            node_get(copy->children[i]);
+        }
+    }
+
+    return copy;
+}
+
+// 락 없는 읽기 구간 진입
+void btree_read_begin(void) {
+    uint32_t irq = interrupts_disable();
+    uint32_t hart = cpu_id() % MAX_HARTS;
+
+    if (hart_read_depth[hart]++ == 0) {
+        hart_read_irq[hart] = irq;
+        uint32_t epoch = __atomic_load_n(&global_epoch, __ATOMIC_SEQ_CST);
+        __atomic_store_n(&hart_epoch[hart], epoch, __ATOMIC_SEQ_CST);
+    }
+}
+
+// 락 없는 읽기 구간 종료
+void btree_read_end(void) {
+    uint32_t hart = cpu_id() % MAX_HARTS;
+
+    if (--hart_read_depth[hart] == 0) {
+        __atomic_store_n(&hart_epoch[hart], 0, __ATOMIC_RELEASE);
+        interrupts_restore(hart_read_irq[hart]);
+    }
+}
+
+// 이 hart가 읽기 구간 안에 있는지 (schedule이 확인)
+int btree_in_read_section(void) {
+    return hart_read_depth[cpu_id() % MAX_HARTS] > 0;
+}
+
+// 유예 기간이 지난 옛 노드 회수
+void btree_reclaim(void) {
+    spin_lock(&reclaim_lock);
+
+    // Oldest epoch still observed by an active reader
+    uint32_t oldest = 0;
+    for (int i = 0; i < MAX_HARTS; i++) {
+        uint32_t epoch = __atomic_load_n(&hart_epoch[i], __ATOMIC_SEQ_CST);
+        if (epoch != 0 && (oldest == 0 || epoch < oldest)) {
+            oldest = epoch;
+        }
+    }
+
+    struct btree_retired **link = &retired_list;
+    while (*link) {
+        struct btree_retired *entry = *link;
+
+        // Readers that entered after the retire epoch loaded the new root
+        if (oldest == 0 || entry->epoch < oldest) {
+            *link = entry->next;
+            node_put(entry->node);
+            kfree(entry);
+        } else {
+            link = &entry->next;
+        }
+    }
+
+    spin_unlock(&reclaim_lock);
+}
+
+// 게시가 끝난 옛 루트의 참조를 유예 후 해제하도록 등록
+static void btree_retire(struct btree_node *node) {
+    if (node == NULL) {
+        return;
+    }
+
+    struct btree_retired *entry = (struct btree_retired *)kmalloc(sizeof(struct btree_retired));
+
+    spin_lock(&reclaim_lock);
+    if (entry) {
+        entry->node = node;
+        entry->epoch = __atomic_fetch_add(&global_epoch, 1, __ATOMIC_SEQ_CST);
+        entry->next = retired_list;
+        retired_list = entry;
+    }
+    spin_unlock(&reclaim_lock);
+
+    if (!entry) {
+        // Out of memory. If this hart is reading (a traverse callback that modifies the tree),
+        // the node may still be in use further up this stack and waiting would never end:
+        // leak it. Otherwise wait for the other harts' readers to drain, then drop it directly
+        if (btree_in_read_section()) {
+            printf("Warning: B-Tree node leaked (out of memory inside a read section)\n");
+            return;
+        }
+        __atomic_fetch_add(&global_epoch, 1, __ATOMIC_SEQ_CST);
+        for (int i = 0; i < MAX_HARTS; i++) {
+            while (__atomic_load_n(&hart_epoch[i], __ATOMIC_SEQ_CST) != 0) {}
+        }
+        node_put(node);
+        return;
+    }
+
+    btree_reclaim();
+}
+
+// 새 루트 게시 (노드 내용이 모두 보인 뒤에 루트가 보이도록 release)
+static void btree_publish(struct btree *tree, struct btree_node *root) {
+    __atomic_store_n(&tree->root, root, __ATOMIC_RELEASE);
+}
+
+// B-트리에서 키 검색 (락 없음)
+void *btree_search(struct btree *tree, uint32_t key) {
+    void *value = NULL;
+
+    btree_read_begin();
+
+    struct btree_node *node = __atomic_load_n(&tree->root, __ATOMIC_ACQUIRE);
 
     while (node != NULL) {
         int i = 0;
@@ -49,259 +210,514 @@ void *btree_search(struct btree *tree, uint32_t key) {
 
         // 키를 찾았는지 확인
         if (i < node->num_keys && key == node->keys[i]) {
-            return node->values[i];
+            value = node->values[i];
+            break;
         }
 
         // 리프 노드면 키가 존재하지 않음
         if (node->is_leaf) {
-            return NULL;
+            break;
         }
 
         // 적절한 자식으로 이동
         node = node->children[i];
     }
 
-    return NULL;
+    btree_read_end();
+    return value;
 }
 
-// 가득 찬 자식 노드 분할
-void btree_split_child(struct btree_node *parent, int index, struct btree_node *child) {
-    struct btree_node *new_node = btree_node_create(child->is_leaf);
-    if (!new_node) {
-        return;
+// 가장 가까운 키 검색 (upper == 0: key 이하 최대, upper == 1: key 이상 최소)
+static void *search_nearest(struct btree *tree, uint32_t key, int upper, uint32_t *found_key) {
+    void *value = NULL;
+
+    btree_read_begin();
+
+    struct btree_node *node = __atomic_load_n(&tree->root, __ATOMIC_ACQUIRE);
+
+    while (node != NULL) {
+        int i = 0;
+
+        if (upper) {
+            // First key >= search key
+            while (i < node->num_keys && node->keys[i] < key) {
+                i++;
+            }
+            if (i < node->num_keys) {
+                value = node->values[i];
+                *found_key = node->keys[i];
+                if (node->keys[i] == key) {
+                    break;
+                }
+            }
+        } else {
+            // Keys <= search key; the last of them is the best so far
+            while (i < node->num_keys && node->keys[i] <= key) {
+                i++;
+            }
+            if (i > 0) {
+                value = node->values[i - 1];
+                *found_key = node->keys[i - 1];
+                if (node->keys[i - 1] == key) {
+                    break;
+                }
+            }
+        }
+
+        if (node->is_leaf) {
+            break;
+        }
+
+        // Closer candidates, if any, live in the child between them
+        node = node->children[i];
     }
 
-    new_node->num_keys = BTREE_MIN_KEYS;
+    btree_read_end();
+    return value;
+}
+
+// key 이하의 가장 큰 키 검색
+void *btree_search_floor(struct btree *tree, uint32_t key, uint32_t *found_key) {
+    return search_nearest(tree, key, 0, found_key);
+}
+
+// key 이상의 가장 작은 키 검색
+void *btree_search_ceil(struct btree *tree, uint32_t key, uint32_t *found_key) {
+    return search_nearest(tree, key, 1, found_key);
+}
+
+// Helper function to find key index in node
+static int find_key_index(struct btree_node *node, uint32_t key) {
+    int i = 0;
+    while (i < node->num_keys && node->keys[i] < key) {
+        i++;
+    }
+    return i;
+}
 
-    // 키와 값의 후반부를 새 노드로 복사
-    for (int i = 0; i < BTREE_MIN_KEYS; i++) {
-        new_node->keys[i] = child->keys[i + BTREE_MIN_KEYS + 1];
-        new_node->values[i] = child->values[i + BTREE_MIN_KEYS + 1];
+// 복사된 노드의 idx 위치에 키와 오른쪽 자식 삽입
+// 노드가 넘치면 분할하고 새 오른쪽 노드와 위로 올릴 키를 돌려줌
+static int node_insert_entry(struct btree_node *node, int idx, uint32_t key, void *value,
+                             struct btree_node *right, struct btree_node **split_right,
+                             uint32_t *up_key, void **up_value) {
+    *split_right = NULL;
+
+    if (node->num_keys < BTREE_MAX_KEYS) {
+        for (int i = node->num_keys; i > idx; i--) {
+            node->keys[i] = node->keys[i - 1];
+            node->values[i] = node->values[i - 1];
+            node->children[i + 1] = node->children[i];
+        }
+        node->keys[idx] = key;
+        node->values[idx] = value;
+        node->children[idx + 1] = right;
+        node->num_keys++;
+        return 0;
     }
 
-    // 리프가 아니면 자식 포인터 복사
-    if (!child->is_leaf) {
-        for (int i = 0; i < BTREE_MIN_KEYS + 1; i++) {
-            new_node->children[i] = child->children[i + BTREE_MIN_KEYS + 1];
-            if (new_node->children[i]) {
-                new_node->children[i]->parent = new_node;
-            }
+    // Overflow: lay out all BTREE_ORDER keys, then split around the middle
+    uint32_t keys[BTREE_ORDER];
+    void *values[BTREE_ORDER];
+    struct btree_node *children[BTREE_ORDER + 1];
+
+    children[0] = node->children[0];
+    for (int i = 0, j = 0; i < BTREE_ORDER; i++) {
+        if (i == idx) {
+            keys[i] = key;
+            values[i] = value;
+            children[i + 1] = right;
+        } else {
+            keys[i] = node->keys[j];
+            values[i] = node->values[j];
+            children[i + 1] = node->children[j + 1];
+            j++;
         }
     }
 
-    child->num_keys = BTREE_MIN_KEYS;
+    struct btree_node *new_node = btree_node_create(node->is_leaf);
+    if (!new_node) {
+        return -1;
+    }
+
+    int mid = BTREE_ORDER / 2;
 
-    // Shift parent's children to make room for new node
-    for (int i = parent->num_keys; i > index; i--) {
-        parent->children[i + 1] = parent->children[i];
+    node->num_keys = mid;
+    for (int i = 0; i < BTREE_MAX_KEYS; i++) {
+        node->keys[i] = i < mid ? keys[i] : 0;
+        node->values[i] = i < mid ? values[i] : NULL;
+    }
+    for (int i = 0; i < BTREE_ORDER; i++) {
+        node->children[i] = i <= mid ? children[i] : NULL;
     }
-    parent->children[index + 1] = new_node;
-    new_node->parent = parent;
 
-    // Move middle key up to parent
-    for (int i = parent->num_keys - 1; i >= index; i--) {
-        parent->keys[i + 1] = parent->keys[i];
-        parent->values[i + 1] = parent->values[i];
+    new_node->num_keys = BTREE_ORDER - mid - 1;
+    for (int i = 0; i < new_node->num_keys; i++) {
+        new_node->keys[i] = keys[mid + 1 + i];
+        new_node->values[i] = values[mid + 1 + i];
+    }
+    for (int i = 0; i <= new_node->num_keys; i++) {
+        new_node->children[i] = children[mid + 1 + i];
     }
-    parent->keys[index] = child->keys[BTREE_MIN_KEYS];
-    parent->values[index] = child->values[BTREE_MIN_KEYS];
-    parent->num_keys++;
+
+    *split_right = new_node;
+    *up_key = keys[mid];
+    *up_value = values[mid];
+    return 0;
 }
 
-// 가득 차지 않은 노드에 키-값 쌍 삽입
-void btree_insert_non_full(struct btree_node *node, uint32_t key, void *value) {
-    int i = node->num_keys - 1;
+// 경로 복사 삽입: node의 수정된 복사본을 반환 (원본은 그대로 유지)
+static struct btree_node *cow_insert(struct btree_node *node, uint32_t key, void *value,
+                                     struct btree_node **split_right,
+                                     uint32_t *up_key, void **up_value) {
+    struct btree_node *copy = node_clone(node);
+    if (!copy) {
+        return NULL;
+    }
 
-    if (node->is_leaf) {
-        // Insert into leaf node
-        while (i >= 0 && key < node->keys[i]) {
-            node->keys[i + 1] = node->keys[i];
-            node->values[i + 1] = node->values[i];
-            i--;
-        }
+    int i = find_key_index(copy, key);
 
-        node->keys[i + 1] = key;
-        node->values[i + 1] = value;
-        node->num_keys++;
-    } else {
-        // Find child to insert into
-        while (i >= 0 && key < node->keys[i]) {
-            i--;
+    if (copy->is_leaf) {
+        if (node_insert_entry(copy, i, key, value, NULL, split_right, up_key, up_value) < 0) {
+            node_put(copy);
+            return NULL;
         }
-        i++;
+        return copy;
+    }
 
-        // Check if child is full
-        if (node->children[i]->num_keys == BTREE_MAX_KEYS) {
-            btree_split_child(node, i, node->children[i]);
+    struct btree_node *child_right;
+    uint32_t child_key;
+    void *child_value;
+    struct btree_node *new_child = cow_insert(copy->children[i], key, value,
+                                              &child_right, &child_key, &child_value);
+    if (!new_child) {
+        node_put(copy);
+        return NULL;
+    }
 
-            if (key > node->keys[i]) {
-                i++;
-            }
-        }
+    // The copy now points at the new child instead of the shared original
+    node_put(copy->children[i]);
+    copy->children[i] = new_child;
 
-        btree_insert_non_full(node->children[i], key, value);
+    *split_right = NULL;
+    if (child_right) {
+        if (node_insert_entry(copy, i, child_key, child_value, child_right,
+                              split_right, up_key, up_value) < 0) {
+            node_put(child_right);
+            node_put(copy);
+            return NULL;
+        }
     }
+
+    return copy;
 }
 
 // B-트리에 키-값 쌍 삽입
 int btree_insert(struct btree *tree, uint32_t key, void *value) {
+    spin_lock(&tree->writer_lock);
+
     // Check if key already exists
     if (btree_search(tree, key) != NULL) {
+        spin_unlock(&tree->writer_lock);
         return -1; // Key already exists
     }
 
-    // If tree is empty, create root
-    if (tree->root == NULL) {
-        tree->root = btree_node_create(1);
-        if (!tree->root) {
+    struct btree_node *old_root = tree->root;
+    struct btree_node *new_root;
+
+    if (old_root == NULL) {
+        // If tree is empty, create root
+        new_root = btree_node_create(1);
+        if (!new_root) {
+            spin_unlock(&tree->writer_lock);
             return -1;
         }
-        tree->root->keys[0] = key;
-        tree->root->values[0] = value;
-        tree->root->num_keys = 1;
-        tree->num_nodes = 1;
+        new_root->keys[0] = key;
+        new_root->values[0] = value;
+        new_root->num_keys = 1;
         tree->height = 1;
-        return 0;
-    }
+    } else {
+        struct btree_node *right;
+        uint32_t up_key;
+        void *up_value;
 
-    // If root is full, split it
-    if (tree->root->num_keys == BTREE_MAX_KEYS) {
-        struct btree_node *new_root = btree_node_create(0);
+        new_root = cow_insert(old_root, key, value, &right, &up_key, &up_value);
         if (!new_root) {
+            spin_unlock(&tree->writer_lock);
             return -1;
         }
 
-        new_root->children[0] = tree->root;
-        tree->root->parent = new_root;
-        btree_split_child(new_root, 0, tree->root);
-        tree->root = new_root;
-        tree->height++;
+        // If root split, grow the tree by one level
+        if (right) {
+            struct btree_node *top = btree_node_create(0);
+            if (!top) {
+                node_put(right);
+                node_put(new_root);
+                spin_unlock(&tree->writer_lock);
+                return -1;
+            }
+            top->keys[0] = up_key;
+            top->values[0] = up_value;
+            top->children[0] = new_root;
+            top->children[1] = right;
+            top->num_keys = 1;
+            new_root = top;
+            tree->height++;
+        }
     }
 
-    btree_insert_non_full(tree->root, key, value);
     tree->num_nodes++;
+    btree_publish(tree, new_root);
+    spin_unlock(&tree->writer_lock);
+
+    btree_retire(old_root);
     return 0;
 }
 
-// Helper function to find key index in node
-static int find_key_index(struct btree_node *node, uint32_t key) {
-    int i = 0;
-    while (i < node->num_keys && node->keys[i] < key) {
-        i++;
-    }
-    return i;
+// 노드에서 idx번째 키와 그 오른쪽 자식 제거
+static void node_remove_entry(struct btree_node *node, int idx) {
+    for (int i = idx; i < node->num_keys - 1; i++) {
+        node->keys[i] = node->keys[i + 1];
+        node->values[i] = node->values[i + 1];
+        node->children[i + 1] = node->children[i + 2];
+    }
+    node->num_keys--;
+    node->keys[node->num_keys] = 0;
+    node->values[node->num_keys] = NULL;
+    node->children[node->num_keys + 1] = NULL;
 }
 
-// Get predecessor key from subtree
-static void get_predecessor(struct btree_node *node, int idx, uint32_t *key, void **value) {
-    struct btree_node *curr = node->children[idx];
-    while (!curr->is_leaf) {
-        curr = curr->children[curr->num_keys];
+// Merge children[index] and children[index + 1] around the separator key
+static int merge_children(struct btree_node *parent, int index) {
+    struct btree_node *left = parent->children[index];
+    struct btree_node *right = parent->children[index + 1];
+
+    struct btree_node *merged = btree_node_create(left->is_leaf);
+    if (!merged) {
+        return -1;
     }
-    *key = curr->keys[curr->num_keys - 1];
-    *value = curr->values[curr->num_keys - 1];
-}
 
-// Get successor key from subtree
-static void get_successor(struct btree_node *node, int idx, uint32_t *key, void **value) {
-    struct btree_node *curr = node->children[idx + 1];
-    while (!curr->is_leaf) {
-        curr = curr->children[0];
+    int n = 0;
+    for (int i = 0; i < left->num_keys; i++, n++) {
+        merged->keys[n] = left->keys[i];
+        merged->values[n] = left->values[i];
+        merged->children[n] = left->children[i];
     }
-    *key = curr->keys[0];
-    *value = curr->values[0];
+    merged->children[n] = left->children[left->num_keys];
+    merged->keys[n] = parent->keys[index];
+    merged->values[n] = parent->values[index];
+    n++;
+    for (int i = 0; i < right->num_keys; i++, n++) {
+        merged->keys[n] = right->keys[i];
+        merged->values[n] = right->values[i];
+        merged->children[n] = right->children[i];
+    }
+    merged->children[n] = right->children[right->num_keys];
+    merged->num_keys = n;
+
+    if (!merged->is_leaf) {
+        for (int i = 0; i <= n; i++) {
+            node_get(merged->children[i]);
+        }
+    }
+
+    node_put(left);
+    node_put(right);
+    parent->children[index] = merged;
+    node_remove_entry(parent, index);
+    return 0;
 }
 
-// Merge child with sibling
-void btree_merge_children(struct btree_node *parent, int index) {
-    struct btree_node *child = parent->children[index];
-    struct btree_node *sibling = parent->children[index + 1];
+// 복사된 부모에서 children[i]의 키 부족을 형제에게서 빌리거나 병합해 해결
+static int fix_underflow(struct btree_node *node, int i) {
+    struct btree_node *child = node->children[i];
 
-    // Pull key from parent and merge with right sibling
-    child->keys[BTREE_MIN_KEYS] = parent->keys[index];
-    child->values[BTREE_MIN_KEYS] = parent->values[index];
+    if (child->num_keys >= BTREE_MIN_KEYS) {
+        return 0;
+    }
+
+    // Borrow from the left sibling
+    if (i > 0 && node->children[i - 1]->num_keys > BTREE_MIN_KEYS) {
+        struct btree_node *left = node_clone(node->children[i - 1]);
+        if (!left) {
+            return -1;
+        }
+        node_put(node->children[i - 1]);
+        node->children[i - 1] = left;
 
-    // Copy keys from sibling
-    for (int i = 0; i < sibling->num_keys; i++) {
-        child->keys[i + BTREE_MIN_KEYS + 1] = sibling->keys[i];
-        child->values[i + BTREE_MIN_KEYS + 1] = sibling->values[i];
+        for (int j = child->num_keys; j > 0; j--) {
+            child->keys[j] = child->keys[j - 1];
+            child->values[j] = child->values[j - 1];
+        }
+        for (int j = child->num_keys + 1; j > 0; j--) {
+            child->children[j] = child->children[j - 1];
+        }
+        child->keys[0] = node->keys[i - 1];
+        child->values[0] = node->values[i - 1];
+        child->children[0] = left->children[left->num_keys];
+        child->num_keys++;
+
+        node->keys[i - 1] = left->keys[left->num_keys - 1];
+        node->values[i - 1] = left->values[left->num_keys - 1];
+        left->children[left->num_keys] = NULL;
+        left->num_keys--;
+        return 0;
     }
 
-    // Copy child pointers if not leaf
-    if (!child->is_leaf) {
-        for (int i = 0; i <= sibling->num_keys; i++) {
-            child->children[i + BTREE_MIN_KEYS + 1] = sibling->children[i];
-            if (child->children[i + BTREE_MIN_KEYS + 1]) {
-                child->children[i + BTREE_MIN_KEYS + 1]->parent = child;
-            }
+    // Borrow from the right sibling
+    if (i < node->num_keys && node->children[i + 1]->num_keys > BTREE_MIN_KEYS) {
+        struct btree_node *right = node_clone(node->children[i + 1]);
+        if (!right) {
+            return -1;
+        }
+        node_put(node->children[i + 1]);
+        node->children[i + 1] = right;
+
+        child->keys[child->num_keys] = node->keys[i];
+        child->values[child->num_keys] = node->values[i];
+        child->children[child->num_keys + 1] = right->children[0];
+        child->num_keys++;
+
+        node->keys[i] = right->keys[0];
+        node->values[i] = right->values[0];
+        for (int j = 0; j < right->num_keys - 1; j++) {
+            right->keys[j] = right->keys[j + 1];
+            right->values[j] = right->values[j + 1];
         }
+        for (int j = 0; j < right->num_keys; j++) {
+            right->children[j] = right->children[j + 1];
+        }
+        right->children[right->num_keys] = NULL;
+        right->num_keys--;
+        return 0;
     }
 
-    child->num_keys += sibling->num_keys + 1;
+    // Merge with a sibling
+    return merge_children(node, i > 0 ? i - 1 : i);
+}
+
+// 서브트리의 최대 키를 떼어낸 복사본 반환
+static struct btree_node *cow_delete_max(struct btree_node *node, uint32_t *key, void **value) {
+    struct btree_node *copy = node_clone(node);
+    if (!copy) {
+        return NULL;
+    }
 
-    // Move keys in parent
-    for (int i = index + 1; i < parent->num_keys; i++) {
-        parent->keys[i - 1] = parent->keys[i];
-        parent->values[i - 1] = parent->values[i];
+    if (copy->is_leaf) {
+        *key = copy->keys[copy->num_keys - 1];
+        *value = copy->values[copy->num_keys - 1];
+        node_remove_entry(copy, copy->num_keys - 1);
+        return copy;
     }
 
-    // Move child pointers in parent
-    for (int i = index + 2; i <= parent->num_keys; i++) {
-        parent->children[i - 1] = parent->children[i];
+    int last = copy->num_keys;
+    struct btree_node *new_child = cow_delete_max(copy->children[last], key, value);
+    if (!new_child) {
+        node_put(copy);
+        return NULL;
     }
+    node_put(copy->children[last]);
+    copy->children[last] = new_child;
 
-    parent->num_keys--;
-    kfree(sibling);
+    if (fix_underflow(copy, last) < 0) {
+        node_put(copy);
+        return NULL;
+    }
+    return copy;
 }
 
-// Delete helper for non-leaf nodes
-static void delete_internal_node(struct btree *tree, struct btree_node *node, uint32_t key);
+// 경로 복사 삭제: 키가 서브트리에 있어야 함
+static struct btree_node *cow_delete(struct btree_node *node, uint32_t key) {
+    struct btree_node *copy = node_clone(node);
+    if (!copy) {
+        return NULL;
+    }
+
+    int i = find_key_index(copy, key);
 
-// Delete helper for leaf nodes
-static void delete_leaf_node(struct btree_node *node, uint32_t key) {
-    int i = find_key_index(node, key);
+    if (i < copy->num_keys && copy->keys[i] == key) {
+        if (copy->is_leaf) {
+            node_remove_entry(copy, i);
+            return copy;
+        }
 
-    if (i < node->num_keys && node->keys[i] == key) {
-        // Shift keys and values
-        for (int j = i; j < node->num_keys - 1; j++) {
-            node->keys[j] = node->keys[j + 1];
-            node->values[j] = node->values[j + 1];
+        // For internal nodes, replace with predecessor
+        uint32_t pred_key;
+        void *pred_value;
+        struct btree_node *new_child = cow_delete_max(copy->children[i], &pred_key, &pred_value);
+        if (!new_child) {
+            node_put(copy);
+            return NULL;
+        }
+        node_put(copy->children[i]);
+        copy->children[i] = new_child;
+        copy->keys[i] = pred_key;
+        copy->values[i] = pred_value;
+    } else {
+        struct btree_node *new_child = cow_delete(copy->children[i], key);
+        if (!new_child) {
+            node_put(copy);
+            return NULL;
         }
-        node->num_keys--;
+        node_put(copy->children[i]);
+        copy->children[i] = new_child;
     }
+
+    if (fix_underflow(copy, i) < 0) {
+        node_put(copy);
+        return NULL;
+    }
+    return copy;
 }
 
 // B-트리에서 키 삭제
 int btree_delete(struct btree *tree, uint32_t key) {
-    if (tree->root == NULL) {
+    spin_lock(&tree->writer_lock);
+
+    struct btree_node *old_root = tree->root;
+    if (old_root == NULL || btree_search(tree, key) == NULL) {
+        spin_unlock(&tree->writer_lock);
+        return -1; // Key not found
+    }
+
+    struct btree_node *new_root = cow_delete(old_root, key);
+    if (!new_root) {
+        spin_unlock(&tree->writer_lock);
         return -1;
     }
 
-    // Simple implementation: find and remove from leaf
-    struct btree_node *node = tree->root;
+    // Shrink the tree when the root runs out of keys
+    if (new_root->num_keys == 0) {
+        struct btree_node *child = new_root->is_leaf ? NULL : new_root->children[0];
+        if (child) {
+            node_get(child);
+        }
+        node_put(new_root);
+        new_root = child;
+        tree->height--;
+    }
 
-    while (node != NULL) {
-        int i = find_key_index(node, key);
+    tree->num_nodes--;
+    btree_publish(tree, new_root);
+    spin_unlock(&tree->writer_lock);
 
-        if (i < node->num_keys && node->keys[i] == key) {
-            if (node->is_leaf) {
-                delete_leaf_node(node, key);
-                tree->num_nodes--;
-                return 0;
-            }
-            // For internal nodes, replace with predecessor/successor
-            // Simplified: just mark as not implemented for now
-            return -1;
-        }
+    btree_retire(old_root);
+    return 0;
+}
 
-        if (node->is_leaf) {
-            return -1; // Key not found
-        }
+// 현재 루트를 공유하는 시점 스냅샷 생성
+int btree_snapshot(struct btree *tree, struct btree *snap) {
+    btree_init(snap);
 
-        node = node->children[i];
+    spin_lock(&tree->writer_lock);
+    if (tree->root) {
+        node_get(tree->root);
     }
+    snap->root = tree->root;
+    snap->height = tree->height;
+    snap->num_nodes = tree->num_nodes;
+    spin_unlock(&tree->writer_lock);
 
-    return -1;
+    return 0;
 }
 
 // B-트리 중위 순회
@@ -324,29 +740,21 @@ static void traverse_recursive(struct btree_node *node, void (*callback)(uint32_
 }
 
 void btree_traverse(struct btree *tree, void (*callback)(uint32_t key, void *value)) {
-    traverse_recursive(tree->root, callback);
-}
-
-// B-트리 파괴
-static void destroy_recursive(struct btree_node *node) {
-    if (node == NULL) {
-        return;
-    }
-
-    if (!node->is_leaf) {
-        for (int i = 0; i <= node->num_keys; i++) {
-            destroy_recursive(node->children[i]);
-        }
-    }
-
-    kfree(node);
+    btree_read_begin();
+    traverse_recursive(__atomic_load_n(&tree->root, __ATOMIC_ACQUIRE), callback);
+    btree_read_end();
 }
 
+// B-트리 파괴 (진행 중인 reader가 끝난 뒤 노드 해제)
 void btree_destroy(struct btree *tree) {
-    destroy_recursive(tree->root);
-    tree->root = NULL;
+    spin_lock(&tree->writer_lock);
+    struct btree_node *old_root = tree->root;
+    btree_publish(tree, NULL);
     tree->height = 0;
     tree->num_nodes = 0;
+    spin_unlock(&tree->writer_lock);
+
+    btree_retire(old_root);
 }
 
 // B-트리 구조 출력
@@ -370,5 +778,7 @@ static void print_recursive(struct btree_node *node, int level) {
 
 void btree_print(struct btree *tree) {
     printf("B-Tree (height=%d, nodes=%d):\n", tree->height, tree->num_nodes);
-    print_recursive(tree->root, 0);
+    btree_read_begin();
+    print_recursive(__atomic_load_n(&tree->root, __ATOMIC_ACQUIRE), 0);
+    btree_read_end();
 }
@@ -11,33 +11,47 @@ struct btree_node;
 struct btree;
 
 // B-트리 노드 구조체
+// 노드는 copy-on-write로 갱신되며 여러 버전(루트/스냅샷)이 공유할 수 있음
 struct btree_node {
     int num_keys;                                // 현재 노드의 키 개수
     uint32_t keys[BTREE_MAX_KEYS];              // 키 배열 (i-node 번호)
     void *values[BTREE_MAX_KEYS];               // 값 배열 (데이터 포인터)
     struct btree_node *children[BTREE_ORDER];    // 자식 포인터 배열
-    struct btree_node *parent;                   // 부모 노드 포인터
+    uint32_t refcount;                           // 이 노드를 가리키는 부모/루트 수
     int is_leaf;                                 // 리프 노드면 1, 내부 노드면 0
 };
 
 // B-트리 구조체
+// 읽기는 락 없이 root를 로드해 순회하고, 쓰기는 writer_lock 아래에서
+// 경로를 복사한 뒤 새 root를 원자적으로 게시함
 struct btree {
-    struct btree_node *root;                     // 루트 노드
+    struct btree_node *root;                     // 루트 노드 (원자적으로 게시)
     int height;                                  // 트리 높이
     int num_nodes;                               // 총 노드 개수
+    struct spinlock writer_lock;                 // 쓰기 직렬화
 };
 
 // B-트리 연산
 void btree_init(struct btree *tree);
 struct btree_node *btree_node_create(int is_leaf);
 void *btree_search(struct btree *tree, uint32_t key);
+void *btree_search_floor(struct btree *tree, uint32_t key, uint32_t *found_key);
+void *btree_search_ceil(struct btree *tree, uint32_t key, uint32_t *found_key);
 int btree_insert(struct btree *tree, uint32_t key, void *value);
 int btree_delete(struct btree *tree, uint32_t key);
 void btree_traverse(struct btree *tree, void (*callback)(uint32_t key, void *value));
 void btree_destroy(struct btree *tree);
 
+// 현재 루트를 공유하는 시점 스냅샷 생성 (btree_destroy로 해제)
+int btree_snapshot(struct btree *tree, struct btree *snap);
+
+// 락 없는 읽기 구간 (에포크 기반 회수): 구간 동안 인터럽트가 막히며, 안에서 yield하면 안 됨
+void btree_read_begin(void);
+void btree_read_end(void);
+int btree_in_read_section(void);
+
+// 유예 기간이 지난 옛 노드 회수
+void btree_reclaim(void);
+
 // 헬퍼 함수들
-void btree_split_child(struct btree_node *parent, int index, struct btree_node *child);
-void btree_insert_non_full(struct btree_node *node, uint32_t key, void *value);
-void btree_merge_children(struct btree_node *parent, int index);
 void btree_print(struct btree *tree);
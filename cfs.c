@@ -1,5 +1,7 @@
 #include "cfs.h"
 #include "common.h"
+#include "log.h"
+#include "trace.h"
 
 /* 전역 CFS 실행 큐 */
 struct cfs_rq cfs_runqueue;
@@ -87,7 +89,7 @@ void cfs_init(void) {
         RB_CLEAR_NODE(&cfs_processes[i].se.run_node);
     }
 
-    printf("CFS scheduler initialized\n");
+    LOG_INFO("CFS scheduler initialized\n");
 }
 
 /* RB 트리에 태스크 삽입 */
@@ -144,8 +146,9 @@ void cfs_enqueue_task(struct cfs_process *proc) {
 
     proc->base.state = PROC_READY;
 
-    printf("CFS: Enqueued process %d (vruntime=%llu, weight=%u)\n",
-           proc->base.pid, se->vruntime, se->weight);
+    trace(TRACE_CFS_ENQUEUE, proc->base.pid, (uint32_t)se->vruntime, se->weight);
+    LOG_DEBUG("CFS: Enqueued process %d (vruntime=%llu, weight=%u)\n",
+              proc->base.pid, se->vruntime, se->weight);
 }
 
 /* RB 트리에서 태스크 제거 */
@@ -172,7 +175,8 @@ void cfs_dequeue_task(struct cfs_process *proc) {
 
     update_min_vruntime(cfs_rq);
 
-    printf("CFS: Dequeued process %d\n", proc->base.pid);
+    trace(TRACE_CFS_DEQUEUE, proc->base.pid, 0, 0);
+    LOG_DEBUG("CFS: Dequeued process %d\n", proc->base.pid);
 }
 
 /* 최소 vruntime을 가진 다음 태스크 선택 */
@@ -208,8 +212,9 @@ void cfs_update_curr(struct cfs_process *curr) {
 
     update_min_vruntime(&cfs_runqueue);
 
-    printf("CFS: Updated process %d vruntime=%llu (delta=%llu)\n",
-           curr->base.pid, se->vruntime, delta_exec);
+    trace(TRACE_CFS_UPDATE, curr->base.pid, (uint32_t)se->vruntime, (uint32_t)delta_exec);
+    LOG_DEBUG("CFS: Updated process %d vruntime=%llu (delta=%llu)\n",
+              curr->base.pid, se->vruntime, delta_exec);
 }
 
 /* 현재 태스크가 선점되어야 하는지 확인 */
@@ -234,8 +239,9 @@ void cfs_scheduler_tick(void) {
             next->base.state = PROC_RUNNING;
             next->se.exec_start = get_time_ns();
             cfs_current = next;
-            printf("CFS: Scheduled process %d (vruntime=%llu)\n",
-                   next->base.pid, next->se.vruntime);
+            trace(TRACE_CFS_PICK, next->base.pid, (uint32_t)next->se.vruntime, 0);
+            LOG_DEBUG("CFS: Scheduled process %d (vruntime=%llu)\n",
+                      next->base.pid, next->se.vruntime);
         }
         return;
     }
@@ -247,8 +253,9 @@ void cfs_scheduler_tick(void) {
     next = cfs_pick_next_task();
     if (next && cfs_check_preempt_curr(curr, next)) {
         /* 컨텍스트 스위치 필요 */
-        printf("CFS: Preempting process %d with process %d\n",
-               curr->base.pid, next->base.pid);
+        trace(TRACE_CFS_PREEMPT, curr->base.pid, next->base.pid, 0);
+        LOG_DEBUG("CFS: Preempting process %d with process %d\n",
+                  curr->base.pid, next->base.pid);
 
         /* 현재 태스크를 실행 큐에 다시 넣기 */
         curr->base.state = PROC_READY;
@@ -261,7 +268,7 @@ void cfs_scheduler_tick(void) {
         next->se.exec_start = get_time_ns();
         cfs_current = next;
 
-        /* 실제 시스템에서는 여기서 context_switch(curr, next) 수행 */
+        /* 실제 시스템에서는 여기서 switch_context로 curr에서 next로 전환 */
     }
 }
 
@@ -278,18 +285,13 @@ struct cfs_process *cfs_create_process(void (*entry_point)(void), int nice) {
     }
 
     if (!proc) {
-        printf("CFS: No free process slots\n");
+        LOG_ERROR("CFS: No free process slots\n");
         return NULL;
     }
 
     /* 기본 프로세스 초기화 */
     proc->base.state = PROC_READY;
-    proc->base.sp = (vaddr_t)&proc->base.stack[STACK_SIZE - sizeof(struct trap_frame)];
-    proc->base.trap_frame = (struct trap_frame *)proc->base.sp;
-
-    memset(proc->base.trap_frame, 0, sizeof(struct trap_frame));
-    proc->base.trap_frame->ra = (uint32_t)entry_point;
-    proc->base.trap_frame->sp = (uint32_t)&proc->base.stack[STACK_SIZE - 8];
+    process_init_context(&proc->base, entry_point);
 
     /* 스케줄링 엔티티 초기화 */
     proc->nice = nice;
@@ -300,8 +302,9 @@ struct cfs_process *cfs_create_process(void (*entry_point)(void), int nice) {
     proc->se.on_rq = 0;
     RB_CLEAR_NODE(&proc->se.run_node);
 
-    printf("CFS: Created process %d (nice=%d, weight=%u)\n",
-           proc->base.pid, nice, proc->se.weight);
+    trace(TRACE_PROC_CREATE, proc->base.pid, 0, 0);
+    LOG_DEBUG("CFS: Created process %d (nice=%d, weight=%u)\n",
+              proc->base.pid, nice, proc->se.weight);
 
     /* 실행 큐에 추가 */
     cfs_enqueue_task(proc);
@@ -1,190 +1,343 @@
 #include "common.h"
 #include "kernel.h"
+#include "uring.h"
+#include "console.h"
 
-void putchar(char ch);
+// 출력 대상: 콘솔(putchar) 또는 크기가 정해진 버퍼
+struct fmt_sink {
+    char *buf;                                   // NULL = console
+    size_t size;
+    size_t len;                                  // Characters produced so far (even past size)
+};
 
-void printf(const char *fmt, ...) {
-    va_list vargs;
-    va_start(vargs, fmt);
+static void sink_put(struct fmt_sink *sink, char ch) {
+    if (!sink->buf) {
+        putchar(ch);
+    } else if (sink->len + 1 < sink->size) {
+        sink->buf[sink->len] = ch;
+    }
+    sink->len++;
+}
+
+static void sink_repeat(struct fmt_sink *sink, char ch, int count) {
+    while (count-- > 0) {
+        sink_put(sink, ch);
+    }
+}
+
+// 64비트 값을 10으로 나누고 나머지 반환 (32비트 나눗셈만 사용, libgcc 없이)
+static uint32_t div10_u64(uint64_t *value) {
+    uint32_t hi = (uint32_t)(*value >> 32), lo = (uint32_t)*value;
+    uint32_t q_hi = hi / 10;
+    uint32_t mid = ((hi % 10) << 16) | (lo >> 16);
+    uint32_t q_mid = mid / 10;
+    uint32_t low = ((mid % 10) << 16) | (lo & 0xffff);
+    *value = ((uint64_t)q_hi << 32) | (q_mid << 16) | (low / 10);
+    return low % 10;
+}
+
+#define FMT_LEFT  (1 << 0)                       // '-'
+#define FMT_ZERO  (1 << 1)                       // '0'
+#define FMT_PLUS  (1 << 2)                       // '+'
+#define FMT_SPACE (1 << 3)                       // ' '
+#define FMT_ALT   (1 << 4)                       // '#'
 
+// 정수 하나: 숫자를 거꾸로 만든 뒤 부호/접두사, 정밀도(최소 자릿수), 폭에 맞춰 출력
+static void fmt_integer(struct fmt_sink *sink, uint64_t value, int negative, int base, int upper,
+                        int flags, int width, int precision) {
+    const char *digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    char buf[24];
+    int n = 0;
+    if (base == 10) {
+        while (value) {
+            buf[n++] = digits[div10_u64(&value)];
+        }
+    } else {
+        while (value) {
+            buf[n++] = digits[value & 0xf];
+            value >>= 4;
+        }
+    }
+
+    const char *prefix = negative ? "-" : (flags & FMT_PLUS) ? "+" : (flags & FMT_SPACE) ? " " : "";
+    if (base == 16 && (flags & FMT_ALT)) {
+        prefix = upper ? "0X" : "0x";
+    }
+    int prefix_len = prefix[0] ? (prefix[1] ? 2 : 1) : 0;
+    int zeros = precision > n ? precision - n : 0;
+    int pad = width - prefix_len - zeros - n;
+
+    if (!(flags & FMT_LEFT) && !(flags & FMT_ZERO)) {
+        sink_repeat(sink, ' ', pad);
+    }
+    for (int i = 0; i < prefix_len; i++) {
+        sink_put(sink, prefix[i]);
+    }
+    if (!(flags & FMT_LEFT) && (flags & FMT_ZERO)) {
+        sink_repeat(sink, '0', pad);
+    }
+    sink_repeat(sink, '0', zeros);
+    while (n > 0) {
+        sink_put(sink, buf[--n]);
+    }
+    if (flags & FMT_LEFT) {
+        sink_repeat(sink, ' ', pad);
+    }
+}
+
+// 서식 처리 엔진: printf와 vsnprintf가 함께 씀
+// 플래그 -0+ #, 폭과 정밀도(숫자 또는 *), 길이 hh h l ll z, 변환 d i u x X p s c %
+// %x/%p는 폭을 주지 않으면 예전처럼 8자리(%llx는 16자리)를 모두 출력
+static void vformat(struct fmt_sink *sink, const char *fmt, va_list vargs) {
     while (*fmt) {
-        if (*fmt == '%') {
-            fmt++; // '%' 건너뛰기
-            switch (*fmt) { // 다음 문자 읽기
-                case '\0': // 포맷 문자열 끝에 '%'
-                    putchar('%');
-                    goto end;
-                case '%': // '%' 출력
-                    putchar('%');
-                    break;
-                case 's': { // NULL로 끝나는 문자열 출력
-                    const char *s = va_arg(vargs, const char *);
-                    while (*s) {
-                        putchar(*s);
-                        s++;
-                    }
-                    break;
+        if (*fmt != '%') {
+            sink_put(sink, *fmt++);
+            continue;
+        }
+        fmt++; // '%' 건너뛰기
+
+        int flags = 0;
+        for (;; fmt++) {
+            if (*fmt == '-') flags |= FMT_LEFT;
+            else if (*fmt == '0') flags |= FMT_ZERO;
+            else if (*fmt == '+') flags |= FMT_PLUS;
+            else if (*fmt == ' ') flags |= FMT_SPACE;
+            else if (*fmt == '#') flags |= FMT_ALT;
+            else break;
+        }
+
+        int width = -1;
+        if (*fmt == '*') {
+            width = va_arg(vargs, int);
+            if (width < 0) {
+                flags |= FMT_LEFT;
+                width = -width;
+            }
+            fmt++;
+        } else if (*fmt >= '0' && *fmt <= '9') {
+            width = 0;
+            while (*fmt >= '0' && *fmt <= '9') {
+                width = width * 10 + (*fmt++ - '0');
+            }
+        }
+
+        int precision = -1;
+        if (*fmt == '.') {
+            fmt++;
+            precision = 0;
+            if (*fmt == '*') {
+                precision = va_arg(vargs, int);
+                fmt++;
+            } else {
+                while (*fmt >= '0' && *fmt <= '9') {
+                    precision = precision * 10 + (*fmt++ - '0');
                 }
-                case 'd': { // 10진수 정수 출력
-                    int value = va_arg(vargs, int);
-                    unsigned magnitude = value; // https://github.com/nuta/operating-system-in-1000-lines/issues/64
-                    if (value < 0) {
-                        putchar('-');
-                        magnitude = -magnitude;
-                    }
-
-                    unsigned divisor = 1;
-                    while (magnitude / divisor > 9)
-                        divisor *= 10;
-
-                    while (divisor > 0) {
-                        putchar('0' + magnitude / divisor);
-                        magnitude %= divisor;
-                        divisor /= 10;
-                    }
-
-                    break;
+            }
+        }
+
+        // 길이: int보다 작은 것은 int로 넘어오므로 'l'이 두 번이면 64비트만 따로 처리
+        int is_64 = 0;
+        while (*fmt == 'h' || *fmt == 'l' || *fmt == 'z') {
+            if (*fmt == 'l' && fmt[1] == 'l') {
+                is_64 = 1;
+                fmt++;
+            }
+            fmt++;
+        }
+
+        switch (*fmt) {
+            case '\0': // 포맷 문자열 끝에 '%'
+                sink_put(sink, '%');
+                return;
+            case '%':
+                sink_put(sink, '%');
+                break;
+            case 'c': {
+                char ch = (char)va_arg(vargs, int);
+                int pad = width - 1;
+                if (!(flags & FMT_LEFT)) sink_repeat(sink, ' ', pad);
+                sink_put(sink, ch);
+                if (flags & FMT_LEFT) sink_repeat(sink, ' ', pad);
+                break;
+            }
+            case 's': { // 정밀도가 있으면 그 길이까지만
+                const char *s = va_arg(vargs, const char *);
+                if (!s) {
+                    s = "(null)";
                 }
-                case 'x': { // 16진수 정수 출력
-                    unsigned value = va_arg(vargs, unsigned);
-                    for (int i = 7; i >= 0; i--) {
-                        unsigned nibble = (value >> (i * 4)) & 0xf;
-                        putchar("0123456789abcdef"[nibble]);
-                    }
-                    break;
+                int len = 0;
+                while (s[len] && (precision < 0 || len < precision)) {
+                    len++;
                 }
-                case 'u': { // 부호 없는 정수 출력
-                    unsigned value = va_arg(vargs, unsigned);
-                    unsigned divisor = 1;
-                    while (value / divisor > 9)
-                        divisor *= 10;
-
-                    while (divisor > 0) {
-                        putchar('0' + value / divisor);
-                        value %= divisor;
-                        divisor /= 10;
-                    }
-                    break;
+                int pad = width - len;
+                if (!(flags & FMT_LEFT)) sink_repeat(sink, ' ', pad);
+                for (int i = 0; i < len; i++) {
+                    sink_put(sink, s[i]);
                 }
-                case 'l': { // long/long long 정수 처리
-                    fmt++; // 첫 번째 'l' 건너뛰기
-                    if (*fmt == 'l') {
-                        // long long
-                        fmt++; // 두 번째 'l' 건너뛰기
-                        if (*fmt == 'u') {
-                            // unsigned long long
-                            uint64_t value = va_arg(vargs, uint64_t);
-
-                            // 0에 대한 특수 처리
-                            if (value == 0) {
-                                putchar('0');
-                                break;
-                            }
-
-                            // 문자열로 변환 (32비트용 간소화)
-                            char buf[32];
-                            int pos = 0;
-
-                            while (value > 0 && pos < 31) {
-                                buf[pos++] = '0' + (value % 10);
-                                value /= 10;
-                            }
-
-                            // 역순으로 출력
-                            for (int i = pos - 1; i >= 0; i--) {
-                                putchar(buf[i]);
-                            }
-                        } else if (*fmt == 'd') {
-                            // signed long long
-                            int64_t value = va_arg(vargs, int64_t);
-                            uint64_t magnitude = value;
-
-                            if (value < 0) {
-                                putchar('-');
-                                magnitude = -magnitude;
-                            }
-
-                            if (magnitude == 0) {
-                                putchar('0');
-                                break;
-                            }
-
-                            char buf[32];
-                            int pos = 0;
-
-                            while (magnitude > 0 && pos < 31) {
-                                buf[pos++] = '0' + (magnitude % 10);
-                                magnitude /= 10;
-                            }
-
-                            for (int i = pos - 1; i >= 0; i--) {
-                                putchar(buf[i]);
-                            }
-                        }
-                    } else if (*fmt == 'u') {
-                        // long unsigned
-                        unsigned long value = va_arg(vargs, unsigned long);
-                        unsigned long divisor = 1;
-                        while (value / divisor > 9)
-                            divisor *= 10;
-
-                        while (divisor > 0) {
-                            putchar('0' + value / divisor);
-                            value %= divisor;
-                            divisor /= 10;
-                        }
-                    } else if (*fmt == 'd') {
-                        // long signed
-                        long value = va_arg(vargs, long);
-                        unsigned long magnitude = value;
-                        if (value < 0) {
-                            putchar('-');
-                            magnitude = -magnitude;
-                        }
-
-                        unsigned long divisor = 1;
-                        while (magnitude / divisor > 9)
-                            divisor *= 10;
-
-                        while (divisor > 0) {
-                            putchar('0' + magnitude / divisor);
-                            magnitude %= divisor;
-                            divisor /= 10;
-                        }
-                    }
-                    break;
+                if (flags & FMT_LEFT) sink_repeat(sink, ' ', pad);
+                break;
+            }
+            case 'd':
+            case 'i': {
+                int64_t value = is_64 ? va_arg(vargs, int64_t) : va_arg(vargs, int);
+                uint64_t magnitude = value < 0 ? -(uint64_t)value : (uint64_t)value;
+                if (precision >= 0) flags &= ~FMT_ZERO;
+                fmt_integer(sink, magnitude, value < 0, 10, 0, flags, width,
+                            precision < 0 ? 1 : precision);
+                break;
+            }
+            case 'u': {
+                uint64_t value = is_64 ? va_arg(vargs, uint64_t) : va_arg(vargs, unsigned);
+                if (precision >= 0) flags &= ~FMT_ZERO;
+                fmt_integer(sink, value, 0, 10, 0, flags & ~(FMT_PLUS | FMT_SPACE), width,
+                            precision < 0 ? 1 : precision);
+                break;
+            }
+            case 'x':
+            case 'X':
+            case 'p': {
+                uint64_t value;
+                if (*fmt == 'p') {
+                    value = (uintptr_t)va_arg(vargs, void *);
+                    flags |= FMT_ALT;
+                } else {
+                    value = is_64 ? va_arg(vargs, uint64_t) : va_arg(vargs, unsigned);
                 }
-                case 'p': { // 포인터 주소 출력
-                    void *ptr = va_arg(vargs, void *);
-                    unsigned value = (unsigned)(uintptr_t)ptr;
-                    putchar('0');
-                    putchar('x');
-                    for (int i = 7; i >= 0; i--) {
-                        unsigned nibble = (value >> (i * 4)) & 0xf;
-                        putchar("0123456789abcdef"[nibble]);
-                    }
-                    break;
+                if (width < 0 && precision < 0) {
+                    precision = is_64 ? 16 : 8;
                 }
+                if (precision >= 0 && width >= 0) flags &= ~FMT_ZERO;
+                fmt_integer(sink, value, 0, 16, *fmt == 'X', flags & ~(FMT_PLUS | FMT_SPACE), width,
+                            precision < 0 ? 1 : precision);
+                break;
             }
-        } else {
-            putchar(*fmt);
+            default: // 모르는 변환은 그대로 보여줌
+                sink_put(sink, '%');
+                sink_put(sink, *fmt);
+                break;
         }
-
         fmt++;
     }
+}
+
+void printf(const char *fmt, ...) {
+    struct fmt_sink sink = { NULL, 0, 0 };
+    va_list vargs;
+    va_start(vargs, fmt);
+    vformat(&sink, fmt, vargs);
+    va_end(vargs);
+}
+
+// 버퍼에 서식 출력: 항상 '\0'으로 끝내고, 잘리기 전의 전체 길이를 반환
+int vsnprintf(char *buf, size_t size, const char *fmt, va_list vargs) {
+    struct fmt_sink sink = { buf, size, 0 };
+    vformat(&sink, fmt, vargs);
+    if (size > 0) {
+        buf[sink.len < size ? sink.len : size - 1] = '\0';
+    }
+    return (int)sink.len;
+}
 
-end:
+int snprintf(char *buf, size_t size, const char *fmt, ...) {
+    va_list vargs;
+    va_start(vargs, fmt);
+    int len = vsnprintf(buf, size, fmt, vargs);
     va_end(vargs);
+    return len;
 }
 
-void *memset(void *s, int c, size_t n) {
-    unsigned char *p = s;
-    while (n--) {
-        *p++ = c;
+static int is_space(char ch) {
+    return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r';
+}
+
+// 입력 해석: %d %u %x %s %c %% (폭 지정 가능), 채운 항목 수 반환
+int sscanf(const char *str, const char *fmt, ...) {
+    va_list vargs;
+    va_start(vargs, fmt);
+    int assigned = 0;
+
+    while (*fmt) {
+        if (is_space(*fmt)) {
+            while (is_space(*str)) str++;
+            fmt++;
+            continue;
+        }
+        if (*fmt != '%' || fmt[1] == '%') {
+            if (*fmt == '%') fmt++;
+            if (*str != *fmt) break;
+            str++;
+            fmt++;
+            continue;
+        }
+        fmt++;
+
+        int width = 0;
+        while (*fmt >= '0' && *fmt <= '9') {
+            width = width * 10 + (*fmt++ - '0');
+        }
+        char conv = *fmt++;
+        if (conv == 'c') {
+            if (!*str) break;
+            *va_arg(vargs, char *) = *str++;
+            assigned++;
+            continue;
+        }
+
+        while (is_space(*str)) str++;
+        if (!*str) break;
+
+        if (conv == 's') {
+            char *out = va_arg(vargs, char *);
+            int n = 0;
+            while (*str && !is_space(*str) && (width == 0 || n < width)) {
+                out[n++] = *str++;
+            }
+            out[n] = '\0';
+            assigned++;
+        } else if (conv == 'd' || conv == 'u' || conv == 'x') {
+            int base = conv == 'x' ? 16 : 10;
+            int negative = 0;
+            if (conv == 'd' && (*str == '-' || *str == '+')) {
+                negative = *str++ == '-';
+            }
+            if (base == 16 && str[0] == '0' && (str[1] == 'x' || str[1] == 'X')) {
+                str += 2;
+            }
+            uint32_t value = 0;
+            int digits = 0;
+            for (;; str++, digits++) {
+                int d = *str >= '0' && *str <= '9' ? *str - '0' :
+                        base == 16 && *str >= 'a' && *str <= 'f' ? *str - 'a' + 10 :
+                        base == 16 && *str >= 'A' && *str <= 'F' ? *str - 'A' + 10 : -1;
+                if (d < 0 || (width && digits == width)) break;
+                value = value * base + d;
+            }
+            if (digits == 0) break;
+            if (conv == 'd') {
+                *va_arg(vargs, int *) = negative ? -(int)value : (int)value;
+            } else {
+                *va_arg(vargs, unsigned *) = value;
+            }
+            assigned++;
+        } else {
+            break;
+        }
     }
-    return s;
+
+    va_end(vargs);
+    return assigned;
 }
 
 void handle_syscall(struct trap_frame *f) {
-    (void)f;
+    switch (f->a7) {
+    case SYS_IO_URING_ENTER: {
+        // Only a ring io_uring_setup handed out; anything else is refused, not dereferenced
+        struct io_uring *ring = io_uring_lookup(f->a0);
+        f->a0 = ring ? (uint32_t)io_uring_enter(ring, f->a1, f->a2) : (uint32_t)-1;
+        break;
+    }
+    default:
+        f->a0 = -1;
+        break;
+    }
 }
@@ -0,0 +1,118 @@
+#include "inode.h"
+#include "lz4.h"
+
+// 투명 압축
+// 압축 파일은 페이지 캐시의 한 페이지(블록 8개)를 클러스터 하나로 보고, write-back할 때 통째로 압축해
+// 새 블록에 기록함 (copy-on-write). 블록을 하나 이상 아낄 때만 압축된 익스텐트로 저장하고,
+// 그렇지 않으면 보통 익스텐트로 그대로 저장함
+// 압축된 클러스터의 첫 4바이트는 LZ4 데이터 길이 (블록 끝의 나머지는 0으로 채움)
+
+#define CLUSTER_BLOCKS (PAGE_SIZE / FS_BLOCK_SIZE)
+#define CLUSTER_HEADER 4
+
+// 디스크에서 읽은 압축 데이터 (한 번에 클러스터 하나만 다루므로 공유)
+static uint8_t cluster_buf[PAGE_SIZE];
+
+int compress_read_cluster(struct btree_filesystem *fs, struct inode_extent *ext, uint8_t *out) {
+    if (ext->stored == 0 || ext->stored >= CLUSTER_BLOCKS || block_read(fs, ext->start, ext->stored, cluster_buf) < 0) {
+        return -1;
+    }
+
+    uint32_t len = cluster_buf[0] | (cluster_buf[1] << 8) | (cluster_buf[2] << 16) | ((uint32_t)cluster_buf[3] << 24);
+    if (len > ext->stored * FS_BLOCK_SIZE - CLUSTER_HEADER) {
+        printf("Error: Compressed cluster at block %u is corrupt\n", ext->start);
+        return -1;
+    }
+
+    uint64_t t0 = read_time();
+    int n = lz4_decompress(cluster_buf + CLUSTER_HEADER, len, out, PAGE_SIZE);
+    if (n < 0) {
+        printf("Error: Compressed cluster at block %u is corrupt\n", ext->start);
+        return -1;
+    }
+    fs->compress.decompress_ticks += (uint32_t)(read_time() - t0);
+    fs->compress.decompressed_bytes += n;
+
+    // The cluster may hold less than a page (end of the file); the rest reads as zeros
+    memset(out + n, 0, PAGE_SIZE - n);
+    return 0;
+}
+
+int compress_write_cluster(struct btree_filesystem *fs, struct inode *inode, uint32_t index,
+                           const uint8_t *data, uint32_t len) {
+    uint32_t first = index * CLUSTER_BLOCKS;
+    uint32_t raw_blocks = (len + FS_BLOCK_SIZE - 1) / FS_BLOCK_SIZE;
+
+    // Worth it only if at least one block is saved
+    uint64_t t0 = read_time();
+    uint32_t clen = 0;
+    if (raw_blocks > 1) {
+        clen = lz4_compress(data, len, cluster_buf + CLUSTER_HEADER,
+                            (raw_blocks - 1) * FS_BLOCK_SIZE - CLUSTER_HEADER);
+    }
+    fs->compress.compress_ticks += (uint32_t)(read_time() - t0);
+    fs->compress.compressed_bytes += len;
+
+    // The old copy stays on disk until the next commit no longer points to it
+    extent_punch(fs, inode, first, CLUSTER_BLOCKS);
+
+    // Aim right after the previous cluster so a sequentially written file stays together
+    uint32_t goal = 0;
+    struct inode_extent *prev = first > 0 ? extent_find(inode, first - 1) : NULL;
+    if (prev) {
+        goal = prev->start + (prev->stored ? prev->stored : prev->length);
+    }
+
+    if (clen > 0) {
+        uint32_t stored = (CLUSTER_HEADER + clen + FS_BLOCK_SIZE - 1) / FS_BLOCK_SIZE;
+        cluster_buf[0] = (uint8_t)clen;
+        cluster_buf[1] = (uint8_t)(clen >> 8);
+        cluster_buf[2] = (uint8_t)(clen >> 16);
+        cluster_buf[3] = (uint8_t)(clen >> 24);
+        memset(cluster_buf + CLUSTER_HEADER + clen, 0, stored * FS_BLOCK_SIZE - CLUSTER_HEADER - clen);
+
+        uint32_t allocated;
+        uint32_t start = block_alloc_run(fs, goal, stored, &allocated);
+        if (start != 0 && allocated == stored) {
+            if (extent_add(inode, first, start, CLUSTER_BLOCKS, stored) < 0) {
+                for (uint32_t i = 0; i < allocated; i++) {
+                    block_free(fs, start + i);
+                }
+                return -1;
+            }
+            fs->compress.clusters++;
+            fs->compress.stored_blocks += stored;
+            fs->compress.raw_blocks += raw_blocks;
+            return block_write(fs, start, stored, cluster_buf);
+        }
+
+        // No free run long enough: store it plainly, which can be split
+        for (uint32_t i = 0; i < allocated; i++) {
+            block_free(fs, start + i);
+        }
+    }
+
+    fs->compress.plain_clusters++;
+    fs->compress.stored_blocks += raw_blocks;
+    fs->compress.raw_blocks += raw_blocks;
+    uint32_t done = 0;
+    while (done < raw_blocks) {
+        uint32_t allocated;
+        uint32_t start = block_alloc_run(fs, goal, raw_blocks - done, &allocated);
+        if (start == 0) {
+            return -1;
+        }
+        if (extent_add(inode, first + done, start, allocated, 0) < 0) {
+            for (uint32_t i = 0; i < allocated; i++) {
+                block_free(fs, start + i);
+            }
+            return -1;
+        }
+        if (block_write(fs, start, allocated, data + done * FS_BLOCK_SIZE) < 0) {
+            return -1;
+        }
+        done += allocated;
+        goal = start + allocated;
+    }
+    return 0;
+}
@@ -0,0 +1,146 @@
+#include "console.h"
+#include "string.h"
+
+struct console_line {
+    char buf[CONSOLE_LINE_MAX];
+    uint32_t len;
+};
+
+static struct console_line lines[MAX_HARTS];
+static int backend = CONSOLE_SBI_LEGACY;
+static struct console_stats stats;
+
+// 장치 잠금: 잠금을 쥔 하트에서 트랩(PANIC 등)이 다시 출력하면 잠금 없이 씀
+static struct spinlock device_lock;
+static volatile int device_owner = -1;
+
+void console_init(void) {
+    struct sbiret ret = sbi_call(SBI_EXT_DBCN, 0, 0, 0, 0, 0, SBI_BASE_PROBE_EXTENSION, SBI_EXT_BASE);
+    if (ret.error == 0 && ret.value != 0) {
+        backend = CONSOLE_SBI_DBCN;
+    } else {
+        // No DBCN: drive the UART directly, a FIFO's worth per wait
+        *(volatile uint8_t *)(UART_BASE + UART_FCR) = UART_FCR_ENABLE | UART_FCR_CLEAR;
+        backend = CONSOLE_UART;
+    }
+    printf("Console: %s\n", backend == CONSOLE_SBI_DBCN ? "SBI debug console" : "UART");
+}
+
+int console_backend(void) {
+    return backend;
+}
+
+const struct console_stats *console_get_stats(void) {
+    return &stats;
+}
+
+static void uart_write_bytes(const char *buf, size_t len) {
+    volatile uint8_t *uart = (volatile uint8_t *)UART_BASE;
+    while (len > 0) {
+        while (!(uart[UART_LSR] & UART_LSR_TX_EMPTY)) {
+        }
+        size_t n = len < CONSOLE_UART_FIFO ? len : CONSOLE_UART_FIFO;
+        for (size_t i = 0; i < n; i++) {
+            uart[UART_THR] = (uint8_t)buf[i];
+        }
+        buf += n;
+        len -= n;
+    }
+}
+
+// 장치로 내보내기 (잠금을 쥔 상태에서 호출)
+static void device_write(const char *buf, size_t len) {
+    stats.flushes++;
+    stats.bytes += len;
+
+    if (backend == CONSOLE_SBI_DBCN) {
+        // The kernel runs identity-mapped, so the buffer address is physical
+        while (len > 0) {
+            struct sbiret ret = sbi_call(len, (uint32_t)buf, 0, 0, 0, 0, SBI_DBCN_WRITE, SBI_EXT_DBCN);
+            stats.sbi_calls++;
+            if (ret.error != 0 || ret.value <= 0) {
+                backend = CONSOLE_UART;
+                break;
+            }
+            buf += ret.value;
+            len -= ret.value;
+        }
+        if (len == 0) {
+            return;
+        }
+    }
+
+    if (backend == CONSOLE_UART) {
+        uart_write_bytes(buf, len);
+        return;
+    }
+
+    for (size_t i = 0; i < len; i++) {
+        sbi_call(buf[i], 0, 0, 0, 0, 0, 0, SBI_EXT_LEGACY_PUTCHAR);
+        stats.sbi_calls++;
+    }
+}
+
+static void device_lock_acquire(int *nested) {
+    int hart = (int)cpu_id();
+    *nested = device_owner == hart;
+    if (!*nested) {
+        spin_lock(&device_lock);
+        device_owner = hart;
+    }
+}
+
+static void device_lock_release(int nested) {
+    if (!nested) {
+        device_owner = -1;
+        spin_unlock(&device_lock);
+    }
+}
+
+void console_flush(void) {
+    struct console_line *line = &lines[cpu_id() % MAX_HARTS];
+    if (line->len == 0) {
+        return;
+    }
+
+    // Take a copy and empty the line first: a trap that prints while this one is written
+    // starts a new line instead of sending this one again or overwriting it mid-write
+    char pending[CONSOLE_LINE_MAX];
+    uint32_t saved = interrupts_disable();
+    uint32_t len = line->len;
+    memcpy(pending, line->buf, len);
+    line->len = 0;
+    interrupts_restore(saved);
+
+    int nested;
+    device_lock_acquire(&nested);
+    device_write(pending, len);
+    device_lock_release(nested);
+}
+
+void putchar(char ch) {
+    struct console_line *line = &lines[cpu_id() % MAX_HARTS];
+
+    // A trap must not print between the bounds check and the store
+    uint32_t saved = interrupts_disable();
+    if (line->len >= CONSOLE_LINE_MAX) {
+        console_flush();
+    }
+    line->buf[line->len++] = ch;
+    if (ch == '\n' || line->len >= CONSOLE_LINE_MAX) {
+        console_flush();
+    }
+    interrupts_restore(saved);
+}
+
+void console_write(const char *buf, size_t len) {
+    console_flush();
+    if (len == 0) {
+        return;
+    }
+
+    int nested;
+    device_lock_acquire(&nested);
+    device_write(buf, len);
+    device_lock_release(nested);
+}
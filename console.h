@@ -0,0 +1,35 @@
+#pragma once
+#include "kernel.h"
+
+// 커널 콘솔: 하트마다 한 줄을 모아 두었다가 줄 끝이나 버퍼가 찼을 때 한 번에 내보냄
+// 줄 끝 없이 남은 출력(프롬프트 등)은 입력을 기다리기 전과 idle 루프에서 내보냄
+// 내보내기는 SBI Debug Console(DBCN) write-bytes 한 번, DBCN이 없으면 UART FIFO에 16바이트씩
+// 출력 장치는 잠금으로 보호해 여러 하트의 줄이 섞이지 않음
+
+#define CONSOLE_LINE_MAX 128
+#define CONSOLE_UART_FIFO 16                     // 16550 TX FIFO depth
+
+// SBI 확장
+#define SBI_EXT_LEGACY_PUTCHAR 0x01
+#define SBI_EXT_BASE 0x10
+#define SBI_BASE_PROBE_EXTENSION 3
+#define SBI_EXT_DBCN 0x4442434E                  // "DBCN"
+#define SBI_DBCN_WRITE 0                         // a0 = bytes, a1/a2 = physical address low/high
+
+// 출력 경로
+#define CONSOLE_SBI_LEGACY 0                     // Until console_init: one ecall per byte
+#define CONSOLE_SBI_DBCN   1
+#define CONSOLE_UART       2
+
+struct console_stats {
+    uint32_t flushes;                            // Buffered lines handed to the device
+    uint32_t bytes;
+    uint32_t sbi_calls;                          // Traps into the SBI firmware
+};
+
+void console_init(void);                         // Picks DBCN if the firmware has it, else the UART
+void putchar(char ch);
+void console_write(const char *buf, size_t len); // Bulk output (fd 1), bypassing the line buffer
+void console_flush(void);                        // Sends this hart's pending line
+int console_backend(void);
+const struct console_stats *console_get_stats(void);
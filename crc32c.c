@@ -0,0 +1,64 @@
+#include "crc32c.h"
+#include "string.h"
+
+#define CRC32C_POLY 0x82F63B78u
+
+// table[0]은 바이트 하나의 CRC, table[k]는 그 바이트 뒤에 0 바이트 k개가 더 이어질 때의 CRC
+static uint32_t table[8][256];
+static int table_ready;
+
+static void crc32c_init(void) {
+    for (uint32_t b = 0; b < 256; b++) {
+        uint32_t crc = b;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (crc & 1 ? CRC32C_POLY : 0);
+        }
+        table[0][b] = crc;
+    }
+    for (uint32_t b = 0; b < 256; b++) {
+        for (int k = 1; k < 8; k++) {
+            table[k][b] = (table[k - 1][b] >> 8) ^ table[0][table[k - 1][b] & 0xff];
+        }
+    }
+    table_ready = 1;
+}
+
+uint32_t crc32c_bytewise(uint32_t crc, const void *data, uint32_t len) {
+    if (!table_ready) {
+        crc32c_init();
+    }
+    const uint8_t *p = (const uint8_t *)data;
+    crc = ~crc;
+    while (len--) {
+        crc = (crc >> 8) ^ table[0][(crc ^ *p++) & 0xff];
+    }
+    return ~crc;
+}
+
+uint32_t crc32c(uint32_t crc, const void *data, uint32_t len) {
+    if (!table_ready) {
+        crc32c_init();
+    }
+    const uint8_t *p = (const uint8_t *)data;
+    crc = ~crc;
+
+    // Bytes up to a word boundary, then eight at a time (little-endian loads)
+    while (len > 0 && ((uintptr_t)p & 3)) {
+        crc = (crc >> 8) ^ table[0][(crc ^ *p++) & 0xff];
+        len--;
+    }
+    while (len >= 8) {
+        uint32_t lo = *(const mem_word *)p ^ crc;
+        uint32_t hi = *(const mem_word *)(p + 4);
+        crc = table[7][lo & 0xff] ^ table[6][(lo >> 8) & 0xff] ^
+              table[5][(lo >> 16) & 0xff] ^ table[4][lo >> 24] ^
+              table[3][hi & 0xff] ^ table[2][(hi >> 8) & 0xff] ^
+              table[1][(hi >> 16) & 0xff] ^ table[0][hi >> 24];
+        p += 8;
+        len -= 8;
+    }
+    while (len--) {
+        crc = (crc >> 8) ^ table[0][(crc ^ *p++) & 0xff];
+    }
+    return ~crc;
+}
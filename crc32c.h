@@ -0,0 +1,12 @@
+#pragma once
+#include "kernel.h"
+
+// CRC32C (Castagnoli, 반사 다항식 0x82F63B78)
+// crc에 이전 결과를 넘기면 이어서 계산 (처음에는 0)
+// 8바이트씩 처리하는 slicing-by-8 표 (8KB)를 처음 호출할 때 만듦
+// Zbc(clmul) 경로는 없음: S-mode에서는 misa를 읽을 수 없고, 장치 트리의 riscv,isa도 해석하지 않으며,
+// 시험 실행으로 알아보려 해도 handle_trap이 illegal instruction을 복구하지 않으므로 안전하게 켤 방법이 없음
+uint32_t crc32c(uint32_t crc, const void *data, uint32_t len);
+
+// 한 바이트씩 처리하는 기준 구현 (벤치마크와 검증용)
+uint32_t crc32c_bytewise(uint32_t crc, const void *data, uint32_t len);
@@ -0,0 +1,100 @@
+#include "dcache.h"
+
+static uint32_t dcache_bucket(uint32_t parent, uint32_t hash) {
+    return (hash ^ (parent * 0x9e3779b1u)) % DCACHE_BUCKETS;
+}
+
+void dcache_init(struct dcache *dc) {
+    for (int i = 0; i < DCACHE_ENTRIES; i++) {
+        dc->entries[i].in_use = 0;
+        dc->entries[i].next = -1;
+    }
+    for (int b = 0; b < DCACHE_BUCKETS; b++) {
+        dc->buckets[b] = -1;
+    }
+    dc->hand = 0;
+    dc->hits = 0;
+    dc->negative_hits = 0;
+    dc->misses = 0;
+}
+
+static struct dentry *dcache_find(struct dcache *dc, uint32_t parent, uint32_t hash) {
+    for (int i = dc->buckets[dcache_bucket(parent, hash)]; i >= 0; i = dc->entries[i].next) {
+        struct dentry *d = &dc->entries[i];
+        if (d->parent == parent && d->hash == hash) {
+            return d;
+        }
+    }
+    return NULL;
+}
+
+// 항목을 해시 체인에서 떼어 내고 비움
+static void dcache_remove(struct dcache *dc, int index) {
+    struct dentry *d = &dc->entries[index];
+    int16_t *link = &dc->buckets[dcache_bucket(d->parent, d->hash)];
+    while (*link != index) {
+        link = &dc->entries[*link].next;
+    }
+    *link = d->next;
+    d->next = -1;
+    d->in_use = 0;
+}
+
+int dcache_lookup(struct dcache *dc, uint32_t parent, uint32_t hash, struct inode **inode) {
+    struct dentry *d = dcache_find(dc, parent, hash);
+    if (!d) {
+        dc->misses++;
+        return 0;
+    }
+    d->referenced = 1;
+    if (d->inode) {
+        dc->hits++;
+    } else {
+        dc->negative_hits++;
+    }
+    *inode = d->inode;
+    return 1;
+}
+
+void dcache_add(struct dcache *dc, uint32_t parent, uint32_t hash, struct inode *inode) {
+    struct dentry *d = dcache_find(dc, parent, hash);
+    if (d) {
+        d->inode = inode;
+        d->referenced = 1;
+        return;
+    }
+
+    // CLOCK: take a free entry, or the first one not referenced since the hand last passed
+    int index;
+    for (;;) {
+        index = dc->hand;
+        dc->hand = (dc->hand + 1) % DCACHE_ENTRIES;
+        struct dentry *victim = &dc->entries[index];
+        if (!victim->in_use) {
+            break;
+        }
+        if (!victim->referenced) {
+            dcache_remove(dc, index);
+            break;
+        }
+        victim->referenced = 0;
+    }
+
+    d = &dc->entries[index];
+    uint32_t bucket = dcache_bucket(parent, hash);
+    d->parent = parent;
+    d->hash = hash;
+    d->inode = inode;
+    d->in_use = 1;
+    d->referenced = 0;
+    d->next = dc->buckets[bucket];
+    dc->buckets[bucket] = (int16_t)index;
+}
+
+void dcache_purge_dir(struct dcache *dc, uint32_t parent) {
+    for (int i = 0; i < DCACHE_ENTRIES; i++) {
+        if (dc->entries[i].in_use && dc->entries[i].parent == parent) {
+            dcache_remove(dc, i);
+        }
+    }
+}
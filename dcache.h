@@ -0,0 +1,39 @@
+#pragma once
+#include "kernel.h"
+
+struct inode;
+
+// 디렉터리 항목 캐시: (부모 디렉터리, 이름 해시) -> i-node
+// 없는 이름도 inode가 NULL인 항목(negative)으로 기억해 같은 실패를 다시 찾지 않음
+// 파일시스템마다 하나씩 두고, 가득 차면 CLOCK으로 내보냄
+#define DCACHE_ENTRIES 128
+#define DCACHE_BUCKETS 64
+
+struct dentry {
+    uint32_t parent;                             // Directory i-node the name lives in
+    uint32_t hash;                               // hash_string() of the name
+    struct inode *inode;                         // NULL for a negative entry
+    int16_t next;                                // Next entry in the bucket (-1 = end)
+    uint8_t in_use;
+    uint8_t referenced;                          // CLOCK reference bit
+};
+
+struct dcache {
+    struct dentry entries[DCACHE_ENTRIES];
+    int16_t buckets[DCACHE_BUCKETS];             // First entry of each hash chain (-1 = empty)
+    uint32_t hand;                               // CLOCK hand
+    uint32_t hits;                               // Lookups answered with an i-node
+    uint32_t negative_hits;                      // Lookups answered "no such name"
+    uint32_t misses;                             // Lookups that had to search the directory
+};
+
+void dcache_init(struct dcache *dc);
+
+// 캐시된 항목이 있으면 1 (*inode는 NULL일 수 있음), 없으면 0
+int dcache_lookup(struct dcache *dc, uint32_t parent, uint32_t hash, struct inode **inode);
+
+// 항목 추가 또는 갱신 (inode가 NULL이면 negative 항목)
+void dcache_add(struct dcache *dc, uint32_t parent, uint32_t hash, struct inode *inode);
+
+// 디렉터리 하나의 항목을 모두 버림 (디렉터리를 지울 때)
+void dcache_purge_dir(struct dcache *dc, uint32_t parent);
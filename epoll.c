@@ -1,5 +1,7 @@
 #include "epoll.h"
 #include "common.h"
+#include "log.h"
+#include "trace.h"
 
 /* 전역 epoll 인스턴스들 */
 struct epoll_instances global_epoll;
@@ -14,7 +16,7 @@ void epoll_init(void) {
         global_epoll.instances[i].in_use = 0;
     }
 
-    printf("epoll subsystem initialized\n");
+    LOG_INFO("epoll subsystem initialized\n");
 }
 
 /* epoll 인스턴스 가져오기 */
@@ -43,12 +45,12 @@ int epoll_create(int size) {
             epi->num_items = 0;
             epi->in_use = 1;
 
-            printf("epoll: Created epoll instance %d\n", epi->epfd);
+            LOG_DEBUG("epoll: Created epoll instance %d\n", epi->epfd);
             return epi->epfd;
         }
     }
 
-    printf("epoll: No free epoll instances\n");
+    LOG_ERROR("epoll: No free epoll instances\n");
     return -999;  /* 유효한 epfd와 다른 에러 표시자 */
 }
 
@@ -117,29 +119,30 @@ static int epoll_insert_item(struct epoll_instance *epi, struct epoll_item *new_
 int epoll_ctl(int epfd, int op, int fd, struct epoll_event *event) {
     struct epoll_instance *epi = epoll_get_instance(epfd);
     if (!epi) {
-        printf("epoll_ctl: Invalid epfd %d\n", epfd);
+        LOG_ERROR("epoll_ctl: Invalid epfd %d\n", epfd);
         return -1;
     }
 
     /* fd가 존재하는지 확인 */
     struct fd *fd_entry = fd_get(fd);
     if (!fd_entry) {
-        printf("epoll_ctl: Invalid fd %d\n", fd);
+        LOG_ERROR("epoll_ctl: Invalid fd %d\n", fd);
         return -1;
     }
 
+    trace(TRACE_EPOLL_CTL, epfd, op, fd);
     switch (op) {
         case EPOLL_CTL_ADD: {
             /* fd가 이미 존재하는지 확인 */
             if (epoll_find_item(epi, fd)) {
-                printf("epoll_ctl: fd %d already in epoll instance\n", fd);
+                LOG_ERROR("epoll_ctl: fd %d already in epoll instance\n", fd);
                 return -1;
             }
 
             /* 새 아이템 할당 */
             struct epoll_item *item = (struct epoll_item *)kmalloc(sizeof(struct epoll_item));
             if (!item) {
-                printf("epoll_ctl: Failed to allocate epoll_item\n");
+                LOG_ERROR("epoll_ctl: Failed to allocate epoll_item\n");
                 return -1;
             }
 
@@ -154,15 +157,15 @@ int epoll_ctl(int epfd, int op, int fd, struct epoll_event *event) {
                 return -1;
             }
 
-            printf("epoll_ctl: Added fd %d to epoll %d (events=0x%x)\n",
-                   fd, epfd, event->events);
+            LOG_DEBUG("epoll_ctl: Added fd %d to epoll %d (events=0x%x)\n",
+                      fd, epfd, event->events);
             break;
         }
 
         case EPOLL_CTL_DEL: {
             struct epoll_item *item = epoll_find_item(epi, fd);
             if (!item) {
-                printf("epoll_ctl: fd %d not found in epoll instance\n", fd);
+                LOG_ERROR("epoll_ctl: fd %d not found in epoll instance\n", fd);
                 return -1;
             }
 
@@ -170,27 +173,27 @@ int epoll_ctl(int epfd, int op, int fd, struct epoll_event *event) {
             epi->num_items--;
             kfree(item);
 
-            printf("epoll_ctl: Removed fd %d from epoll %d\n", fd, epfd);
+            LOG_DEBUG("epoll_ctl: Removed fd %d from epoll %d\n", fd, epfd);
             break;
         }
 
         case EPOLL_CTL_MOD: {
             struct epoll_item *item = epoll_find_item(epi, fd);
             if (!item) {
-                printf("epoll_ctl: fd %d not found in epoll instance\n", fd);
+                LOG_ERROR("epoll_ctl: fd %d not found in epoll instance\n", fd);
                 return -1;
             }
 
             item->events = event->events;
             item->user_data = event->data;
 
-            printf("epoll_ctl: Modified fd %d in epoll %d (events=0x%x)\n",
-                   fd, epfd, event->events);
+            LOG_DEBUG("epoll_ctl: Modified fd %d in epoll %d (events=0x%x)\n",
+                      fd, epfd, event->events);
             break;
         }
 
         default:
-            printf("epoll_ctl: Invalid operation %d\n", op);
+            LOG_ERROR("epoll_ctl: Invalid operation %d\n", op);
             return -1;
     }
 
@@ -231,12 +234,12 @@ void epoll_poll_fds(struct epoll_instance *epi) {
 int epoll_wait(int epfd, struct epoll_event *events, int maxevents, int timeout) {
     struct epoll_instance *epi = epoll_get_instance(epfd);
     if (!epi) {
-        printf("epoll_wait: Invalid epfd %d\n", epfd);
+        LOG_ERROR("epoll_wait: Invalid epfd %d\n", epfd);
         return -1;
     }
 
     if (maxevents <= 0) {
-        printf("epoll_wait: Invalid maxevents %d\n", maxevents);
+        LOG_ERROR("epoll_wait: Invalid maxevents %d\n", maxevents);
         return -1;
     }
 
@@ -255,16 +258,18 @@ int epoll_wait(int epfd, struct epoll_event *events, int maxevents, int timeout)
             events[num_ready].data = item->user_data;
             num_ready++;
 
-            printf("epoll_wait: fd %d ready (events=0x%x)\n",
-                   item->fd, item->revents);
+            trace(TRACE_EPOLL_READY, item->fd, item->revents, 0);
+            LOG_DEBUG("epoll_wait: fd %d ready (events=0x%x)\n",
+                      item->fd, item->revents);
         }
 
         node = rb_next(node);
     }
 
+    trace(TRACE_EPOLL_WAIT, epfd, num_ready, timeout);
     if (num_ready == 0 && timeout != 0) {
         /* 실제 구현에서는 여기서 대기함 */
-        printf("epoll_wait: No events ready (would block with timeout=%d)\n", timeout);
+        LOG_DEBUG("epoll_wait: No events ready (would block with timeout=%d)\n", timeout);
     }
 
     return num_ready;
@@ -274,7 +279,7 @@ int epoll_wait(int epfd, struct epoll_event *events, int maxevents, int timeout)
 int epoll_close(int epfd) {
     struct epoll_instance *epi = epoll_get_instance(epfd);
     if (!epi) {
-        printf("epoll_close: Invalid epfd %d\n", epfd);
+        LOG_ERROR("epoll_close: Invalid epfd %d\n", epfd);
         return -1;
     }
 
@@ -297,6 +302,6 @@ int epoll_close(int epfd) {
     epi->num_items = 0;
     epi->in_use = 0;
 
-    printf("epoll: Closed epoll instance %d\n", epfd);
+    LOG_DEBUG("epoll: Closed epoll instance %d\n", epfd);
     return 0;
 }
@@ -0,0 +1,325 @@
+#include "inode.h"
+#include "btree.h"
+#include "kernel.h"
+
+// 익스텐트 매핑
+// 익스텐트가 INODE_INLINE_EXTENTS개 이하면 i-node 안에 논리 블록 순으로 저장하고,
+// 그보다 많아지면 논리 블록을 키로 하는 B-트리로 옮김
+
+static int extent_is_tree(struct inode *inode) {
+    return (inode->flags & INODE_FLAG_EXTENT_TREE) != 0;
+}
+
+// block_idx 이하에서 시작하는 마지막 익스텐트
+static struct inode_extent *extent_prev(struct inode *inode, uint32_t block_idx) {
+    if (extent_is_tree(inode)) {
+        uint32_t key;
+        return (struct inode_extent *)btree_search_floor(inode->extent_tree, block_idx, &key);
+    }
+
+    struct inode_extent *prev = NULL;
+    for (uint32_t i = 0; i < inode->extent_count && inode->extents[i].logical <= block_idx; i++) {
+        prev = &inode->extents[i];
+    }
+    return prev;
+}
+
+// block_idx를 포함하는 익스텐트 찾기
+struct inode_extent *extent_find(struct inode *inode, uint32_t block_idx) {
+    struct inode_extent *ext = extent_prev(inode, block_idx);
+
+    if (ext && block_idx < ext->logical + ext->length) {
+        return ext;
+    }
+    return NULL;
+}
+
+// block_idx 이상에서 시작하는 첫 익스텐트
+struct inode_extent *extent_next(struct inode *inode, uint32_t block_idx) {
+    if (extent_is_tree(inode)) {
+        uint32_t key;
+        return (struct inode_extent *)btree_search_ceil(inode->extent_tree, block_idx, &key);
+    }
+
+    for (uint32_t i = 0; i < inode->extent_count; i++) {
+        if (inode->extents[i].logical >= block_idx) {
+            return &inode->extents[i];
+        }
+    }
+    return NULL;
+}
+
+// 인라인 익스텐트를 B-트리로 옮기기
+static int extent_spill(struct inode *inode) {
+    struct btree *tree = (struct btree *)kmalloc(sizeof(struct btree));
+    if (!tree) {
+        return -1;
+    }
+    btree_init(tree);
+
+    // The tree pointer shares storage with the inline array, so copy it out first
+    struct inode_extent inline_extents[INODE_INLINE_EXTENTS];
+    for (uint32_t i = 0; i < inode->extent_count; i++) {
+        inline_extents[i] = inode->extents[i];
+    }
+
+    for (uint32_t i = 0; i < inode->extent_count; i++) {
+        struct inode_extent *ext = (struct inode_extent *)kmalloc(sizeof(struct inode_extent));
+        if (ext) {
+            *ext = inline_extents[i];
+        }
+        if (!ext || btree_insert(tree, ext->logical, ext) < 0) {
+            // The inline extents are untouched until the tree is complete
+            kfree(ext);
+            for (uint32_t j = 0; j < i; j++) {
+                kfree(btree_search(tree, inline_extents[j].logical));
+            }
+            btree_destroy(tree);
+            kfree(tree);
+            return -1;
+        }
+    }
+
+    inode->extent_tree = tree;
+    inode->flags |= INODE_FLAG_EXTENT_TREE;
+    return 0;
+}
+
+// 익스텐트가 다시 적어지면 i-node 안으로 되돌리기
+static void extent_fold(struct inode *inode) {
+    struct btree *tree = inode->extent_tree;
+    struct inode_extent inline_extents[INODE_INLINE_EXTENTS];
+    uint32_t count = 0;
+    uint32_t key;
+
+    struct inode_extent *ext = (struct inode_extent *)btree_search_ceil(tree, 0, &key);
+    while (ext) {
+        inline_extents[count++] = *ext;
+        btree_delete(tree, ext->logical);
+        kfree(ext);
+        ext = (struct inode_extent *)btree_search_ceil(tree, 0, &key);
+    }
+
+    btree_destroy(tree);
+    kfree(tree);
+
+    inode->flags &= ~INODE_FLAG_EXTENT_TREE;
+    for (uint32_t i = 0; i < INODE_INLINE_EXTENTS; i++) {
+        if (i < count) {
+            inode->extents[i] = inline_extents[i];
+        } else {
+            inode->extents[i].logical = 0;
+            inode->extents[i].start = 0;
+            inode->extents[i].length = 0;
+            inode->extents[i].stored = 0;
+        }
+    }
+}
+
+// 새 익스텐트 추가
+static int extent_insert(struct inode *inode, uint32_t logical, uint32_t start, uint32_t length, uint32_t stored) {
+    if (!extent_is_tree(inode) && inode->extent_count == INODE_INLINE_EXTENTS) {
+        if (extent_spill(inode) < 0) {
+            return -1;
+        }
+    }
+
+    if (extent_is_tree(inode)) {
+        struct inode_extent *ext = (struct inode_extent *)kmalloc(sizeof(struct inode_extent));
+        if (!ext) {
+            return -1;
+        }
+        ext->logical = logical;
+        ext->start = start;
+        ext->length = length;
+        ext->stored = stored;
+        if (btree_insert(inode->extent_tree, logical, ext) < 0) {
+            kfree(ext);
+            return -1;
+        }
+    } else {
+        // Keep the inline array sorted by logical block
+        uint32_t i = inode->extent_count;
+        while (i > 0 && inode->extents[i - 1].logical > logical) {
+            inode->extents[i] = inode->extents[i - 1];
+            i--;
+        }
+        inode->extents[i].logical = logical;
+        inode->extents[i].start = start;
+        inode->extents[i].length = length;
+        inode->extents[i].stored = stored;
+    }
+
+    inode->extent_count++;
+    inode->tree_dirty = 1;
+    return 0;
+}
+
+// 익스텐트 제거
+static void extent_remove(struct inode *inode, struct inode_extent *ext) {
+    if (extent_is_tree(inode)) {
+        btree_delete(inode->extent_tree, ext->logical);
+        kfree(ext);
+    } else {
+        uint32_t i = ext - inode->extents;
+        for (; i + 1 < inode->extent_count; i++) {
+            inode->extents[i] = inode->extents[i + 1];
+        }
+    }
+
+    inode->extent_count--;
+    inode->tree_dirty = 1;
+}
+
+// 익스텐트의 시작 논리 블록 변경 (B-트리 키도 함께 바꿈)
+static int extent_rekey(struct inode *inode, struct inode_extent *ext, uint32_t logical) {
+    if (extent_is_tree(inode)) {
+        if (btree_insert(inode->extent_tree, logical, ext) < 0) {
+            return -1;
+        }
+        btree_delete(inode->extent_tree, ext->logical);
+    }
+    ext->logical = logical;
+    return 0;
+}
+
+// block_idx부터 최대 count개 블록을 연속 물리 블록으로 매핑 (없으면 할당)
+// 매핑된 첫 물리 블록과 연속 길이를 돌려줌
+int extent_map_run(struct btree_filesystem *fs, struct inode *inode, uint32_t block_idx,
+                   uint32_t count, uint32_t *start, uint32_t *length) {
+    struct inode_extent *ext = extent_find(inode, block_idx);
+    if (ext) {
+        uint32_t avail = ext->logical + ext->length - block_idx;
+        *start = ext->start + (block_idx - ext->logical);
+        *length = avail < count ? avail : count;
+        return 0;
+    }
+
+    // Do not allocate over the next mapped range
+    struct inode_extent *next = extent_next(inode, block_idx);
+    if (next && next->logical - block_idx < count) {
+        count = next->logical - block_idx;
+    }
+
+    // Aim right after the previous extent so the file stays contiguous
+    struct inode_extent *prev = extent_prev(inode, block_idx);
+    uint32_t goal = prev ? prev->start + (block_idx - prev->logical) : 0;
+
+    uint32_t allocated;
+    uint32_t phys = block_alloc_run(fs, goal, count, &allocated);
+    if (phys == 0) {
+        return -1;
+    }
+    inode->block_count += allocated;
+    // Growing an extent in place changes the tree as much as inserting one
+    inode->tree_dirty = 1;
+
+    if (prev && prev->logical + prev->length == block_idx && prev->start + prev->length == phys) {
+        prev->length += allocated;
+    } else if (next && next->logical == block_idx + allocated && next->start == phys + allocated &&
+               extent_rekey(inode, next, block_idx) == 0) {
+        // Grow the next extent backwards
+        next->start = phys;
+        next->length += allocated;
+    } else if (extent_insert(inode, block_idx, phys, allocated, 0) < 0) {
+        for (uint32_t i = 0; i < allocated; i++) {
+            block_free(fs, phys + i);
+        }
+        inode->block_count -= allocated;
+        return -1;
+    }
+
+    // Filling the gap may have joined prev and next
+    prev = extent_prev(inode, block_idx);
+    next = extent_next(inode, block_idx + 1);
+    if (prev && next && prev->logical + prev->length == next->logical &&
+        prev->start + prev->length == next->start) {
+        prev->length += next->length;
+        extent_remove(inode, next);
+    }
+
+    *start = phys;
+    *length = allocated;
+    return 0;
+}
+
+// 익스텐트가 차지한 물리 블록 해제
+static void extent_release(struct btree_filesystem *fs, struct inode *inode, struct inode_extent *ext, uint32_t keep) {
+    uint32_t blocks = ext->stored ? ext->stored : ext->length;
+    for (uint32_t i = keep; i < blocks; i++) {
+        block_free(fs, ext->start + i);
+    }
+    inode->block_count -= blocks - keep;
+}
+
+// B-트리가 다시 i-node 안에 들어갈 만큼 작아졌으면 되돌리기
+static void extent_shrink(struct inode *inode) {
+    if (extent_is_tree(inode) && inode->extent_count <= INODE_INLINE_EXTENTS) {
+        extent_fold(inode);
+    }
+}
+
+// first_block 이후의 블록을 모두 해제 (압축된 익스텐트는 통째로만 해제하므로 걸쳐 있으면 남김)
+void extent_truncate(struct btree_filesystem *fs, struct inode *inode, uint32_t first_block) {
+    while (inode->extent_count > 0) {
+        struct inode_extent *last = extent_prev(inode, 0xFFFFFFFF);
+        if (last->logical + last->length <= first_block) {
+            break;
+        }
+
+        uint32_t keep = last->logical < first_block ? first_block - last->logical : 0;
+        if (last->stored && keep > 0) {
+            break;
+        }
+        extent_release(fs, inode, last, keep);
+
+        if (keep == 0) {
+            extent_remove(inode, last);
+        } else {
+            last->length = keep;
+            inode->tree_dirty = 1;
+            break;
+        }
+    }
+
+    extent_shrink(inode);
+}
+
+// [first_block, first_block + count)에서 시작하는 익스텐트를 모두 해제
+// (압축 파일은 익스텐트가 클러스터 경계를 넘지 않으므로 클러스터를 비우는 데 씀)
+void extent_punch(struct btree_filesystem *fs, struct inode *inode, uint32_t first_block, uint32_t count) {
+    struct inode_extent *ext = extent_next(inode, first_block);
+    while (ext && ext->logical < first_block + count) {
+        extent_release(fs, inode, ext, 0);
+        extent_remove(inode, ext);
+        ext = extent_next(inode, first_block);
+    }
+
+    extent_shrink(inode);
+}
+
+// 이미 할당한 블록으로 익스텐트 추가 (이웃과 합치지 않음, stored가 0이 아니면 압축된 익스텐트)
+int extent_add(struct inode *inode, uint32_t logical, uint32_t start, uint32_t length, uint32_t stored) {
+    if (extent_insert(inode, logical, start, length, stored) < 0) {
+        return -1;
+    }
+    inode->block_count += stored ? stored : length;
+    return 0;
+}
+
+// 익스텐트 목록 출력
+void extent_print(struct inode *inode) {
+    printf("  Extents (%u%s): ", inode->extent_count,
+           extent_is_tree(inode) ? ", B-Tree" : ", inline");
+
+    struct inode_extent *ext = extent_next(inode, 0);
+    while (ext) {
+        if (ext->stored) {
+            printf("[%u+%u -> %u, lz4 in %u] ", ext->logical, ext->length, ext->start, ext->stored);
+        } else {
+            printf("[%u+%u -> %u] ", ext->logical, ext->length, ext->start);
+        }
+        ext = extent_next(inode, ext->logical + 1);
+    }
+    printf("\n");
+}
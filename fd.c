@@ -1,5 +1,8 @@
 #include "fd.h"
 #include "common.h"
+#include "console.h"
+#include "log.h"
+#include "trace.h"
 
 /* 전역 파일 디스크립터 테이블 */
 struct fd_table global_fd_table;
@@ -7,6 +10,7 @@ struct fd_table global_fd_table;
 /* UART 파일 디스크립터 연산 */
 static int uart_fd_read(void *ctx, void *buf, size_t count) {
     (void)ctx;
+    console_flush();
     char *cbuf = (char *)buf;
     size_t i;
 
@@ -22,13 +26,40 @@ static int uart_fd_read(void *ctx, void *buf, size_t count) {
 
 static int uart_fd_write(void *ctx, const void *buf, size_t count) {
     (void)ctx;
-    const char *cbuf = (const char *)buf;
+    console_write((const char *)buf, count);
+    return (int)count;
+}
+
+/* 조각을 차례로 채우다가 받은 문자가 없으면 멈춤 */
+static int uart_fd_readv(void *ctx, const struct iovec *iov, int iovcnt) {
+    (void)ctx;
+    console_flush();
+    int total = 0;
 
-    for (size_t i = 0; i < count; i++) {
-        uart_putchar(cbuf[i]);
+    for (int i = 0; i < iovcnt; i++) {
+        char *cbuf = (char *)iov[i].iov_base;
+        for (size_t j = 0; j < iov[i].iov_len; j++) {
+            if (!uart_rx_ready()) {
+                return total;
+            }
+            cbuf[j] = uart_getchar();
+            total++;
+        }
     }
 
-    return (int)count;
+    return total;
+}
+
+static int uart_fd_writev(void *ctx, const struct iovec *iov, int iovcnt) {
+    (void)ctx;
+    int total = 0;
+
+    for (int i = 0; i < iovcnt; i++) {
+        console_write((const char *)iov[i].iov_base, iov[i].iov_len);
+        total += iov[i].iov_len;
+    }
+
+    return total;
 }
 
 static int uart_fd_poll(void *ctx) {
@@ -54,6 +85,8 @@ static void uart_fd_close(void *ctx) {
 struct fd_ops uart_fd_ops = {
     .read = uart_fd_read,
     .write = uart_fd_write,
+    .readv = uart_fd_readv,
+    .writev = uart_fd_writev,
     .poll = uart_fd_poll,
     .close = uart_fd_close,
 };
@@ -70,7 +103,7 @@ void fd_init(void) {
     }
     global_fd_table.next_fd = 0;
 
-    printf("File descriptor subsystem initialized\n");
+    LOG_INFO("File descriptor subsystem initialized\n");
 }
 
 /* 새 파일 디스크립터 할당 */
@@ -88,12 +121,13 @@ int fd_alloc(int type, void *context, struct fd_ops *ops) {
 
             global_fd_table.next_fd = (fd_num + 1) % MAX_FDS;
 
-            printf("FD: Allocated fd %d (type=%d)\n", fd_num, type);
+            trace(TRACE_FD_ALLOC, fd_num, type, 0);
+            LOG_DEBUG("FD: Allocated fd %d (type=%d)\n", fd_num, type);
             return fd_num;
         }
     }
 
-    printf("FD: No free file descriptors\n");
+    LOG_ERROR("FD: No free file descriptors\n");
     return -1;
 }
 
@@ -130,12 +164,103 @@ int fd_close(int fd_num) {
         fd->ops = NULL;
         fd->ref_count = 0;
 
-        printf("FD: Closed fd %d\n", fd_num);
+        trace(TRACE_FD_CLOSE, fd_num, 0, 0);
+        LOG_DEBUG("FD: Closed fd %d\n", fd_num);
     }
 
     return 0;
 }
 
+/* 읽기/쓰기 */
+int fd_read(int fd_num, void *buf, size_t count) {
+    struct fd *fd = fd_get(fd_num);
+    if (!fd || !fd->ops || !fd->ops->read) {
+        return -1;
+    }
+
+    return fd->ops->read(fd->context, buf, count);
+}
+
+int fd_write(int fd_num, const void *buf, size_t count) {
+    struct fd *fd = fd_get(fd_num);
+    if (!fd || !fd->ops || !fd->ops->write) {
+        return -1;
+    }
+
+    return fd->ops->write(fd->context, buf, count);
+}
+
+int fd_fsync(int fd_num) {
+    struct fd *fd = fd_get(fd_num);
+    if (!fd || !fd->ops) {
+        return -1;
+    }
+
+    return fd->ops->fsync ? fd->ops->fsync(fd->context) : 0;
+}
+
+size_t iov_length(const struct iovec *iov, int iovcnt) {
+    size_t total = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        total += iov[i].iov_len;
+    }
+    return total;
+}
+
+/* 여러 조각 읽기/쓰기: 타입별 readv/writev가 없으면 조각마다 read/write */
+int fd_readv(int fd_num, const struct iovec *iov, int iovcnt) {
+    struct fd *fd = fd_get(fd_num);
+    if (!fd || !fd->ops || iovcnt < 0 || iovcnt > FD_IOV_MAX) {
+        return -1;
+    }
+    if (fd->ops->readv) {
+        return fd->ops->readv(fd->context, iov, iovcnt);
+    }
+    if (!fd->ops->read) {
+        return -1;
+    }
+
+    int total = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        int n = fd->ops->read(fd->context, iov[i].iov_base, iov[i].iov_len);
+        if (n < 0) {
+            return total > 0 ? total : n;
+        }
+        total += n;
+        /* A short read means nothing more is available right now */
+        if ((size_t)n < iov[i].iov_len) {
+            break;
+        }
+    }
+    return total;
+}
+
+int fd_writev(int fd_num, const struct iovec *iov, int iovcnt) {
+    struct fd *fd = fd_get(fd_num);
+    if (!fd || !fd->ops || iovcnt < 0 || iovcnt > FD_IOV_MAX) {
+        return -1;
+    }
+    if (fd->ops->writev) {
+        return fd->ops->writev(fd->context, iov, iovcnt);
+    }
+    if (!fd->ops->write) {
+        return -1;
+    }
+
+    int total = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        int n = fd->ops->write(fd->context, iov[i].iov_base, iov[i].iov_len);
+        if (n < 0) {
+            return total > 0 ? total : n;
+        }
+        total += n;
+        if ((size_t)n < iov[i].iov_len) {
+            break;
+        }
+    }
+    return total;
+}
+
 /* 이벤트에 대해 파일 디스크립터 폴링 */
 int fd_poll(int fd_num) {
     struct fd *fd = fd_get(fd_num);
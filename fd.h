@@ -16,10 +16,24 @@
 #define FD_ERROR     (1 << 2)
 #define FD_HANGUP    (1 << 3)
 
+/* readv/writev 한 번에 넘길 수 있는 조각 수 */
+#define FD_IOV_MAX 16
+
+/* 흩어진 버퍼 조각 하나 (readv/writev) */
+struct iovec {
+    void *iov_base;
+    size_t iov_len;
+};
+
 /* 파일 디스크립터 연산 */
+/* readv/writev는 선택: 없으면 조각마다 read/write를 부르고 덜 전송되면 멈춤 */
+/* fsync도 선택: 없으면 기록할 것이 없는 fd로 봄 */
 struct fd_ops {
     int (*read)(void *ctx, void *buf, size_t count);
     int (*write)(void *ctx, const void *buf, size_t count);
+    int (*readv)(void *ctx, const struct iovec *iov, int iovcnt);
+    int (*writev)(void *ctx, const struct iovec *iov, int iovcnt);
+    int (*fsync)(void *ctx);
     int (*poll)(void *ctx);  /* FD_READABLE/FD_WRITABLE 등의 플래그 반환 */
     void (*close)(void *ctx);
 };
@@ -52,6 +66,20 @@ struct fd *fd_get(int fd_num);
 /* 파일 디스크립터 닫기 */
 int fd_close(int fd_num);
 
+/* 읽기/쓰기 (전송한 바이트 수, 잘못된 fd면 -1) */
+int fd_read(int fd_num, void *buf, size_t count);
+int fd_write(int fd_num, const void *buf, size_t count);
+
+/* 여러 조각을 호출 한 번으로 읽기/쓰기 (조각은 순서대로 채움, 최대 FD_IOV_MAX개) */
+int fd_readv(int fd_num, const struct iovec *iov, int iovcnt);
+int fd_writev(int fd_num, const struct iovec *iov, int iovcnt);
+
+/* 쓴 내용을 장치까지 기록 (성공 0, 실패 -1) */
+int fd_fsync(int fd_num);
+
+/* 조각들의 전체 길이 */
+size_t iov_length(const struct iovec *iov, int iovcnt);
+
 /* 이벤트에 대해 파일 디스크립터 폴링 */
 int fd_poll(int fd_num);
 
@@ -0,0 +1,765 @@
+#include "inode.h"
+#include "bitmap.h"
+#include "pagecache.h"
+#include "journal.h"
+#include "crc32c.h"
+#include "kernel.h"
+#include "string.h"
+
+// 디스크 볼륨: 슈퍼블록, 비트맵, i-node 테이블, B-트리 노드를 장치에 기록하고 다시 읽음
+// 메모리의 B-트리(이름 색인, 디렉터리, 익스텐트 B-트리)는 지난 커밋 뒤에 바뀐 것만 새 노드 블록에
+// 기록하고, 예전 노드 블록은 새 위치를 기록한 뒤에 해제함
+// 제자리에 덮어쓰는 메타데이터(i-node 테이블, 비트맵, 슈퍼블록)는 저널을 거쳐 기록하고,
+// 새 노드 블록은 어디에서도 가리키지 않으므로 바로 기록함
+
+_Static_assert(sizeof(struct disk_inode) == FS_DISK_INODE_SIZE, "disk_inode size");
+_Static_assert(sizeof(struct disk_btree_node) <= FS_BLOCK_SIZE, "disk_btree_node size");
+_Static_assert(FS_BTREE_MAX_KEYS == BTREE_MAX_KEYS, "on-disk B-Tree order");
+_Static_assert(FS_DISK_INODES == MAX_INODE_COUNT, "i-node table size");
+_Static_assert(sizeof(struct inode_extent) * INODE_INLINE_EXTENTS <= INODE_MAP_WORDS * 4, "inline extents");
+_Static_assert(FS_DISK_BLOCK_SIZE == FS_BLOCK_SIZE && FS_BLOCK_SIZE == BLKDEV_BLOCK_SIZE, "block size");
+
+// 볼륨 배치 계산
+static void fs_layout(struct fs_superblock *sb, uint32_t total_blocks) {
+    memset(sb, 0, sizeof(*sb));
+    sb->magic = FS_MAGIC;
+    sb->version = FS_VERSION;
+    sb->block_size = FS_DISK_BLOCK_SIZE;
+    sb->total_blocks = total_blocks;
+    sb->inode_count = FS_DISK_INODES;
+    sb->block_bitmap_start = FS_BLOCK_BITMAP_START;
+    sb->block_bitmap_blocks = FS_BITMAP_BLOCKS(total_blocks);
+    sb->inode_bitmap_start = FS_INODE_BITMAP_START(total_blocks);
+    sb->inode_bitmap_blocks = FS_BITMAP_BLOCKS(FS_DISK_INODES);
+    sb->inode_table_start = FS_INODE_TABLE_START(total_blocks);
+    sb->inode_table_blocks = FS_INODE_TABLE_BLOCKS;
+    sb->journal_start = FS_JOURNAL_START(total_blocks);
+    sb->journal_blocks = FS_JOURNAL_BLOCKS(total_blocks);
+    sb->journal_seq = 1;
+    sb->features = FS_FEATURE_CSUM;
+    sb->csum_start = FS_CSUM_START(total_blocks);
+    sb->csum_blocks = FS_CSUM_BLOCKS(total_blocks);
+    sb->data_start = FS_DATA_START(total_blocks);
+}
+
+// 마운트된 볼륨 (flusher가 오래된 트랜잭션을 커밋할 때 사용)
+#define FS_MAX_MOUNTS 4
+static struct btree_filesystem *mounted[FS_MAX_MOUNTS];
+
+static void fs_register(struct btree_filesystem *fs, int add) {
+    for (int i = 0; i < FS_MAX_MOUNTS; i++) {
+        if (add ? mounted[i] == NULL : mounted[i] == fs) {
+            mounted[i] = add ? fs : NULL;
+            return;
+        }
+    }
+}
+
+// 메모리 상태 준비 (비트맵과 그룹 카운터는 볼륨 크기에 맞춰 할당)
+static int fs_setup(struct btree_filesystem *fs, struct block_device *dev) {
+    if (page_cache_init() < 0) {
+        return -1;
+    }
+    btree_init(&fs->inode_tree);
+    btree_init(&fs->name_tree);
+    fs->name_tree_dirty = 0;
+    dcache_init(&fs->dcache);
+    fs->dev = dev;
+
+    // Whole bitmap blocks, so they can be read and written in place
+    fs->block_bitmap = (uint32_t *)kmalloc(fs->sb.block_bitmap_blocks * FS_BLOCK_SIZE);
+    fs->group_count = (fs->sb.total_blocks + BLOCKS_PER_GROUP - 1) / BLOCKS_PER_GROUP;
+    fs->group_free = (int *)kmalloc(fs->group_count * sizeof(int));
+    if (!fs->block_bitmap || !fs->group_free) {
+        kfree(fs->block_bitmap);
+        kfree(fs->group_free);
+        return -1;
+    }
+    bitmap_init(fs->block_bitmap, fs->sb.block_bitmap_blocks * FS_BITS_PER_BLOCK);
+    bitmap_init(fs->inode_bitmap, MAX_INODE_COUNT);
+    if (journal_init(fs) < 0) {
+        kfree(fs->block_bitmap);
+        kfree(fs->group_free);
+        return -1;
+    }
+
+    // Checksum table, loaded whole like the bitmaps
+    fs->csum = NULL;
+    fs->csum_home = NULL;
+    fs->csum_dirty = NULL;
+    fs->csum_errors = 0;
+    if (fs->sb.features & FS_FEATURE_CSUM) {
+        fs->csum = (uint32_t *)kmalloc(fs->sb.csum_blocks * FS_BLOCK_SIZE);
+        fs->csum_home = (uint32_t *)kmalloc(fs->sb.csum_blocks * FS_BLOCK_SIZE);
+        fs->csum_dirty = (uint32_t *)kmalloc((fs->sb.csum_blocks + 31) / 32 * 4);
+        if (!fs->csum || !fs->csum_home || !fs->csum_dirty) {
+            kfree(fs->csum);
+            kfree(fs->csum_home);
+            kfree(fs->csum_dirty);
+            journal_destroy(fs);
+            kfree(fs->block_bitmap);
+            kfree(fs->group_free);
+            return -1;
+        }
+        memset(fs->csum, 0, fs->sb.csum_blocks * FS_BLOCK_SIZE);
+        memset(fs->csum_home, 0, fs->sb.csum_blocks * FS_BLOCK_SIZE);
+        bitmap_init(fs->csum_dirty, fs->sb.csum_blocks);
+    }
+
+    memset(&fs->compress, 0, sizeof(fs->compress));
+
+    for (int i = 0; i < MAX_INODE_COUNT; i++) {
+        fs->inodes[i].in_use = 0;
+        fs->inodes[i].mmaps = 0;
+        fs->inodes[i].inode_num = i;
+        radix_tree_init(&fs->inodes[i].page_tree);
+    }
+
+    fs->total_inodes = MAX_INODE_COUNT;
+    fs->free_inodes = MAX_INODE_COUNT;
+    fs->total_blocks = fs->sb.total_blocks;
+    fs->alloc_cursor = fs->sb.data_start;
+    fs->default_inode_flags = INODE_FLAG_EXTENTS | INODE_FLAG_INLINE;
+    fs_register(fs, 1);
+    return 0;
+}
+
+// 비트맵에서 빈 블록 수와 그룹별 카운터 다시 계산
+static void fs_count_free(struct btree_filesystem *fs) {
+    fs->free_blocks = 0;
+    for (int g = 0; g < fs->group_count; g++) {
+        int start = g * BLOCKS_PER_GROUP;
+        int end = start + BLOCKS_PER_GROUP < fs->total_blocks ? start + BLOCKS_PER_GROUP : fs->total_blocks;
+        int free = 0;
+        int pos = start;
+        while ((pos = bitmap_find_zero(fs->block_bitmap, pos, end)) >= 0) {
+            int used = bitmap_find_set(fs->block_bitmap, pos, end);
+            free += used - pos;
+            pos = used;
+        }
+        fs->group_free[g] = free;
+        fs->free_blocks += free;
+    }
+}
+
+// B-트리 값 인코딩/디코딩
+static void encode_name_value(void *value, uint32_t *out) {
+    out[0] = ((struct inode *)value)->inode_num;
+}
+
+static void *decode_name_value(struct btree_filesystem *fs, const uint32_t *in) {
+    if (in[0] >= MAX_INODE_COUNT || !fs->inodes[in[0]].in_use) {
+        return NULL;
+    }
+    return &fs->inodes[in[0]];
+}
+
+static void encode_extent_value(void *value, uint32_t *out) {
+    struct inode_extent *ext = (struct inode_extent *)value;
+    out[0] = ext->logical;
+    out[1] = ext->start;
+    out[2] = ext->length;
+    out[3] = ext->stored;
+}
+
+static void *decode_extent_value(struct btree_filesystem *fs, const uint32_t *in) {
+    (void)fs;
+    struct inode_extent *ext = (struct inode_extent *)kmalloc(sizeof(struct inode_extent));
+    if (ext) {
+        ext->logical = in[0];
+        ext->start = in[1];
+        ext->length = in[2];
+        ext->stored = in[3];
+    }
+    return ext;
+}
+
+// 디스크 B-트리의 노드 블록 해제
+static void fs_free_tree(struct btree_filesystem *fs, uint32_t block_num) {
+    uint8_t block[FS_BLOCK_SIZE];
+    struct disk_btree_node *dn = (struct disk_btree_node *)block;
+
+    if (block_num == 0 || block_read(fs, block_num, 1, block) < 0 || dn->magic != FS_BTREE_NODE_MAGIC) {
+        return;
+    }
+    if (!dn->is_leaf) {
+        for (uint32_t i = 0; i <= dn->num_keys && i <= FS_BTREE_MAX_KEYS; i++) {
+            fs_free_tree(fs, dn->children[i]);
+        }
+    }
+    block_free(fs, block_num);
+}
+
+// 노드를 자식부터 블록에 기록하고 블록 번호 반환 (실패하면 0, 이미 기록한 블록은 해제)
+static uint32_t fs_store_node(struct btree_filesystem *fs, struct btree_node *node,
+                              void (*encode)(void *value, uint32_t *out)) {
+    uint8_t block[FS_BLOCK_SIZE];
+    struct disk_btree_node *dn = (struct disk_btree_node *)block;
+    memset(block, 0, FS_BLOCK_SIZE);
+
+    dn->magic = FS_BTREE_NODE_MAGIC;
+    dn->num_keys = node->num_keys;
+    dn->is_leaf = node->is_leaf;
+    for (int i = 0; i < node->num_keys; i++) {
+        dn->keys[i] = node->keys[i];
+        encode(node->values[i], dn->values[i]);
+    }
+    int stored = 0;
+    if (!node->is_leaf) {
+        for (; stored <= node->num_keys; stored++) {
+            dn->children[stored] = fs_store_node(fs, node->children[stored], encode);
+            if (dn->children[stored] == 0) {
+                break;
+            }
+        }
+    }
+
+    uint32_t block_num = 0;
+    if (node->is_leaf || stored > node->num_keys) {
+        block_num = block_alloc(fs);
+        if (block_num != 0 && block_write(fs, block_num, 1, block) == 0) {
+            return block_num;
+        }
+    }
+
+    // Nothing points at this subtree yet, so its blocks are free again right away
+    block_free(fs, block_num);
+    for (int i = 0; !node->is_leaf && i < stored; i++) {
+        fs_free_tree(fs, dn->children[i]);
+    }
+    return 0;
+}
+
+static uint32_t fs_store_tree(struct btree_filesystem *fs, struct btree *tree,
+                              void (*encode)(void *value, uint32_t *out)) {
+    spin_lock(&tree->writer_lock);
+    uint32_t root = 0;
+    if (tree->root && tree->root->num_keys > 0) {
+        root = fs_store_node(fs, tree->root, encode);
+    }
+    spin_unlock(&tree->writer_lock);
+    return root;
+}
+
+// 디스크 노드의 항목을 모두 tree에 삽입
+static int fs_load_node(struct btree_filesystem *fs, uint32_t block_num, struct btree *tree,
+                        void *(*decode)(struct btree_filesystem *fs, const uint32_t *in)) {
+    uint8_t block[FS_BLOCK_SIZE];
+    struct disk_btree_node *dn = (struct disk_btree_node *)block;
+
+    if (block_read(fs, block_num, 1, block) < 0 || dn->magic != FS_BTREE_NODE_MAGIC ||
+        dn->num_keys > FS_BTREE_MAX_KEYS) {
+        printf("Error: Bad B-Tree node at block %u\n", block_num);
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < dn->num_keys; i++) {
+        void *value = decode(fs, dn->values[i]);
+        if (!value || btree_insert(tree, dn->keys[i], value) < 0) {
+            return -1;
+        }
+    }
+    if (!dn->is_leaf) {
+        for (uint32_t i = 0; i <= dn->num_keys; i++) {
+            if (fs_load_node(fs, dn->children[i], tree, decode) < 0) {
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+static void extent_value_free(uint32_t key, void *value) {
+    (void)key;
+    kfree(value);
+}
+
+// 메모리의 익스텐트 B-트리 해제 (디스크 블록은 그대로 둠)
+static void fs_release_extent_tree(struct inode *inode) {
+    btree_traverse(inode->extent_tree, extent_value_free);
+    btree_destroy(inode->extent_tree);
+    kfree(inode->extent_tree);
+    inode->extent_tree = NULL;
+}
+
+static int fs_write_superblock(struct btree_filesystem *fs) {
+    uint8_t block[FS_BLOCK_SIZE];
+    memset(block, 0, FS_BLOCK_SIZE);
+
+    fs->sb.free_blocks = fs->free_blocks;
+    fs->sb.free_inodes = fs->free_inodes;
+    struct fs_superblock *sb = (struct fs_superblock *)block;
+    *sb = fs->sb;
+    return block_write(fs, 0, 1, block);
+}
+
+// 새 볼륨 생성 (장치의 기존 내용은 무시)
+int inode_fs_format(struct btree_filesystem *fs, struct block_device *dev) {
+    fs_layout(&fs->sb, dev->block_count);
+    if (fs->sb.data_start >= fs->sb.total_blocks) {
+        printf("Error: %s is too small for a filesystem (%u blocks)\n", dev->name, dev->block_count);
+        return -1;
+    }
+    if (fs_setup(fs, dev) < 0) {
+        return -1;
+    }
+
+    // Superblock, bitmaps and the i-node table are never handed out
+    bitmap_set_range(fs->block_bitmap, 0, fs->sb.data_start);
+    fs_count_free(fs);
+
+    // Empty i-node table, so sync finds no old extent trees to free, and no
+    // descriptor left over from an earlier volume at the head of the journal
+    uint8_t zero[FS_BLOCK_SIZE];
+    memset(zero, 0, FS_BLOCK_SIZE);
+    for (uint32_t b = 0; b < fs->sb.inode_table_blocks; b++) {
+        if (block_write(fs, fs->sb.inode_table_start + b, 1, zero) < 0) {
+            return -1;
+        }
+    }
+    if (block_write(fs, fs->sb.journal_start, 1, zero) < 0) {
+        return -1;
+    }
+    for (uint32_t b = 0; fs->csum && b < fs->sb.csum_blocks; b++) {
+        if (block_write(fs, fs->sb.csum_start + b, 1, zero) < 0) {
+            return -1;
+        }
+    }
+
+    return inode_fs_sync(fs);
+}
+
+// 디스크에서 볼륨 읽기
+int inode_fs_mount(struct btree_filesystem *fs, struct block_device *dev) {
+    uint8_t block[FS_BLOCK_SIZE];
+    struct fs_superblock *sb = (struct fs_superblock *)block;
+
+    if (blkdev_read(dev, 0, 1, block) < 0) {
+        return -1;
+    }
+    if (sb->magic != FS_MAGIC || sb->version != FS_VERSION) {
+        printf("Error: %s has no filesystem (run mkfs)\n", dev->name);
+        return -1;
+    }
+    if (sb->block_size != FS_BLOCK_SIZE || sb->inode_count != MAX_INODE_COUNT ||
+        sb->total_blocks > dev->block_count || sb->data_start >= sb->total_blocks ||
+        sb->journal_blocks < 2 || sb->journal_start + sb->journal_blocks > sb->data_start ||
+        ((sb->features & FS_FEATURE_CSUM) &&
+         (sb->csum_blocks < FS_CSUM_BLOCKS(sb->total_blocks) || sb->csum_start + sb->csum_blocks > sb->data_start))) {
+        printf("Error: %s: unsupported filesystem layout\n", dev->name);
+        return -1;
+    }
+
+    // Finish a transaction that committed but did not reach its home blocks
+    int replayed = journal_replay(dev, sb);
+    if (replayed < 0 || (replayed > 0 && blkdev_read(dev, 0, 1, block) < 0)) {
+        return -1;
+    }
+
+    fs->sb = *sb;
+    if (fs_setup(fs, dev) < 0) {
+        return -1;
+    }
+
+    // Bitmaps
+    if (block_read(fs, fs->sb.block_bitmap_start, fs->sb.block_bitmap_blocks, fs->block_bitmap) < 0 ||
+        block_read(fs, fs->sb.inode_bitmap_start, 1, block) < 0) {
+        return -1;
+    }
+    uint32_t *words = (uint32_t *)block;
+    for (int i = 0; i < MAX_INODE_COUNT / 32; i++) {
+        fs->inode_bitmap[i] = words[i];
+    }
+    fs_count_free(fs);
+
+    // Checksums, before any tree node is read
+    if (fs->csum) {
+        if (block_read(fs, fs->sb.csum_start, fs->sb.csum_blocks, fs->csum) < 0) {
+            return -1;
+        }
+        memcpy(fs->csum_home, fs->csum, fs->sb.csum_blocks * FS_BLOCK_SIZE);
+    }
+
+    // I-node table
+    for (uint32_t b = 0; b < fs->sb.inode_table_blocks; b++) {
+        if (block_read(fs, fs->sb.inode_table_start + b, 1, block) < 0) {
+            return -1;
+        }
+        struct disk_inode *dinodes = (struct disk_inode *)block;
+
+        for (uint32_t i = 0; i < FS_INODES_PER_BLOCK; i++) {
+            struct disk_inode *d = &dinodes[i];
+            struct inode *inode = &fs->inodes[b * FS_INODES_PER_BLOCK + i];
+            if (d->type == INODE_TYPE_FREE) {
+                continue;
+            }
+
+            inode->type = d->type;
+            inode->size = d->size;
+            inode->permissions = d->permissions;
+            inode->link_count = d->link_count;
+            inode->block_count = d->block_count;
+            inode->flags = d->flags;
+            inode->extent_count = d->extent_count;
+            for (int w = 0; w < INODE_MAP_WORDS; w++) {
+                inode->map_words[w] = d->map[w];
+            }
+            inode->created_time = d->created_time;
+            inode->modified_time = d->modified_time;
+            inode->accessed_time = d->accessed_time;
+            inode->in_use = 1;
+            inode->tree_dirty = 0;
+
+            if (inode->flags & INODE_FLAG_EXTENT_TREE) {
+                uint32_t root = d->map[0];
+                inode->extent_tree = (struct btree *)kmalloc(sizeof(struct btree));
+                if (!inode->extent_tree) {
+                    return -1;
+                }
+                btree_init(inode->extent_tree);
+                if (fs_load_node(fs, root, inode->extent_tree, decode_extent_value) < 0) {
+                    return -1;
+                }
+            }
+
+            btree_insert(&fs->inode_tree, inode->inode_num, inode);
+            fs->free_inodes--;
+        }
+    }
+
+    // Directory entries, once every i-node they can name is in use
+    for (int i = 0; i < MAX_INODE_COUNT; i++) {
+        struct inode *inode = &fs->inodes[i];
+        if (!inode->in_use || inode->type != INODE_TYPE_DIR) {
+            continue;
+        }
+        uint32_t root = inode->map_words[0];
+        inode->entries = (struct btree *)kmalloc(sizeof(struct btree));
+        if (!inode->entries) {
+            return -1;
+        }
+        btree_init(inode->entries);
+        if (root && fs_load_node(fs, root, inode->entries, decode_name_value) < 0) {
+            return -1;
+        }
+    }
+
+    // Filename index (root directory)
+    if (fs->sb.name_index_root &&
+        fs_load_node(fs, fs->sb.name_index_root, &fs->name_tree, decode_name_value) < 0) {
+        return -1;
+    }
+
+    fs->sb.mount_count++;
+    if (fs_write_superblock(fs) < 0) {
+        return -1;
+    }
+
+    printf("Mounted %s: %d/%d blocks free, %d/%d i-nodes free (mount #%u)\n",
+           dev->name, fs->free_blocks, fs->total_blocks, fs->free_inodes, fs->total_inodes,
+           fs->sb.mount_count);
+    return 0;
+}
+
+// 메타데이터 블록을 트랜잭션에 기록 (저널에 자리가 없으면 실패, 제자리에는 절대 쓰지 않음)
+// 간접 블록 테이블은 커밋이 기록할 블록만큼 자리를 남기고 미리 커밋하므로 여기서는 실패하지 않아야 함
+static int fs_log_block(struct btree_filesystem *fs, uint32_t block_num, const void *buf) {
+    if (journal_write(fs, block_num, buf) < 0) {
+        printf("Error: Transaction does not fit the journal (block %u)\n", block_num);
+        return -1;
+    }
+    return 0;
+}
+
+// home과 내용이 다를 때만 기록
+static int fs_log_changed(struct btree_filesystem *fs, uint32_t block_num, const void *buf) {
+    uint8_t home[FS_BLOCK_SIZE];
+    if (journal_read(fs, block_num, home) < 0) {
+        return -1;
+    }
+    const uint8_t *data = (const uint8_t *)buf;
+    for (uint32_t i = 0; i < FS_BLOCK_SIZE; i++) {
+        if (home[i] != data[i]) {
+            return fs_log_block(fs, block_num, buf);
+        }
+    }
+    return 0;
+}
+
+// 메모리의 메타데이터(이름 색인, 디렉터리, i-node 테이블, 비트맵, 슈퍼블록)를 트랜잭션 하나로 커밋
+// B-트리는 지난 커밋 뒤에 바뀐 것만 새 블록에 다시 기록하고, 나머지는 디스크의 트리를 그대로 가리킴
+static int fs_write_metadata(struct btree_filesystem *fs) {
+    uint8_t block[FS_BLOCK_SIZE];
+
+    // Filename index
+    if (fs->name_tree_dirty) {
+        uint32_t old_root = fs->sb.name_index_root;
+        uint32_t new_root = fs_store_tree(fs, &fs->name_tree, encode_name_value);
+        if (new_root == 0 && fs->name_tree.root && fs->name_tree.root->num_keys > 0) {
+            printf("Error: Failed to write filename index\n");
+            return -1;
+        }
+        fs->sb.name_index_root = new_root;
+        fs->name_tree_dirty = 0;
+        fs_free_tree(fs, old_root);
+    }
+
+    // I-node table
+    for (uint32_t b = 0; b < fs->sb.inode_table_blocks; b++) {
+        if (journal_read(fs, fs->sb.inode_table_start + b, block) < 0) {
+            return -1;
+        }
+        struct disk_inode *dinodes = (struct disk_inode *)block;
+
+        uint32_t old_trees[FS_INODES_PER_BLOCK];
+        for (uint32_t i = 0; i < FS_INODES_PER_BLOCK; i++) {
+            struct disk_inode *d = &dinodes[i];
+            struct inode *inode = &fs->inodes[b * FS_INODES_PER_BLOCK + i];
+
+            old_trees[i] = d->type == INODE_TYPE_DIR || (d->type != INODE_TYPE_FREE && (d->flags & INODE_FLAG_EXTENT_TREE))
+                               ? d->map[0] : 0;
+            memset(d, 0, sizeof(*d));
+            if (!inode->in_use) {
+                continue;
+            }
+
+            d->type = inode->type;
+            d->size = inode->size;
+            d->permissions = inode->permissions;
+            d->link_count = inode->link_count;
+            d->block_count = inode->block_count;
+            d->flags = inode->flags;
+            d->extent_count = inode->extent_count;
+            d->created_time = inode->created_time;
+            d->modified_time = inode->modified_time;
+            d->accessed_time = inode->accessed_time;
+
+            if (!inode->tree_dirty && (inode->type == INODE_TYPE_DIR || (inode->flags & INODE_FLAG_EXTENT_TREE))) {
+                // Unchanged since the last commit: keep pointing at the tree on disk
+                d->map[0] = old_trees[i];
+                old_trees[i] = 0;
+                if (inode->type == INODE_TYPE_DIR) {
+                    d->map[1] = inode->parent;
+                }
+            } else if (inode->type == INODE_TYPE_DIR) {
+                // An empty directory stores no tree
+                d->map[0] = fs_store_tree(fs, inode->entries, encode_name_value);
+                if (d->map[0] == 0 && inode->size > 0) {
+                    printf("Error: Failed to write directory i-node %u\n", inode->inode_num);
+                    return -1;
+                }
+                d->map[1] = inode->parent;
+            } else if (inode->flags & INODE_FLAG_EXTENT_TREE) {
+                d->map[0] = fs_store_tree(fs, inode->extent_tree, encode_extent_value);
+                if (d->map[0] == 0) {
+                    printf("Error: Failed to write extent tree of i-node %u\n", inode->inode_num);
+                    return -1;
+                }
+            } else {
+                for (int w = 0; w < INODE_MAP_WORDS; w++) {
+                    d->map[w] = inode->map_words[w];
+                }
+            }
+        }
+
+        if (fs_log_changed(fs, fs->sb.inode_table_start + b, block) < 0) {
+            return -1;
+        }
+        // Only now does the transaction hold the new roots
+        for (uint32_t i = 0; i < FS_INODES_PER_BLOCK; i++) {
+            fs->inodes[b * FS_INODES_PER_BLOCK + i].tree_dirty = 0;
+            fs_free_tree(fs, old_trees[i]);
+        }
+    }
+
+    // Bitmaps go last so they include the node blocks allocated and freed above.
+    // Blocks freed during the transaction become free in the bitmap it commits
+    journal_release_freed(fs);
+    fs_count_free(fs);
+    for (uint32_t b = 0; b < fs->sb.block_bitmap_blocks; b++) {
+        if (fs_log_changed(fs, fs->sb.block_bitmap_start + b, fs->block_bitmap + b * FS_BLOCK_SIZE / 4) < 0) {
+            return -1;
+        }
+    }
+    memset(block, 0, FS_BLOCK_SIZE);
+    uint32_t *words = (uint32_t *)block;
+    for (int i = 0; i < MAX_INODE_COUNT / 32; i++) {
+        words[i] = fs->inode_bitmap[i];
+    }
+    if (fs_log_changed(fs, fs->sb.inode_bitmap_start, block) < 0) {
+        return -1;
+    }
+    for (uint32_t b = 0; fs->csum && b < fs->sb.csum_blocks; b++) {
+        if (bitmap_test(fs->csum_dirty, b) &&
+            fs_log_block(fs, fs->sb.csum_start + b, fs->csum + b * FS_CSUM_PER_BLOCK) < 0) {
+            return -1;
+        }
+    }
+
+    // The superblock names the next transaction, so once it is home this one is done
+    fs->sb.free_blocks = fs->free_blocks;
+    fs->sb.free_inodes = fs->free_inodes;
+    fs->sb.journal_seq = fs->journal.seq + 1;
+    memset(block, 0, FS_BLOCK_SIZE);
+    *(struct fs_superblock *)block = fs->sb;
+    if (fs_log_block(fs, 0, block) < 0 || journal_commit(fs) < 0) {
+        fs->sb.journal_seq = fs->journal.seq;
+        return -1;
+    }
+
+    // The logged checksum blocks are home now
+    for (uint32_t b = 0; fs->csum && b < fs->sb.csum_blocks; b++) {
+        if (bitmap_test(fs->csum_dirty, b)) {
+            memcpy(fs->csum_home + b * FS_CSUM_PER_BLOCK, fs->csum + b * FS_CSUM_PER_BLOCK, FS_BLOCK_SIZE);
+            bitmap_clear(fs->csum_dirty, b);
+        }
+    }
+    return 0;
+}
+
+// 커밋된 메타데이터가 가리키는 블록을 제자리에 덮어쓰기 전에, 디스크의 체크섬을 0(검증 안 됨)으로 기록
+// 새 체크섬은 다음 커밋에야 디스크에 닿으므로, 그 사이에 전원이 꺼져도 마운트 뒤 읽기는 블록을
+// 받아들이고 체크섬을 다시 계산함. 이번 트랜잭션에서 할당한 블록은 아무도 가리키지 않으므로 건너뜀
+int block_csum_unverify(struct btree_filesystem *fs, uint32_t block_num, uint32_t count) {
+    if (!fs->csum) {
+        return 0;
+    }
+    uint32_t first = 0xFFFFFFFF;
+    uint32_t last = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t b = block_num + i;
+        if (b < fs->sb.data_start || b >= fs->sb.total_blocks || fs->csum_home[b] == 0 ||
+            bitmap_test(fs->journal.new_blocks, b)) {
+            continue;
+        }
+        fs->csum_home[b] = 0;
+        if (first == 0xFFFFFFFF) {
+            first = b / FS_CSUM_PER_BLOCK;
+        }
+        last = b / FS_CSUM_PER_BLOCK;
+    }
+    if (first == 0xFFFFFFFF) {
+        return 0;
+    }
+
+    // Stable before the data it covers is overwritten
+    if (blkdev_write(fs->dev, fs->sb.csum_start + first, last - first + 1,
+                     fs->csum_home + first * FS_CSUM_PER_BLOCK) < 0) {
+        return -1;
+    }
+    return blkdev_flush(fs->dev);
+}
+
+// 데이터 영역 블록의 체크섬 갱신: 표는 메모리에서 바뀌고 다음 커밋에 저널을 거쳐 기록됨
+void block_csum_set(struct btree_filesystem *fs, uint32_t block_num, uint32_t count, const void *buf) {
+    if (!fs->csum) {
+        return;
+    }
+    const uint8_t *data = (const uint8_t *)buf;
+    for (uint32_t i = 0; i < count; i++, data += FS_BLOCK_SIZE) {
+        uint32_t b = block_num + i;
+        if (b < fs->sb.data_start || b >= fs->sb.total_blocks) {
+            continue;
+        }
+        fs->csum[b] = crc32c(0, data, FS_BLOCK_SIZE);
+        if (!bitmap_test(fs->csum_dirty, b / FS_CSUM_PER_BLOCK)) {
+            bitmap_set(fs->csum_dirty, b / FS_CSUM_PER_BLOCK);
+            journal_note_op(fs);
+        }
+    }
+}
+
+int block_csum_check(struct btree_filesystem *fs, uint32_t block_num, uint32_t count, const void *buf) {
+    if (!fs->csum) {
+        return 0;
+    }
+    const uint8_t *data = (const uint8_t *)buf;
+    int result = 0;
+    for (uint32_t i = 0; i < count; i++, data += FS_BLOCK_SIZE) {
+        uint32_t b = block_num + i;
+        if (b < fs->sb.data_start || b >= fs->sb.total_blocks) {
+            continue;
+        }
+        uint32_t crc = crc32c(0, data, FS_BLOCK_SIZE);
+        if (fs->csum[b] == 0) {
+            // Overwritten in place before a crash: accept it and commit the checksum it has now
+            if (crc != 0) {
+                fs->csum[b] = crc;
+                if (!bitmap_test(fs->csum_dirty, b / FS_CSUM_PER_BLOCK)) {
+                    bitmap_set(fs->csum_dirty, b / FS_CSUM_PER_BLOCK);
+                    journal_note_op(fs);
+                }
+            }
+        } else if (crc != fs->csum[b]) {
+            printf("Error: %s: checksum mismatch in block %u\n", fs->dev->name, b);
+            fs->csum_errors++;
+            result = -1;
+        }
+    }
+    return result;
+}
+
+// 더티 페이지를 기록하고 실행 중인 트랜잭션을 커밋
+int inode_fs_sync(struct btree_filesystem *fs) {
+    // File data first, so the metadata committed below never points at stale blocks
+    if (page_cache_flush(fs, NULL) < 0 || fs_write_metadata(fs) < 0) {
+        return -1;
+    }
+    return blkdev_flush(fs->dev);
+}
+
+// 파일 하나의 데이터를 기록하고, 기다리는 메타데이터 변경이 있으면 트랜잭션을 커밋
+// 커밋에는 다른 연산의 변경도 함께 실리므로 그 데이터도 먼저 기록함
+int inode_fsync(struct btree_filesystem *fs, struct inode *inode) {
+    if (page_cache_flush(fs, inode) < 0) {
+        return -1;
+    }
+    if (fs->journal.ops > 0) {
+        return inode_fs_sync(fs);
+    }
+    return blkdev_flush(fs->dev);
+}
+
+// 백그라운드 flusher: 데이터 write-back 후, 오래되었거나 연산이 많이 쌓인 트랜잭션 커밋
+void inode_fs_flusher(void) {
+    page_cache_flusher();
+    for (int i = 0; i < FS_MAX_MOUNTS; i++) {
+        if (mounted[i] && journal_should_commit(mounted[i])) {
+            inode_fs_sync(mounted[i]);
+        }
+    }
+}
+
+// 동기화한 뒤 메모리 상태 해제 (장치는 호출자가 관리)
+void inode_fs_unmount(struct btree_filesystem *fs) {
+    inode_fs_sync(fs);
+    page_cache_drop_fs(fs);
+
+    for (int i = 0; i < MAX_INODE_COUNT; i++) {
+        struct inode *inode = &fs->inodes[i];
+        if (inode->in_use && inode->type == INODE_TYPE_DIR) {
+            btree_destroy(inode->entries);
+            kfree(inode->entries);
+            inode->entries = NULL;
+        } else if (inode->in_use && (inode->flags & INODE_FLAG_EXTENT_TREE)) {
+            fs_release_extent_tree(inode);
+        }
+        inode->in_use = 0;
+    }
+
+    btree_destroy(&fs->inode_tree);
+    btree_destroy(&fs->name_tree);
+    journal_destroy(fs);
+    fs_register(fs, 0);
+    kfree(fs->csum);
+    kfree(fs->csum_home);
+    kfree(fs->csum_dirty);
+    fs->csum = NULL;
+    fs->csum_home = NULL;
+    fs->csum_dirty = NULL;
+    kfree(fs->block_bitmap);
+    kfree(fs->group_free);
+    fs->block_bitmap = NULL;
+    fs->group_free = NULL;
+    fs->dev = NULL;
+}
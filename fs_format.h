@@ -0,0 +1,127 @@
+#pragma once
+
+// B-트리 파일시스템 디스크 형식 (커널과 호스트 mkfs 도구가 함께 사용)
+// uint32_t는 포함하는 쪽에서 정의해야 함 (커널은 kernel.h, 도구는 stdint.h)
+//
+// 블록 0            superblock
+// 블록 1..          블록 비트맵 (블록당 4096비트)
+// 그다음            i-node 비트맵
+// 그다음            i-node 테이블 (블록당 disk_inode 4개)
+// 그다음            메타데이터 저널
+// 그다음            블록 체크섬 표 (블록마다 CRC32C 하나, FS_FEATURE_CSUM일 때만 사용)
+// data_start..      데이터 블록, 간접 블록, B-트리 노드
+
+#define FS_MAGIC       0x53465442                // "BTFS"
+#define FS_VERSION     4
+#define FS_DISK_BLOCK_SIZE 512
+#define FS_DISK_INODES 256                       // i-node 테이블 크기 (MAX_INODE_COUNT와 같아야 함)
+
+#define FS_BITS_PER_BLOCK  (FS_DISK_BLOCK_SIZE * 8)
+#define FS_BITMAP_BLOCKS(bits) (((bits) + FS_BITS_PER_BLOCK - 1) / FS_BITS_PER_BLOCK)
+
+#define FS_DISK_INODE_SIZE     128
+#define FS_INODES_PER_BLOCK    (FS_DISK_BLOCK_SIZE / FS_DISK_INODE_SIZE)
+
+// 볼륨 배치 (total = 볼륨의 전체 블록 수)
+#define FS_BLOCK_BITMAP_START        1
+#define FS_INODE_BITMAP_START(total) (FS_BLOCK_BITMAP_START + FS_BITMAP_BLOCKS(total))
+#define FS_INODE_TABLE_START(total)  (FS_INODE_BITMAP_START(total) + FS_BITMAP_BLOCKS(FS_DISK_INODES))
+#define FS_INODE_TABLE_BLOCKS        (FS_DISK_INODES / FS_INODES_PER_BLOCK)
+#define FS_JOURNAL_START(total)      (FS_INODE_TABLE_START(total) + FS_INODE_TABLE_BLOCKS)
+#define FS_CSUM_PER_BLOCK            (FS_DISK_BLOCK_SIZE / 4)
+#define FS_CSUM_BLOCKS(total)        (((total) + FS_CSUM_PER_BLOCK - 1) / FS_CSUM_PER_BLOCK)
+#define FS_JOURNAL_BLOCKS(total)     (((total) / 16 < 80 ? 80 : (total) / 16 > 256 ? 256 : (total) / 16) + \
+                                      FS_BITMAP_BLOCKS(total) + FS_CSUM_BLOCKS(total))  // Room for every bitmap and checksum block too
+#define FS_CSUM_START(total)         (FS_JOURNAL_START(total) + FS_JOURNAL_BLOCKS(total))
+#define FS_DATA_START(total)         (FS_CSUM_START(total) + FS_CSUM_BLOCKS(total))
+
+// 기능 플래그 (superblock.features)
+#define FS_FEATURE_CSUM 0x1                      // Data-area blocks are verified against the checksum table
+
+// 슈퍼블록 (블록 0)
+struct fs_superblock {
+    uint32_t magic;                              // FS_MAGIC
+    uint32_t version;                            // FS_VERSION
+    uint32_t block_size;                         // FS_DISK_BLOCK_SIZE
+    uint32_t total_blocks;                       // Blocks in the volume
+    uint32_t inode_count;                        // Entries in the i-node table
+    uint32_t block_bitmap_start;                 // First block bitmap block
+    uint32_t block_bitmap_blocks;
+    uint32_t inode_bitmap_start;                 // First i-node bitmap block
+    uint32_t inode_bitmap_blocks;
+    uint32_t inode_table_start;                  // First i-node table block
+    uint32_t inode_table_blocks;
+    uint32_t data_start;                         // First block the allocator may hand out
+    uint32_t name_index_root;                    // Root node of the filename B-Tree (0 = empty)
+    uint32_t free_blocks;                        // Informational; recomputed from the bitmap on mount
+    uint32_t free_inodes;
+    uint32_t mount_count;                        // Number of times the volume was mounted
+    uint32_t journal_start;                      // First journal block
+    uint32_t journal_blocks;
+    uint32_t journal_seq;                        // Sequence number of the next transaction to commit
+    uint32_t features;                           // FS_FEATURE_*
+    uint32_t csum_start;                         // First checksum table block
+    uint32_t csum_blocks;
+};
+
+// 디스크 i-node (128바이트)
+// map은 메모리 i-node의 블록 매핑 공용체와 같은 내용이며,
+// 익스텐트가 B-트리로 넘어간 경우 map[0]이 그 B-트리의 루트 블록
+// 디렉터리는 map[0]이 항목 B-트리(이름 해시 -> i-node 번호)의 루트 블록, map[1]이 부모 디렉터리
+// INODE_FLAG_INLINE이면 map 전체(48바이트)가 파일 데이터
+struct disk_inode {
+    uint32_t type;                               // INODE_TYPE_* (0 = free)
+    uint32_t size;
+    uint32_t permissions;
+    uint32_t link_count;
+    uint32_t block_count;
+    uint32_t flags;
+    uint32_t extent_count;
+    uint32_t map[12];
+    uint32_t created_time;
+    uint32_t modified_time;
+    uint32_t accessed_time;
+    uint32_t reserved[10];
+};
+
+// 디스크 B-트리 노드 (블록 하나에 노드 하나, 차수는 BTREE_ORDER와 같음)
+// 값은 최대 4워드: 이름 색인은 i-node 번호, 익스텐트 B-트리는 익스텐트
+#define FS_BTREE_MAX_KEYS 4
+#define FS_BTREE_VALUE_WORDS 4
+#define FS_BTREE_NODE_MAGIC 0x45444f4e            // "NODE"
+
+struct disk_btree_node {
+    uint32_t magic;                              // FS_BTREE_NODE_MAGIC
+    uint32_t num_keys;
+    uint32_t is_leaf;
+    uint32_t keys[FS_BTREE_MAX_KEYS];
+    uint32_t values[FS_BTREE_MAX_KEYS][FS_BTREE_VALUE_WORDS];
+    uint32_t children[FS_BTREE_MAX_KEYS + 1];
+};
+
+// 메타데이터 저널: 트랜잭션 하나를 저널 영역 처음부터 기록
+// [디스크립터][블록 사본 최대 FS_JOURNAL_TAGS개][디스크립터][사본...]...[커밋]
+// 디스크립터는 뒤따르는 사본들이 돌아갈 블록 번호를, 커밋 블록은 전체 개수와 체크섬을 가짐
+// 슈퍼블록의 journal_seq와 번호가 같고 커밋 블록이 온전한 트랜잭션만 마운트할 때 재실행함
+#define FS_JOURNAL_MAGIC      0x4c4e524a         // "JRNL"
+#define FS_JOURNAL_DESCRIPTOR 1
+#define FS_JOURNAL_COMMIT     2
+
+struct journal_header {
+    uint32_t magic;                              // FS_JOURNAL_MAGIC
+    uint32_t type;                               // FS_JOURNAL_DESCRIPTOR or FS_JOURNAL_COMMIT
+    uint32_t seq;                                // Transaction sequence number
+    uint32_t count;                              // Tags in this descriptor / blocks in the transaction
+};
+
+#define FS_JOURNAL_TAGS (FS_DISK_BLOCK_SIZE / 4 - 4)  // Words left after the header
+
+struct journal_descriptor {
+    struct journal_header header;
+    uint32_t tags[FS_JOURNAL_TAGS];              // Home block of each following copy
+};
+
+struct journal_commit {
+    struct journal_header header;
+    uint32_t checksum;                           // Over the tags and every block copy
+};
@@ -1,106 +1,44 @@
 #include "inode.h"
 #include "btree.h"
 #include "kernel.h"
+#include "bitmap.h"
+#include "pagecache.h"
+#include "vfs.h"
+#include "string.h"
 
-// 파일명 검색을 위한 문자열 해싱 함수
-uint32_t hash_string(const char *str) {
+// 파일명 검색을 위한 문자열 해싱 함수 (경로 구성 요소처럼 NUL로 끝나지 않는 이름은 길이로)
+static uint32_t hash_name(const char *name, uint32_t len) {
     uint32_t hash = 5381;
-    int c;
 
-    while ((c = *str++)) {
-        hash = ((hash << 5) + hash) + c; // hash * 33 + c
+    for (uint32_t i = 0; i < len; i++) {
+        hash = ((hash << 5) + hash) + name[i]; // hash * 33 + c
     }
 
     return hash;
 }
 
-// 문자열 비교 헬퍼
-static int strcmp(const char *s1, const char *s2) {
-    while (*s1 && (*s1 == *s2)) {
-        s1++;
-        s2++;
-    }
-    return *(unsigned char *)s1 - *(unsigned char *)s2;
-}
-
-// 문자열 복사 헬퍼
-static void strcpy(char *dst, const char *src) {
-    while ((*dst++ = *src++));
-}
-
-// 문자열 길이 헬퍼
-static size_t strlen(const char *s) {
-    size_t len = 0;
-    while (s[len]) len++;
-    return len;
-}
-
-// Initialize bitmap
-static void bitmap_init(uint32_t *bitmap, int size) {
-    for (int i = 0; i < size; i++) {
-        bitmap[i] = 0;
-    }
-}
-
-// Set bit in bitmap
-static void bitmap_set(uint32_t *bitmap, int bit) {
-    bitmap[bit / 32] |= (1 << (bit % 32));
-}
-
-// Clear bit in bitmap
-static void bitmap_clear(uint32_t *bitmap, int bit) {
-    bitmap[bit / 32] &= ~(1 << (bit % 32));
-}
-
-// Test bit in bitmap
-static int bitmap_test(uint32_t *bitmap, int bit) {
-    return (bitmap[bit / 32] & (1 << (bit % 32))) != 0;
-}
-
-// Find first free bit in bitmap
-static int bitmap_find_free(uint32_t *bitmap, int max_bits) {
-    for (int i = 0; i < max_bits; i++) {
-        if (!bitmap_test(bitmap, i)) {
-            return i;
-        }
-    }
-    return -1;
+uint32_t hash_string(const char *str) {
+    return hash_name(str, strlen(str));
 }
 
-// 파일시스템 초기화
+// 파일시스템 초기화 (RAM 디스크에 새 볼륨 생성)
 void inode_fs_init(struct btree_filesystem *fs) {
-    // Initialize B-Trees
-    btree_init(&fs->inode_tree);
-    btree_init(&fs->name_tree);
-
-    // Allocate block storage
-    fs->block_storage = (uint8_t *)kmalloc(FS_BLOCK_SIZE * MAX_BLOCKS);
-    if (!fs->block_storage) {
+    struct block_device *dev = ramdisk_create(MAX_BLOCKS);
+    if (!dev) {
         PANIC("Failed to allocate block storage");
     }
 
-    // Initialize bitmaps
-    bitmap_init(fs->block_bitmap, MAX_BLOCKS / 32);
-    bitmap_init(fs->inode_bitmap, MAX_INODE_COUNT / 32);
-
-    // Initialize i-node table
-    for (int i = 0; i < MAX_INODE_COUNT; i++) {
-        fs->inodes[i].in_use = 0;
-        fs->inodes[i].inode_num = i;
+    if (inode_fs_format(fs, dev) < 0) {
+        PANIC("Failed to format ramdisk");
     }
 
-    fs->total_inodes = MAX_INODE_COUNT;
-    fs->free_inodes = MAX_INODE_COUNT;
-    fs->total_blocks = MAX_BLOCKS;
-    fs->free_blocks = MAX_BLOCKS;
-
     printf("B-Tree filesystem initialized: %d inodes, %d blocks\n",
            MAX_INODE_COUNT, MAX_BLOCKS);
 }
 
 // Allocate an i-node
 struct inode *inode_alloc(struct btree_filesystem *fs, uint32_t type) {
-    int inode_num = bitmap_find_free(fs->inode_bitmap, MAX_INODE_COUNT);
+    int inode_num = bitmap_find_zero(fs->inode_bitmap, 0, MAX_INODE_COUNT);
     if (inode_num < 0) {
         printf("Error: No free i-nodes available\n");
         return NULL;
@@ -116,7 +54,12 @@ struct inode *inode_alloc(struct btree_filesystem *fs, uint32_t type) {
     inode->permissions = PERM_READ | PERM_WRITE;
     inode->link_count = 1;
     inode->block_count = 0;
+    inode->flags = fs->default_inode_flags;
+    inode->extent_count = 0;
     inode->in_use = 1;
+    inode->mmaps = 0;
+    inode->opens = 0;
+    inode->tree_dirty = 1;
 
     for (int i = 0; i < DIRECT_BLOCKS; i++) {
         inode->direct_blocks[i] = 0;
@@ -124,26 +67,162 @@ struct inode *inode_alloc(struct btree_filesystem *fs, uint32_t type) {
     inode->indirect_block = 0;
     inode->double_indirect_block = 0;
 
+    // A directory maps names, not blocks
+    if (type == INODE_TYPE_DIR) {
+        inode->flags = 0;
+        inode->entries = (struct btree *)kmalloc(sizeof(struct btree));
+        if (!inode->entries) {
+            bitmap_clear(fs->inode_bitmap, inode_num);
+            inode->in_use = 0;
+            printf("Error: No memory for directory entries\n");
+            return NULL;
+        }
+        btree_init(inode->entries);
+        inode->parent = ROOT_DIR;
+    }
+
     // Add to B-Tree
     btree_insert(&fs->inode_tree, inode_num, inode);
 
     fs->free_inodes--;
+    journal_note_op(fs);
 
     return inode;
 }
 
-// Free an i-node
-void inode_free(struct btree_filesystem *fs, struct inode *inode) {
-    if (!inode || !inode->in_use) {
+// 간접 블록 테이블은 메타데이터이므로 트랜잭션을 거쳐 기록
+static int inode_write_table(struct btree_filesystem *fs, uint32_t block, const uint32_t *table) {
+    return journal_write(fs, block, table);
+}
+
+// 트랜잭션에 간접 블록 테이블 count개를 더 기록할 자리가 없는지 확인
+static int inode_tables_full(struct btree_filesystem *fs, uint32_t count) {
+    // The commit itself logs the i-node table, both bitmaps, checksums and the superblock
+    uint32_t reserved = fs->sb.inode_table_blocks + fs->sb.block_bitmap_blocks + fs->sb.csum_blocks + 2;
+    return journal_space(fs) < reserved + count;
+}
+
+// 자리가 모자라면 메모리 상태가 온전한 지금, 변경을 시작하기 전에 트랜잭션을 커밋
+static int inode_reserve_tables(struct btree_filesystem *fs, uint32_t count) {
+    return inode_tables_full(fs, count) ? inode_fs_sync(fs) : 0;
+}
+
+// 간접 블록 테이블을 table로 읽기 (alloc이면 없을 때 빈 테이블을 새로 할당)
+// 새 테이블은 아직 기록하지 않으므로, 호출한 쪽이 채운 뒤 기록하거나 inode_drop_tables로 되돌림
+static int inode_load_table(struct btree_filesystem *fs, uint32_t *slot, int alloc, uint32_t *table) {
+    if (*slot == 0) {
+        if (!alloc) {
+            return -1;
+        }
+        uint32_t block = block_alloc(fs);
+        if (block == 0) {
+            return -1;
+        }
+        *slot = block;
+        memset(table, 0, FS_BLOCK_SIZE);
+        return 0;
+    }
+    return journal_read(fs, *slot, table);
+}
+
+// 아무것도 넣지 못한 새 테이블 해제 (트랜잭션에 기록된 적이 없으므로 바로 빈 블록이 됨)
+static void inode_drop_tables(struct btree_filesystem *fs, uint32_t **slots, int count) {
+    while (count-- > 0) {
+        block_free(fs, *slots[count]);
+        *slots[count] = 0;
+    }
+}
+
+// Free every data block at or after first_block, plus indirect tables left empty
+static void inode_free_blocks(struct btree_filesystem *fs, struct inode *inode, uint32_t first_block) {
+    if (inode->flags & INODE_FLAG_EXTENTS) {
+        extent_truncate(fs, inode, first_block);
         return;
     }
 
-    // Free all blocks
-    for (int i = 0; i < DIRECT_BLOCKS && i < inode->block_count; i++) {
+    // Direct blocks
+    for (uint32_t i = first_block; i < DIRECT_BLOCKS; i++) {
         if (inode->direct_blocks[i] > 0) {
             block_free(fs, inode->direct_blocks[i]);
+            inode->direct_blocks[i] = 0;
+            inode->block_count--;
+        }
+    }
+
+    // Single indirect blocks
+    uint32_t table[PTRS_PER_BLOCK];
+    if (inode_reserve_tables(fs, 2) < 0) {
+        return;
+    }
+    if (inode_load_table(fs, &inode->indirect_block, 0, table) == 0) {
+        for (uint32_t i = 0; i < PTRS_PER_BLOCK; i++) {
+            if (DIRECT_BLOCKS + i >= first_block && table[i] > 0) {
+                block_free(fs, table[i]);
+                table[i] = 0;
+                inode->block_count--;
+            }
+        }
+        if (first_block <= DIRECT_BLOCKS) {
+            block_free(fs, inode->indirect_block);
+            inode->indirect_block = 0;
+        } else {
+            inode_write_table(fs, inode->indirect_block, table);
+        }
+    }
+
+    // Double indirect blocks
+    uint32_t l1[PTRS_PER_BLOCK];
+    if (inode_load_table(fs, &inode->double_indirect_block, 0, l1) == 0) {
+        for (uint32_t j = 0; j < PTRS_PER_BLOCK; j++) {
+            uint32_t base = INDIRECT_LIMIT + j * PTRS_PER_BLOCK;
+            if (base + PTRS_PER_BLOCK <= first_block || inode_load_table(fs, &l1[j], 0, table) < 0) {
+                continue;
+            }
+            // Log the first-level table as it stands before a commit makes room
+            if (inode_tables_full(fs, 2) &&
+                (inode_write_table(fs, inode->double_indirect_block, l1) < 0 || inode_fs_sync(fs) < 0)) {
+                return;
+            }
+            for (uint32_t i = 0; i < PTRS_PER_BLOCK; i++) {
+                if (base + i >= first_block && table[i] > 0) {
+                    block_free(fs, table[i]);
+                    table[i] = 0;
+                    inode->block_count--;
+                }
+            }
+            if (first_block <= base) {
+                block_free(fs, l1[j]);
+                l1[j] = 0;
+            } else {
+                inode_write_table(fs, l1[j], table);
+            }
+        }
+        if (first_block <= INDIRECT_LIMIT) {
+            block_free(fs, inode->double_indirect_block);
+            inode->double_indirect_block = 0;
+        } else {
+            inode_write_table(fs, inode->double_indirect_block, l1);
         }
     }
+}
+
+// Free an i-node
+void inode_free(struct btree_filesystem *fs, struct inode *inode) {
+    if (!inode || !inode->in_use) {
+        return;
+    }
+
+    // Free all blocks (cached pages are discarded, not written back); a directory
+    // only has its in-memory entry tree, whose disk nodes go at the next sync, and
+    // inline data has no blocks at all
+    if (inode->type == INODE_TYPE_DIR) {
+        btree_destroy(inode->entries);
+        kfree(inode->entries);
+        inode->entries = NULL;
+    } else if (!(inode->flags & INODE_FLAG_INLINE)) {
+        page_cache_truncate(fs, inode, 0);
+        inode_free_blocks(fs, inode, 0);
+    }
 
     // Remove from B-Tree
     btree_delete(&fs->inode_tree, inode->inode_num);
@@ -153,6 +232,7 @@ void inode_free(struct btree_filesystem *fs, struct inode *inode) {
 
     inode->in_use = 0;
     fs->free_inodes++;
+    journal_note_op(fs);
 }
 
 // Get i-node by number
@@ -160,54 +240,256 @@ struct inode *inode_get(struct btree_filesystem *fs, uint32_t inode_num) {
     return (struct inode *)btree_search(&fs->inode_tree, inode_num);
 }
 
+// [start, end)에서 빈 블록 구간 검색 (빈 블록이 없는 그룹은 비트맵을 보지 않고 건너뜀)
+static int block_find_run(struct btree_filesystem *fs, int start, int end, int count, int *run_len) {
+    int best = -1;
+    int best_len = 0;
+    int pos = start;
+
+    while (pos < end) {
+        int group = pos / BLOCKS_PER_GROUP;
+        if (fs->group_free[group] == 0) {
+            pos = (group + 1) * BLOCKS_PER_GROUP;
+            continue;
+        }
+
+        // A full group ends any run, so search up to the next one
+        int stop = (group + 1) * BLOCKS_PER_GROUP;
+        while (stop < end && fs->group_free[stop / BLOCKS_PER_GROUP] != 0) {
+            stop += BLOCKS_PER_GROUP;
+        }
+        if (stop > end) {
+            stop = end;
+        }
+
+        int len;
+        int run = bitmap_find_free_run(fs->block_bitmap, pos, stop, count, &len);
+        if (len > best_len) {
+            best = run;
+            best_len = len;
+            if (best_len == count) {
+                break;
+            }
+        }
+        pos = stop;
+    }
+
+    *run_len = best_len;
+    return best;
+}
+
 // Allocate a block
 uint32_t block_alloc(struct btree_filesystem *fs) {
-    // Start from block 1 since block 0 is reserved (indicates no block)
-    for (int i = 1; i < MAX_BLOCKS; i++) {
-        if (!bitmap_test(fs->block_bitmap, i)) {
-            bitmap_set(fs->block_bitmap, i);
-            fs->free_blocks--;
-
-            // Clear block
-            uint8_t *block_ptr = block_get_ptr(fs, i);
-            if (block_ptr) {
-                memset(block_ptr, 0, FS_BLOCK_SIZE);
-            }
+    uint32_t allocated;
+    return block_alloc_run(fs, 0, 1, &allocated);
+}
+
+// 연속 블록 구간 할당: goal부터 찾아 count개짜리 빈 구간을 우선 사용하고,
+// 없으면 가장 긴 빈 구간을 할당. 할당한 개수는 *allocated로 돌려줌
+// goal이 0이면 마지막 할당 다음 위치(next-fit)부터 찾음
+uint32_t block_alloc_run(struct btree_filesystem *fs, uint32_t goal, uint32_t count, uint32_t *allocated) {
+    if (count == 0 || fs->free_blocks == 0) {
+        return 0;
+    }
+    if (goal == 0 || goal >= (uint32_t)fs->total_blocks) {
+        goal = fs->alloc_cursor;
+    }
+    if (count > (uint32_t)fs->total_blocks) {
+        count = fs->total_blocks;
+    }
 
-            return i;
+    // Search from goal to the end, then wrap around to block 1
+    int len;
+    int start = block_find_run(fs, goal, fs->total_blocks, count, &len);
+    if (len < (int)count && goal > 1) {
+        int wrap_len;
+        int wrap = block_find_run(fs, 1, goal, count, &wrap_len);
+        if (wrap_len > len) {
+            start = wrap;
+            len = wrap_len;
         }
     }
 
-    // No free blocks
-    return 0;
+    if (len == 0) {
+        return 0;
+    }
+
+    bitmap_set_range(fs->block_bitmap, start, len);
+    for (int b = start; b < start + len; ) {
+        int group = b / BLOCKS_PER_GROUP;
+        int group_end = (group + 1) * BLOCKS_PER_GROUP;
+        int n = (group_end < start + len ? group_end : start + len) - b;
+        fs->group_free[group] -= n;
+        b += n;
+    }
+    fs->free_blocks -= len;
+    fs->alloc_cursor = start + len < fs->total_blocks ? (uint32_t)(start + len) : fs->sb.data_start;
+    journal_block_allocated(fs, start, len);
+    journal_note_op(fs);
+
+    // Blocks are not cleared here: every caller fills them in full before they are read
+
+    *allocated = len;
+    return start;
 }
 
 // Free a block
 void block_free(struct btree_filesystem *fs, uint32_t block_num) {
-    if (block_num == 0 || block_num >= MAX_BLOCKS) {
+    if (block_num < fs->sb.data_start || block_num >= (uint32_t)fs->total_blocks ||
+        !bitmap_test(fs->block_bitmap, block_num)) {
+        return;
+    }
+
+    // A block the committed metadata still points to stays in use until the next commit
+    journal_note_op(fs);
+    if (journal_block_freed(fs, block_num)) {
         return;
     }
 
     bitmap_clear(fs->block_bitmap, block_num);
+    fs->group_free[block_num / BLOCKS_PER_GROUP]++;
     fs->free_blocks++;
 }
 
-// Get pointer to block
-uint8_t *block_get_ptr(struct btree_filesystem *fs, uint32_t block_num) {
-    if (block_num == 0 || block_num >= MAX_BLOCKS) {
-        return NULL;
+// 블록 읽기/쓰기 (count개의 연속 블록)
+int block_read(struct btree_filesystem *fs, uint32_t block_num, uint32_t count, void *buf) {
+    if (blkdev_read(fs->dev, block_num, count, buf) < 0) {
+        return -1;
+    }
+    return block_csum_check(fs, block_num, count, buf);
+}
+
+int block_write(struct btree_filesystem *fs, uint32_t block_num, uint32_t count, const void *buf) {
+    if (block_csum_unverify(fs, block_num, count) < 0) {
+        return -1;
     }
-    return fs->block_storage + (block_num * FS_BLOCK_SIZE);
+    block_csum_set(fs, block_num, count, buf);
+    return blkdev_write(fs->dev, block_num, count, buf);
 }
 
 // Check if block is allocated
 int block_is_allocated(struct btree_filesystem *fs, uint32_t block_num) {
+    if (block_num >= (uint32_t)fs->total_blocks) {
+        return 0;
+    }
     return bitmap_test(fs->block_bitmap, block_num);
 }
 
+// 파일 내 블록 인덱스를 블록 번호로 변환 (직접 -> 간접 -> 이중 간접)
+// alloc이면 비어 있는 데이터/간접 블록을 할당하고, 없으면 0 반환
+uint32_t inode_bmap(struct btree_filesystem *fs, struct inode *inode, uint32_t block_idx, int alloc) {
+    uint32_t *slot;
+
+    if (inode->flags & INODE_FLAG_INLINE) {
+        return 0;
+    }
+    if (inode->flags & INODE_FLAG_EXTENTS) {
+        uint32_t start, length;
+        if (alloc) {
+            return extent_map_run(fs, inode, block_idx, 1, &start, &length) < 0 ? 0 : start;
+        }
+        // Blocks of a compressed cluster have no place of their own on disk
+        struct inode_extent *ext = extent_find(inode, block_idx);
+        return ext && !ext->stored ? ext->start + (block_idx - ext->logical) : 0;
+    }
+
+    // Pointer tables are read into table; table_block is where to write it back.
+    // Tables allocated here are listed in new_tables until the data block is in place
+    uint32_t table[PTRS_PER_BLOCK];
+    uint32_t table_block = 0;
+    uint32_t l1[PTRS_PER_BLOCK];
+    int l1_changed = 0;
+    uint32_t *new_tables[2];
+    int new_count = 0;
+    if (alloc && block_idx >= DIRECT_BLOCKS && inode_reserve_tables(fs, 2) < 0) {
+        return 0;
+    }
+
+    if (block_idx < DIRECT_BLOCKS) {
+        slot = &inode->direct_blocks[block_idx];
+    } else if (block_idx < INDIRECT_LIMIT) {
+        int fresh = inode->indirect_block == 0;
+        if (inode_load_table(fs, &inode->indirect_block, alloc, table) < 0) {
+            return 0;
+        }
+        if (fresh) {
+            new_tables[new_count++] = &inode->indirect_block;
+        }
+        table_block = inode->indirect_block;
+        slot = &table[block_idx - DIRECT_BLOCKS];
+    } else if (block_idx < DOUBLE_INDIRECT_LIMIT) {
+        uint32_t idx = block_idx - INDIRECT_LIMIT;
+        int fresh = inode->double_indirect_block == 0;
+        if (inode_load_table(fs, &inode->double_indirect_block, alloc, l1) < 0) {
+            return 0;
+        }
+        if (fresh) {
+            new_tables[new_count++] = &inode->double_indirect_block;
+        }
+        fresh = l1[idx / PTRS_PER_BLOCK] == 0;
+        if (inode_load_table(fs, &l1[idx / PTRS_PER_BLOCK], alloc, table) < 0) {
+            inode_drop_tables(fs, new_tables, new_count);
+            return 0;
+        }
+        if (fresh) {
+            new_tables[new_count++] = &l1[idx / PTRS_PER_BLOCK];
+            l1_changed = 1;
+        }
+        table_block = l1[idx / PTRS_PER_BLOCK];
+        slot = &table[idx % PTRS_PER_BLOCK];
+    } else {
+        return 0;
+    }
+
+    // Allocate block if needed
+    if (*slot == 0 && alloc) {
+        uint32_t new_block = block_alloc(fs);
+        if (new_block == 0) {
+            inode_drop_tables(fs, new_tables, new_count);
+            return 0;
+        }
+        *slot = new_block;
+        inode->block_count++;
+        if (table_block) {
+            inode_write_table(fs, table_block, table);
+        }
+        if (l1_changed) {
+            inode_write_table(fs, inode->double_indirect_block, l1);
+        }
+    }
+
+    return *slot;
+}
+
+// block_idx부터 최대 count개 블록의 연속 물리 구간 (0이면 *run개 블록이 구멍)
+static uint32_t inode_map_run(struct btree_filesystem *fs, struct inode *inode, uint32_t block_idx,
+                              uint32_t count, int alloc, uint32_t *run) {
+    if (inode->flags & INODE_FLAG_EXTENTS) {
+        uint32_t start;
+        if (alloc) {
+            return extent_map_run(fs, inode, block_idx, count, &start, run) < 0 ? 0 : start;
+        }
+
+        struct inode_extent *ext = extent_find(inode, block_idx);
+        if (ext) {
+            uint32_t avail = ext->logical + ext->length - block_idx;
+            *run = avail < count ? avail : count;
+            return ext->start + (block_idx - ext->logical);
+        }
+
+        // Hole up to the next extent
+        struct inode_extent *next = extent_next(inode, block_idx);
+        *run = next && next->logical - block_idx < count ? next->logical - block_idx : count;
+        return 0;
+    }
+
+    *run = 1;
+    return inode_bmap(fs, inode, block_idx, alloc);
+}
+
 // Read data from i-node
 int inode_read(struct btree_filesystem *fs, struct inode *inode, void *buffer, uint32_t offset, uint32_t size) {
-    if (!inode || offset >= inode->size) {
+    if (!inode || inode->type == INODE_TYPE_DIR || offset >= inode->size) {
         return 0;
     }
 
@@ -215,94 +497,106 @@ int inode_read(struct btree_filesystem *fs, struct inode *inode, void *buffer, u
         size = inode->size - offset;
     }
 
-    uint32_t bytes_read = 0;
-    uint8_t *buf = (uint8_t *)buffer;
+    if (inode->flags & INODE_FLAG_INLINE) {
+        memcpy(buffer, inode->inline_data + offset, size);
+        return size;
+    }
 
-    while (bytes_read < size) {
-        uint32_t block_idx = (offset + bytes_read) / FS_BLOCK_SIZE;
-        uint32_t block_offset = (offset + bytes_read) % FS_BLOCK_SIZE;
-        uint32_t bytes_to_read = FS_BLOCK_SIZE - block_offset;
+    // Served from the page cache; missing blocks are read in and holes read as zeros
+    return page_cache_read(fs, inode, NULL, buffer, offset, size);
+}
 
-        if (bytes_to_read > size - bytes_read) {
-            bytes_to_read = size - bytes_read;
-        }
+// 인라인 데이터를 블록으로 옮김: 매핑 영역을 비우고 원래 매핑 방식으로 다시 씀
+int inode_promote(struct btree_filesystem *fs, struct inode *inode) {
+    uint8_t data[INODE_INLINE_SIZE];
+    uint32_t size = inode->size;
+    memcpy(data, inode->inline_data, INODE_INLINE_SIZE);
 
-        // Only support direct blocks for now
-        if (block_idx >= DIRECT_BLOCKS) {
-            break;
-        }
+    memset(inode->map_words, 0, sizeof(inode->map_words));
+    inode->flags &= ~INODE_FLAG_INLINE;
+    inode->size = 0;
+    if (size > 0 && inode_write(fs, inode, data, 0, size) < (int)size) {
+        // No space for the block: stay inline
+        inode->flags |= INODE_FLAG_INLINE;
+        memcpy(inode->inline_data, data, INODE_INLINE_SIZE);
+        inode->size = size;
+        return -1;
+    }
+    return 0;
+}
 
-        uint32_t block_num = inode->direct_blocks[block_idx];
-        if (block_num == 0) {
-            break;
-        }
+// [offset, offset + size) 범위의 블록을 매핑 (구멍이면 할당), 매핑된 바이트 수 반환
+static uint32_t inode_map_write(struct btree_filesystem *fs, struct inode *inode, uint32_t offset, uint32_t size) {
+    uint32_t mapped = 0;
 
-        uint8_t *block_ptr = block_get_ptr(fs, block_num);
-        if (!block_ptr) {
-            break;
-        }
+    while (mapped < size) {
+        uint32_t block_idx = (offset + mapped) / FS_BLOCK_SIZE;
+        uint32_t block_offset = (offset + mapped) % FS_BLOCK_SIZE;
+        uint32_t blocks = (block_offset + size - mapped + FS_BLOCK_SIZE - 1) / FS_BLOCK_SIZE;
 
-        // Copy data
-        for (uint32_t i = 0; i < bytes_to_read; i++) {
-            buf[bytes_read + i] = block_ptr[block_offset + i];
+        // Map (and allocate if needed) as many contiguous blocks as possible
+        uint32_t run;
+        uint32_t block_num = inode_map_run(fs, inode, block_idx, blocks, 0, &run);
+        if (block_num == 0) {
+            // Filling a hole: the new blocks start out as zeros in the cache, not on disk
+            block_num = inode_map_run(fs, inode, block_idx, run, 1, &run);
+            if (block_num == 0 || page_cache_new_blocks(fs, inode, block_idx, run) < 0) {
+                break;
+            }
         }
 
-        bytes_read += bytes_to_read;
+        uint32_t bytes = run * FS_BLOCK_SIZE - block_offset;
+        mapped += bytes < size - mapped ? bytes : size - mapped;
     }
 
-    return bytes_read;
+    return mapped;
 }
 
 // Write data to i-node
 int inode_write(struct btree_filesystem *fs, struct inode *inode, const void *data, uint32_t offset, uint32_t size) {
-    if (!inode || !data) {
+    if (!inode || !data || inode->type == INODE_TYPE_DIR) {
         return 0;
     }
 
     uint32_t bytes_written = 0;
     const uint8_t *buf = (const uint8_t *)data;
 
-    while (bytes_written < size) {
-        uint32_t block_idx = (offset + bytes_written) / FS_BLOCK_SIZE;
-        uint32_t block_offset = (offset + bytes_written) % FS_BLOCK_SIZE;
-        uint32_t bytes_to_write = FS_BLOCK_SIZE - block_offset;
-
-        if (bytes_to_write > size - bytes_written) {
-            bytes_to_write = size - bytes_written;
-        }
-
-        // Only support direct blocks for now
-        if (block_idx >= DIRECT_BLOCKS) {
-            break;
-        }
-
-        // Allocate block if needed
-        if (inode->direct_blocks[block_idx] == 0) {
-            uint32_t new_block = block_alloc(fs);
-            if (new_block == 0) {
-                break;
+    // Small files live in the i-node until a write reaches past it
+    if (inode->flags & INODE_FLAG_INLINE) {
+        if (offset <= INODE_INLINE_SIZE && size <= INODE_INLINE_SIZE - offset) {
+            memcpy(inode->inline_data + offset, buf, size);
+            if (offset + size > inode->size) {
+                inode->size = offset + size;
             }
-            inode->direct_blocks[block_idx] = new_block;
-            inode->block_count++;
+            journal_note_op(fs);
+            return size;
         }
-
-        uint32_t block_num = inode->direct_blocks[block_idx];
-        uint8_t *block_ptr = block_get_ptr(fs, block_num);
-        if (!block_ptr) {
-            break;
+        if (inode_promote(fs, inode) < 0) {
+            return 0;
         }
+    }
 
-        // Copy data
-        for (uint32_t i = 0; i < bytes_to_write; i++) {
-            block_ptr[block_offset + i] = buf[bytes_written + i];
+    // A compressed file gets its blocks at write-back, once each cluster's size is known
+    if (inode->flags & INODE_FLAG_COMPRESS) {
+        int n = page_cache_write(fs, inode, buf, offset, size);
+        if (offset + n > inode->size) {
+            inode->size = offset + n;
+            journal_note_op(fs);
         }
+        return n;
+    }
 
-        bytes_written += bytes_to_write;
+    // Data goes into the page cache and reaches the device on write-back
+    uint32_t mapped = inode_map_write(fs, inode, offset, size);
+    if (mapped > 0) {
+        int n = page_cache_write(fs, inode, buf, offset, mapped);
+        bytes_written = n > 0 ? n : 0;
     }
 
     // Update i-node size
     if (offset + bytes_written > inode->size) {
         inode->size = offset + bytes_written;
+        journal_note_op(fs);
     }
 
     return bytes_written;
@@ -310,40 +604,179 @@ int inode_write(struct btree_filesystem *fs, struct inode *inode, const void *da
 
 // Truncate i-node to new size
 int inode_truncate(struct btree_filesystem *fs, struct inode *inode, uint32_t new_size) {
-    if (!inode) {
+    if (!inode || inode->type == INODE_TYPE_DIR) {
         return -1;
     }
 
     if (new_size >= inode->size) {
         return 0;
     }
+    if (inode->mmaps) {
+        printf("Error: File is memory-mapped\n");
+        return -1;
+    }
+
+    // Inline bytes past the end are cleared so a later extension reads zeros
+    if (inode->flags & INODE_FLAG_INLINE) {
+        memset(inode->inline_data + new_size, 0, inode->size - new_size);
+        inode->size = new_size;
+        journal_note_op(fs);
+        return 0;
+    }
 
     uint32_t new_blocks = (new_size + FS_BLOCK_SIZE - 1) / FS_BLOCK_SIZE;
 
+    // Drop cached pages past the new end before their blocks are released
+    page_cache_truncate(fs, inode, new_size);
+
+    // Compressed clusters go whole; the one holding the new end is rewritten with zeros after it
+    if (inode->flags & INODE_FLAG_COMPRESS) {
+        inode_free_blocks(fs, inode, (new_size + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_CACHE_BLOCKS_PER_PAGE);
+        static const uint8_t zeros[FS_BLOCK_SIZE];
+        uint32_t pos = new_size;
+        while (pos % PAGE_SIZE) {
+            uint32_t n = FS_BLOCK_SIZE - pos % FS_BLOCK_SIZE;
+            if (page_cache_write(fs, inode, zeros, pos, n) < (int)n) {
+                break;
+            }
+            pos += n;
+        }
+        inode->size = new_size;
+        journal_note_op(fs);
+        return 0;
+    }
+
     // Free blocks beyond new size
-    for (uint32_t i = new_blocks; i < inode->block_count && i < DIRECT_BLOCKS; i++) {
-        if (inode->direct_blocks[i] > 0) {
-            block_free(fs, inode->direct_blocks[i]);
-            inode->direct_blocks[i] = 0;
+    inode_free_blocks(fs, inode, new_blocks);
+
+    // Zero the tail of the last block so a later extension reads zeros
+    if (new_size % FS_BLOCK_SIZE) {
+        uint32_t block_num = inode_bmap(fs, inode, new_blocks - 1, 0);
+        uint8_t block[FS_BLOCK_SIZE];
+        if (block_num && block_read(fs, block_num, 1, block) == 0) {
+            memset(block + new_size % FS_BLOCK_SIZE, 0, FS_BLOCK_SIZE - new_size % FS_BLOCK_SIZE);
+            block_write(fs, block_num, 1, block);
         }
     }
 
     inode->size = new_size;
-    inode->block_count = new_blocks;
+    journal_note_op(fs);
 
     return 0;
 }
 
-// Create a file
+// 디렉터리의 항목 B-트리
+static struct btree *dir_entries(struct btree_filesystem *fs, uint32_t dir) {
+    return dir == ROOT_DIR ? &fs->name_tree : fs->inodes[dir].entries;
+}
+
+// 디렉터리 항목 트리가 바뀌었음을 표시 (다음 커밋이 이 트리만 다시 기록)
+static void dir_entries_changed(struct btree_filesystem *fs, uint32_t dir) {
+    if (dir == ROOT_DIR) {
+        fs->name_tree_dirty = 1;
+    } else {
+        fs->inodes[dir].tree_dirty = 1;
+    }
+}
+
+// 디렉터리에서 이름 하나 찾기: dentry 캐시를 먼저 보고, 없으면 항목 B-트리를 찾아 결과를 캐시
+static struct inode *dir_lookup(struct btree_filesystem *fs, uint32_t dir, uint32_t hash) {
+    struct inode *inode;
+    if (dcache_lookup(&fs->dcache, dir, hash, &inode)) {
+        return inode;
+    }
+    inode = (struct inode *)btree_search(dir_entries(fs, dir), hash);
+    dcache_add(&fs->dcache, dir, hash, inode);
+    return inode;
+}
+
+static int name_is(const char *name, uint32_t len, const char *what) {
+    uint32_t i = 0;
+    while (i < len && what[i] && name[i] == what[i]) {
+        i++;
+    }
+    return i == len && what[i] == 0;
+}
+
+// 경로를 마지막 구성 요소 앞까지 따라감 ("/a/b/c"와 "a/b/c"는 같고, "."과 ".."을 지원)
+// *dir은 마지막 구성 요소가 들어 있는 디렉터리, *name/*len은 그 이름 (경로가 디렉터리로 끝나면 len 0)
+static int path_walk(struct btree_filesystem *fs, const char *path, uint32_t *dir,
+                     const char **name, uint32_t *len) {
+    uint32_t cur = ROOT_DIR;
+    const char *p = path;
+
+    for (;;) {
+        while (*p == '/') {
+            p++;
+        }
+        const char *start = p;
+        while (*p && *p != '/') {
+            p++;
+        }
+        uint32_t n = p - start;
+        while (*p == '/') {
+            p++;
+        }
+
+        if (name_is(start, n, ".") || name_is(start, n, "..")) {
+            if (n == 2 && cur != ROOT_DIR) {
+                cur = fs->inodes[cur].parent;
+            }
+            n = 0;
+        }
+        if (*p == 0) {
+            *dir = cur;
+            *name = start;
+            *len = n;
+            return 0;
+        }
+        if (n == 0) {
+            continue;
+        }
+
+        struct inode *next = dir_lookup(fs, cur, hash_name(start, n));
+        if (!next || next->type != INODE_TYPE_DIR) {
+            return -1;
+        }
+        cur = next->inode_num;
+    }
+}
+
+// 경로의 i-node (루트 디렉터리는 i-node가 없으므로 NULL)
+static struct inode *path_lookup(struct btree_filesystem *fs, const char *path) {
+    uint32_t dir;
+    const char *name;
+    uint32_t len;
+    if (path_walk(fs, path, &dir, &name, &len) < 0) {
+        return NULL;
+    }
+    if (len == 0) {
+        return dir == ROOT_DIR ? NULL : &fs->inodes[dir];
+    }
+    return dir_lookup(fs, dir, hash_name(name, len));
+}
+
+// Create a file or directory; every directory on the path must already exist
 int btree_fs_create(struct btree_filesystem *fs, const char *filename, uint32_t type) {
-    if (strlen(filename) >= MAX_FILENAME_LEN) {
+    uint32_t dir;
+    const char *name;
+    uint32_t len;
+    if (path_walk(fs, filename, &dir, &name, &len) < 0) {
+        printf("Error: No such directory\n");
+        return -1;
+    }
+    if (len == 0) {
+        printf("Error: File already exists\n");
+        return -1;
+    }
+    if (len >= MAX_FILENAME_LEN) {
         printf("Error: Filename too long\n");
         return -1;
     }
 
     // Check if file already exists
-    uint32_t hash = hash_string(filename);
-    struct inode *existing = (struct inode *)btree_search(&fs->name_tree, hash);
+    uint32_t hash = hash_name(name, len);
+    struct inode *existing = dir_lookup(fs, dir, hash);
     if (existing) {
         printf("Error: File already exists\n");
         return -1;
@@ -354,18 +787,30 @@ int btree_fs_create(struct btree_filesystem *fs, const char *filename, uint32_t
     if (!inode) {
         return -1;
     }
+    if (type == INODE_TYPE_DIR) {
+        inode->parent = dir;
+    }
 
-    // Add filename mapping to name tree
-    btree_insert(&fs->name_tree, hash, inode);
+    // Add the name to its directory (replacing the negative entry cached above)
+    if (btree_insert(dir_entries(fs, dir), hash, inode) < 0) {
+        inode_free(fs, inode);
+        printf("Error: No memory for directory entry\n");
+        return -1;
+    }
+    dir_entries_changed(fs, dir);
+    dcache_add(&fs->dcache, dir, hash, inode);
+    if (dir != ROOT_DIR) {
+        fs->inodes[dir].size++;
+    }
 
-    printf("Created file '%s' with i-node %u\n", filename, inode->inode_num);
+    printf("Created %s '%s' with i-node %u\n", type == INODE_TYPE_DIR ? "directory" : "file",
+           filename, inode->inode_num);
     return inode->inode_num;
 }
 
 // Open a file (get i-node number)
 int btree_fs_open(struct btree_filesystem *fs, const char *filename) {
-    uint32_t hash = hash_string(filename);
-    struct inode *inode = (struct inode *)btree_search(&fs->name_tree, hash);
+    struct inode *inode = path_lookup(fs, filename);
 
     if (!inode) {
         return -1;
@@ -383,11 +828,13 @@ int btree_fs_read(struct btree_filesystem *fs, const char *filename, void *buffe
     }
 
     struct inode *inode = inode_get(fs, inode_num);
-    if (!inode) {
+    if (!inode || inode->type == INODE_TYPE_DIR) {
         return -1;
     }
 
-    return inode_read(fs, inode, buffer, 0, size);
+    // A whole-file read is sequential, so let it stream through read-ahead
+    struct btree_file file = { fs, inode, 0, { 0, 0, 0, 0 } };
+    return btree_file_read(&file, buffer, size);
 }
 
 // Write to file
@@ -406,23 +853,316 @@ int btree_fs_write(struct btree_filesystem *fs, const char *filename, const void
     return inode_write(fs, inode, data, 0, size);
 }
 
+// Make a file's data and the volume metadata durable
+int btree_fs_fsync(struct btree_filesystem *fs, const char *filename) {
+    int inode_num = btree_fs_open(fs, filename);
+    if (inode_num < 0) {
+        printf("Error: File not found\n");
+        return -1;
+    }
+
+    struct inode *inode = inode_get(fs, inode_num);
+    if (!inode) {
+        return -1;
+    }
+
+    return inode_fsync(fs, inode);
+}
+
+// 파일별 압축 켜기/끄기 (블록 매핑 방식이 바뀌므로 빈 파일에만)
+int btree_fs_set_compress(struct btree_filesystem *fs, const char *filename, int enable) {
+    int inode_num = btree_fs_open(fs, filename);
+    if (inode_num < 0) {
+        printf("Error: File not found\n");
+        return -1;
+    }
+
+    struct inode *inode = inode_get(fs, inode_num);
+    if (!inode || inode->type == INODE_TYPE_DIR || !(inode->flags & INODE_FLAG_EXTENTS)) {
+        printf("Error: Compression needs an extent-mapped file\n");
+        return -1;
+    }
+    if (inode->size > 0) {
+        printf("Error: Compression can only be changed on an empty file\n");
+        return -1;
+    }
+
+    if (enable) {
+        inode->flags |= INODE_FLAG_COMPRESS;
+    } else {
+        inode->flags &= ~INODE_FLAG_COMPRESS;
+    }
+    journal_note_op(fs);
+    return 0;
+}
+
+// 열린 파일 만들기: 열려 있는 동안 i-node는 지울 수 없음
+static struct btree_file *btree_file_attach(struct btree_filesystem *fs, struct inode *inode) {
+    struct btree_file *file = (struct btree_file *)kmalloc(sizeof(struct btree_file));
+    if (!file) {
+        return NULL;
+    }
+    memset(file, 0, sizeof(*file));
+    file->fs = fs;
+    file->inode = inode;
+    inode->opens++;
+    return file;
+}
+
+// Open a file for positioned reads and writes
+struct btree_file *btree_file_open(struct btree_filesystem *fs, const char *filename) {
+    int inode_num = btree_fs_open(fs, filename);
+    if (inode_num < 0) {
+        printf("Error: File not found\n");
+        return NULL;
+    }
+
+    struct inode *inode = inode_get(fs, inode_num);
+    if (!inode) {
+        return NULL;
+    }
+    if (inode->type == INODE_TYPE_DIR) {
+        printf("Error: Is a directory\n");
+        return NULL;
+    }
+
+    return btree_file_attach(fs, inode);
+}
+
+// Read from the file position, reading ahead while access stays sequential
+int btree_file_read(struct btree_file *file, void *buffer, uint32_t size) {
+    struct inode *inode = file->inode;
+    if (file->pos >= inode->size) {
+        return 0;
+    }
+    if (file->pos + size > inode->size) {
+        size = inode->size - file->pos;
+    }
+
+    int n = (inode->flags & INODE_FLAG_INLINE) ? inode_read(file->fs, inode, buffer, file->pos, size)
+                                               : page_cache_read(file->fs, inode, &file->ra, buffer, file->pos, size);
+    file->pos += n;
+    return n;
+}
+
+// Write at the file position
+int btree_file_write(struct btree_file *file, const void *data, uint32_t size) {
+    int n = inode_write(file->fs, file->inode, data, file->pos, size);
+    file->pos += n;
+    return n;
+}
+
+int btree_file_seek(struct btree_file *file, uint32_t pos) {
+    if (pos > MAX_FILE_SIZE) {
+        return -1;
+    }
+    file->pos = pos;
+    return 0;
+}
+
+void btree_file_close(struct btree_file *file) {
+    file->inode->opens--;
+    kfree(file);
+}
+
+// Scattered read: the size is checked once and every piece shares the read-ahead state
+int btree_file_readv(struct btree_file *file, const struct iovec *iov, int iovcnt) {
+    struct inode *inode = file->inode;
+    uint32_t left = file->pos < inode->size ? inode->size - file->pos : 0;
+    int total = 0;
+
+    for (int i = 0; i < iovcnt && left > 0; i++) {
+        uint32_t size = iov[i].iov_len < left ? iov[i].iov_len : left;
+        int n = (inode->flags & INODE_FLAG_INLINE)
+                    ? inode_read(file->fs, inode, iov[i].iov_base, file->pos, size)
+                    : page_cache_read(file->fs, inode, &file->ra, iov[i].iov_base, file->pos, size);
+        if (n <= 0) {
+            break;
+        }
+        file->pos += n;
+        left -= n;
+        total += n;
+        if ((uint32_t)n < size) {
+            break;
+        }
+    }
+    return total;
+}
+
+// Gathered write: blocks for the whole range are mapped in one pass, so the pieces land in
+// one extent run, then each piece is copied straight into the page cache
+int btree_file_writev(struct btree_file *file, const struct iovec *iov, int iovcnt) {
+    struct btree_filesystem *fs = file->fs;
+    struct inode *inode = file->inode;
+    uint32_t size = iov_length(iov, iovcnt);
+    if (size == 0) {
+        return 0;
+    }
+    if (file->pos + size < file->pos || file->pos + size > MAX_FILE_SIZE) {
+        return -1;
+    }
+
+    // Small enough to stay inline, or compressed (blocks come at write-back): piece by piece
+    int inline_fits = file->pos <= INODE_INLINE_SIZE && size <= INODE_INLINE_SIZE - file->pos;
+    if ((inode->flags & INODE_FLAG_INLINE) && !inline_fits && inode_promote(fs, inode) < 0) {
+        return 0;
+    }
+    if (inode->flags & (INODE_FLAG_INLINE | INODE_FLAG_COMPRESS)) {
+        int total = 0;
+        for (int i = 0; i < iovcnt; i++) {
+            int n = btree_file_write(file, iov[i].iov_base, iov[i].iov_len);
+            total += n;
+            if ((uint32_t)n < iov[i].iov_len) {
+                break;
+            }
+        }
+        return total;
+    }
+
+    uint32_t mapped = inode_map_write(fs, inode, file->pos, size);
+    uint32_t done = 0;
+    for (int i = 0; i < iovcnt && done < mapped; i++) {
+        uint32_t len = iov[i].iov_len < mapped - done ? iov[i].iov_len : mapped - done;
+        int n = page_cache_write(fs, inode, iov[i].iov_base, file->pos + done, len);
+        if (n > 0) {
+            done += n;
+        }
+        if (n < (int)len) {
+            break;
+        }
+    }
+
+    // One size update for the whole call
+    if (file->pos + done > inode->size) {
+        inode->size = file->pos + done;
+        journal_note_op(fs);
+    }
+    file->pos += done;
+    return done;
+}
+
+// VFS 연산: 열린 파일의 node는 struct btree_file (미리 읽기 상태가 열린 파일마다 따로 있음)
+static int btree_vfs_open(struct vfs_mount *mnt, const char *path, struct vfs_file *file) {
+    struct btree_filesystem *fs = (struct btree_filesystem *)mnt->sb;
+    int inode_num = btree_fs_open(fs, path);
+    struct inode *inode = inode_num < 0 ? NULL : inode_get(fs, inode_num);
+    if (!inode || inode->type == INODE_TYPE_DIR) {
+        return -1;
+    }
+
+    struct btree_file *bf = btree_file_attach(fs, inode);
+    if (!bf) {
+        return -1;
+    }
+    file->node = bf;
+    return 0;
+}
+
+static void btree_vfs_release(struct vfs_file *file) {
+    btree_file_close((struct btree_file *)file->node);
+}
+
+// The VFS owns the offset; the open file keeps only the read-ahead state between calls
+static struct btree_file *btree_vfs_at(struct vfs_file *file) {
+    struct btree_file *bf = (struct btree_file *)file->node;
+    bf->pos = file->offset;
+    return bf;
+}
+
+static int btree_vfs_read(struct vfs_file *file, void *buf, uint32_t size) {
+    return btree_file_read(btree_vfs_at(file), buf, size);
+}
+
+static int btree_vfs_write(struct vfs_file *file, const void *buf, uint32_t size) {
+    return btree_file_write(btree_vfs_at(file), buf, size);
+}
+
+static int btree_vfs_readv(struct vfs_file *file, const struct iovec *iov, int iovcnt) {
+    return btree_file_readv(btree_vfs_at(file), iov, iovcnt);
+}
+
+static int btree_vfs_writev(struct vfs_file *file, const struct iovec *iov, int iovcnt) {
+    return btree_file_writev(btree_vfs_at(file), iov, iovcnt);
+}
+
+static int btree_vfs_fsync(struct vfs_file *file) {
+    struct btree_file *bf = (struct btree_file *)file->node;
+    return inode_fsync(bf->fs, bf->inode);
+}
+
+static uint32_t btree_vfs_size(struct vfs_file *file) {
+    return ((struct btree_file *)file->node)->inode->size;
+}
+
+static int btree_vfs_create(struct vfs_mount *mnt, const char *path) {
+    return btree_fs_create((struct btree_filesystem *)mnt->sb, path, INODE_TYPE_FILE) < 0 ? -1 : 0;
+}
+
+static int btree_vfs_unlink(struct vfs_mount *mnt, const char *path) {
+    return btree_fs_delete((struct btree_filesystem *)mnt->sb, path);
+}
+
+static void btree_vfs_list(struct vfs_mount *mnt) {
+    btree_fs_list((struct btree_filesystem *)mnt->sb);
+}
+
+const struct vfs_ops btree_vfs_ops = {
+    .name = "btree",
+    .open = btree_vfs_open,
+    .release = btree_vfs_release,
+    .read = btree_vfs_read,
+    .write = btree_vfs_write,
+    .readv = btree_vfs_readv,
+    .writev = btree_vfs_writev,
+    .fsync = btree_vfs_fsync,
+    .size = btree_vfs_size,
+    .create = btree_vfs_create,
+    .unlink = btree_vfs_unlink,
+    .list = btree_vfs_list,
+};
+
 // Delete a file
 int btree_fs_delete(struct btree_filesystem *fs, const char *filename) {
-    uint32_t hash = hash_string(filename);
-    struct inode *inode = (struct inode *)btree_search(&fs->name_tree, hash);
+    uint32_t dir;
+    const char *name;
+    uint32_t len;
+    struct inode *inode = NULL;
+    uint32_t hash = 0;
+    if (path_walk(fs, filename, &dir, &name, &len) == 0 && len > 0) {
+        hash = hash_name(name, len);
+        inode = dir_lookup(fs, dir, hash);
+    }
 
     if (!inode) {
         printf("Error: File not found\n");
         return -1;
     }
+    if (inode->type == INODE_TYPE_DIR && inode->size > 0) {
+        printf("Error: Directory not empty\n");
+        return -1;
+    }
+    if (inode->mmaps) {
+        printf("Error: File is memory-mapped\n");
+        return -1;
+    }
+    if (inode->opens) {
+        printf("Error: File is open\n");
+        return -1;
+    }
 
-    // Remove from name tree
-    btree_delete(&fs->name_tree, hash);
+    // Remove from the directory; the name now caches as missing
+    btree_delete(dir_entries(fs, dir), hash);
+    dir_entries_changed(fs, dir);
+    dcache_add(&fs->dcache, dir, hash, NULL);
+    if (dir != ROOT_DIR) {
+        fs->inodes[dir].size--;
+    }
+    if (inode->type == INODE_TYPE_DIR) {
+        dcache_purge_dir(&fs->dcache, inode->inode_num);
+    }
 
     // Free i-node
     inode_free(fs, inode);
-
-    printf("Deleted file '%s'\n", filename);
     return 0;
 }
 
@@ -469,23 +1209,86 @@ void inode_print(struct inode *inode) {
     printf("  Blocks: %u\n", inode->block_count);
     printf("  Permissions: 0x%x\n", inode->permissions);
     printf("  Links: %u\n", inode->link_count);
+    if (inode->type == INODE_TYPE_DIR) {
+        printf("  Entries: %u (parent %u)\n", inode->size, inode->parent);
+        return;
+    }
+    if (inode->flags & INODE_FLAG_INLINE) {
+        printf("  Inline data: %u of %u bytes\n", inode->size, INODE_INLINE_SIZE);
+        return;
+    }
+    if (inode->flags & INODE_FLAG_EXTENTS) {
+        extent_print(inode);
+        return;
+    }
     printf("  Direct blocks: ");
-    for (int i = 0; i < DIRECT_BLOCKS && i < inode->block_count; i++) {
-        printf("%u ", inode->direct_blocks[i]);
+    for (int i = 0; i < DIRECT_BLOCKS; i++) {
+        if (inode->direct_blocks[i] > 0) {
+            printf("%u ", inode->direct_blocks[i]);
+        }
     }
     printf("\n");
+    if (inode->indirect_block > 0) {
+        printf("  Indirect block: %u\n", inode->indirect_block);
+    }
+    if (inode->double_indirect_block > 0) {
+        printf("  Double indirect block: %u\n", inode->double_indirect_block);
+    }
 }
 
 // Print filesystem statistics
 void fs_print_stats(struct btree_filesystem *fs) {
     printf("B-Tree Filesystem Statistics:\n");
+    printf("  Device: %s (metadata in blocks 0-%u)\n", fs->dev->name, fs->sb.data_start - 1);
     printf("  Total i-nodes: %d\n", fs->total_inodes);
     printf("  Free i-nodes: %d\n", fs->free_inodes);
     printf("  Used i-nodes: %d\n", fs->total_inodes - fs->free_inodes);
     printf("  Total blocks: %d\n", fs->total_blocks);
     printf("  Free blocks: %d\n", fs->free_blocks);
     printf("  Used blocks: %d\n", fs->total_blocks - fs->free_blocks);
+    int full_groups = 0;
+    for (int g = 0; g < fs->group_count; g++) {
+        if (fs->group_free[g] == 0) {
+            full_groups++;
+        }
+    }
+    printf("  Block groups: %d of %d blocks (%d full)\n", fs->group_count, BLOCKS_PER_GROUP, full_groups);
+    int inline_files = 0;
+    for (int i = 0; i < MAX_INODE_COUNT; i++) {
+        if (fs->inodes[i].in_use && (fs->inodes[i].flags & INODE_FLAG_INLINE)) {
+            inline_files++;
+        }
+    }
+    printf("  Inline files: %d (no data block)\n", inline_files);
+    int compressed_files = 0;
+    uint32_t compressed_size = 0;
+    uint32_t compressed_blocks = 0;
+    for (int i = 0; i < MAX_INODE_COUNT; i++) {
+        struct inode *inode = &fs->inodes[i];
+        if (inode->in_use && (inode->flags & INODE_FLAG_COMPRESS)) {
+            compressed_files++;
+            compressed_size += inode->size;
+            compressed_blocks += inode->block_count;
+        }
+    }
+    struct compress_stats *cs = &fs->compress;
+    printf("  Compressed files: %d, %u KB in %u blocks\n",
+           compressed_files, compressed_size / 1024, compressed_blocks);
+    printf("  LZ4: %u clusters compressed, %u stored plain, ratio %u.%u (%u -> %u blocks)\n",
+           cs->clusters, cs->plain_clusters,
+           cs->stored_blocks ? cs->raw_blocks / cs->stored_blocks : 0,
+           cs->stored_blocks ? cs->raw_blocks * 10 / cs->stored_blocks % 10 : 0,
+           cs->raw_blocks, cs->stored_blocks);
+    // KB/s from 10 MHz ticks, in 0.1 ms units to stay within 32 bits
+    printf("  LZ4 throughput: compress %u KB/s, decompress %u KB/s\n",
+           cs->compressed_bytes / 1024 * 10000 / (cs->compress_ticks / 1000 + 1),
+           cs->decompressed_bytes / 1024 * 10000 / (cs->decompress_ticks / 1000 + 1));
     printf("  Block size: %d bytes\n", FS_BLOCK_SIZE);
     printf("  Total storage: %d KB\n", (fs->total_blocks * FS_BLOCK_SIZE) / 1024);
     printf("  Used storage: %d KB\n", ((fs->total_blocks - fs->free_blocks) * FS_BLOCK_SIZE) / 1024);
+    printf("  Dentry cache: %u hits, %u negative hits, %u misses\n",
+           fs->dcache.hits, fs->dcache.negative_hits, fs->dcache.misses);
+    printf("  Journal: %u transactions, %u updates, %u blocks logged (%u updates pending)\n",
+           fs->journal.commits, fs->journal.committed_ops, fs->journal.logged_blocks, fs->journal.ops);
+    page_cache_print_stats();
 }
@@ -1,6 +1,13 @@
 #pragma once
 #include "kernel.h"
 #include "btree.h"
+#include "blkdev.h"
+#include "fs_format.h"
+#include "radix.h"
+#include "pagecache.h"
+#include "journal.h"
+#include "dcache.h"
+#include "fd.h"
 
 // I-node 상수
 #define MAX_INODE_COUNT 256
@@ -12,31 +19,81 @@
 
 // 파일 데이터용 블록 크기
 #define FS_BLOCK_SIZE 512
-#define MAX_BLOCKS 1024
+#define MAX_BLOCKS 1024                          // RAM 디스크 크기 (디스크 볼륨은 슈퍼블록이 정함)
+
+// 블록 그룹: 그룹마다 빈 블록 수를 따로 세어 꽉 찬 그룹은 검색에서 건너뜀
+#define BLOCKS_PER_GROUP 128
+
+// 간접 블록 매핑 (간접 블록 하나에 블록 포인터 128개)
+#define PTRS_PER_BLOCK (FS_BLOCK_SIZE / sizeof(uint32_t))
+#define INDIRECT_LIMIT (DIRECT_BLOCKS + PTRS_PER_BLOCK)
+#define DOUBLE_INDIRECT_LIMIT (INDIRECT_LIMIT + PTRS_PER_BLOCK * PTRS_PER_BLOCK)
+#define MAX_FILE_SIZE (DOUBLE_INDIRECT_LIMIT * FS_BLOCK_SIZE)
 
 // I-node 타입
 #define INODE_TYPE_FREE 0
 #define INODE_TYPE_FILE 1
 #define INODE_TYPE_DIR 2
 
+// 루트 디렉터리는 i-node 없이 name_tree가 항목을 가짐 (dcache와 parent에서 쓰는 번호)
+#define ROOT_DIR MAX_INODE_COUNT
+
+// I-node 플래그 (블록 매핑 방식)
+#define INODE_FLAG_EXTENTS     0x1               // 익스텐트로 블록 매핑
+#define INODE_FLAG_EXTENT_TREE 0x2               // 익스텐트가 B-트리로 넘어감
+#define INODE_FLAG_INLINE      0x4               // 데이터가 블록 매핑 영역 안에 있음 (블록 없음)
+#define INODE_FLAG_COMPRESS    0x8               // 페이지 단위 클러스터를 LZ4로 압축해 저장 (익스텐트 필요)
+
+// i-node 안에 직접 들어가는 익스텐트 수 (블록 포인터 영역 재사용)
+#define INODE_INLINE_EXTENTS 3
+
+// 블록 매핑 영역의 워드 수 (디스크 i-node의 map과 같음)
+#define INODE_MAP_WORDS (DIRECT_BLOCKS + 2)
+
+// i-node 안에 직접 보관하는 파일 데이터 크기 (블록 매핑 영역 전체, 넘으면 블록으로 옮김)
+#define INODE_INLINE_SIZE (INODE_MAP_WORDS * 4)
+
 // 파일 권한
 #define PERM_READ  0x4
 #define PERM_WRITE 0x2
 #define PERM_EXEC  0x1
 
+// 익스텐트: 논리 블록 logical부터 length개가 물리 블록 start부터 연속으로 매핑됨
+// 압축된 클러스터는 stored개 블록에 담긴 LZ4 데이터가 논리 블록 length개로 풀림
+struct inode_extent {
+    uint32_t logical;                            // First logical block in the file
+    uint32_t start;                              // First physical block
+    uint32_t length;                             // Number of blocks
+    uint32_t stored;                             // Compressed: blocks on disk from start (0 = plain)
+};
+
 // I-node 구조체 (Unix i-node와 유사)
 struct inode {
     uint32_t inode_num;                          // I-node number (unique identifier)
     uint32_t type;                               // Type: file, directory, etc.
-    uint32_t size;                               // File size in bytes
+    uint32_t size;                               // File size in bytes (directories: entry count)
     uint32_t permissions;                        // 파일 권한
     uint32_t link_count;                         // Number of hard links
-    uint32_t block_count;                        // Number of blocks used
+    uint32_t block_count;                        // Number of data blocks used
+    uint32_t flags;                              // INODE_FLAG_*
+    uint32_t extent_count;                       // Number of extents (extent-mapped only)
 
-    // Direct block pointers
-    uint32_t direct_blocks[DIRECT_BLOCKS];       // Direct block pointers
-    uint32_t indirect_block;                     // Single indirect block pointer
-    uint32_t double_indirect_block;              // Double indirect block pointer
+    // Block mapping: block pointers, inline extents, extent B-Tree or inline data (directories: entry B-Tree)
+    union {
+        struct {
+            uint32_t direct_blocks[DIRECT_BLOCKS];   // Direct block pointers
+            uint32_t indirect_block;                 // Single indirect block pointer
+            uint32_t double_indirect_block;          // Double indirect block pointer
+        };
+        struct inode_extent extents[INODE_INLINE_EXTENTS]; // Inline extents, sorted by logical
+        struct btree *extent_tree;               // Extents keyed by logical block
+        uint8_t inline_data[INODE_INLINE_SIZE];  // Whole file while INODE_FLAG_INLINE is set
+        struct {
+            struct btree *entries;               // Directory: entries keyed by name hash
+            uint32_t parent;                     // Directory: containing directory (ROOT_DIR at the top)
+        };
+        uint32_t map_words[INODE_MAP_WORDS];     // Raw view, copied to and from disk
+    };
 
     // Metadata
     uint32_t created_time;                       // Creation timestamp
@@ -44,6 +101,10 @@ struct inode {
     uint32_t accessed_time;                      // Last access timestamp
 
     int in_use;                                  // 1 if i-node is in use
+    uint32_t mmaps;                              // Live memory mappings (truncate and delete refuse)
+    uint32_t opens;                              // Open btree_files (delete refuses)
+    int tree_dirty;                              // Entry or extent tree changed since its last commit
+    struct radix_tree page_tree;                 // Cached pages by page number (pagecache.c)
 };
 
 // Directory entry structure
@@ -53,40 +114,120 @@ struct dirent {
     int in_use;                                  // 1 if entry is valid
 };
 
+// 압축 통계 (write-back한 클러스터 누계, 처리 시간은 10MHz 타이머 틱)
+struct compress_stats {
+    uint32_t clusters;                           // Clusters stored compressed
+    uint32_t plain_clusters;                     // Clusters that did not shrink by a block
+    uint32_t raw_blocks;                         // Blocks the written clusters would take uncompressed
+    uint32_t stored_blocks;                      // Blocks they actually took
+    uint32_t compressed_bytes;                   // Bytes fed to the compressor
+    uint32_t compress_ticks;
+    uint32_t decompressed_bytes;                 // Bytes produced by the decompressor
+    uint32_t decompress_ticks;
+};
+
 // File system structure with B-Tree indexing
 struct btree_filesystem {
     struct btree inode_tree;                     // B-Tree for fast i-node lookup by number
-    struct btree name_tree;                      // B-Tree for filename to i-node mapping
+    struct btree name_tree;                      // Root directory: name hash to i-node
+    int name_tree_dirty;                         // name_tree changed since its last commit
     struct inode inodes[MAX_INODE_COUNT];        // I-node table
-    uint8_t *block_storage;                      // Block storage area
-    uint32_t block_bitmap[MAX_BLOCKS / 32];      // Block allocation bitmap
+    struct block_device *dev;                    // Backing block device
+    struct fs_superblock sb;                     // In-memory copy of the superblock
+    uint32_t *block_bitmap;                      // Block allocation bitmap (total_blocks bits)
     uint32_t inode_bitmap[MAX_INODE_COUNT / 32]; // I-node allocation bitmap
     int total_inodes;                            // Total number of i-nodes
     int free_inodes;                             // Number of free i-nodes
     int total_blocks;                            // Total number of blocks
     int free_blocks;                             // Number of free blocks
+    int *group_free;                             // Free blocks in each block group
+    int group_count;                             // Number of block groups
+    uint32_t alloc_cursor;                       // Next-fit hint: block after the last allocation
+    uint32_t default_inode_flags;                // Flags for newly allocated i-nodes
+    struct journal journal;                      // Running metadata transaction
+    struct dcache dcache;                        // Path component lookups, including misses
+    uint32_t *csum;                              // CRC32C of every block (NULL without FS_FEATURE_CSUM)
+    uint32_t *csum_home;                         // The table as committed on disk (0 = unverified)
+    uint32_t *csum_dirty;                        // Checksum table blocks changed since the last commit
+    uint32_t csum_errors;                        // Blocks that failed verification
+    struct compress_stats compress;              // LZ4 cluster write-back and reads
+};
+
+// Open file: position and read-ahead state are per open, not per i-node
+struct btree_file {
+    struct btree_filesystem *fs;
+    struct inode *inode;
+    uint32_t pos;                                // Offset of the next read or write
+    struct file_ra_state ra;                     // Sequential read detection
 };
 
 // I-node operations
 void inode_fs_init(struct btree_filesystem *fs);
+
+// On-disk volume (fs_disk.c)
+int inode_fs_format(struct btree_filesystem *fs, struct block_device *dev);
+int inode_fs_mount(struct btree_filesystem *fs, struct block_device *dev);
+int inode_fs_sync(struct btree_filesystem *fs);
+int inode_fsync(struct btree_filesystem *fs, struct inode *inode);
+void inode_fs_flusher(void);
+
+// 데이터 영역 블록 체크섬 (fs_disk.c): 기록 전에 갱신, 읽은 뒤 검증 (틀리면 -1)
+// 제자리에 덮어쓰는 블록은 그 전에 block_csum_unverify로 디스크의 체크섬을 비워 둠
+int block_csum_unverify(struct btree_filesystem *fs, uint32_t block_num, uint32_t count);
+void block_csum_set(struct btree_filesystem *fs, uint32_t block_num, uint32_t count, const void *buf);
+int block_csum_check(struct btree_filesystem *fs, uint32_t block_num, uint32_t count, const void *buf);
+void inode_fs_unmount(struct btree_filesystem *fs);
+
 struct inode *inode_alloc(struct btree_filesystem *fs, uint32_t type);
 void inode_free(struct btree_filesystem *fs, struct inode *inode);
 struct inode *inode_get(struct btree_filesystem *fs, uint32_t inode_num);
 int inode_read(struct btree_filesystem *fs, struct inode *inode, void *buffer, uint32_t offset, uint32_t size);
 int inode_write(struct btree_filesystem *fs, struct inode *inode, const void *data, uint32_t offset, uint32_t size);
 int inode_truncate(struct btree_filesystem *fs, struct inode *inode, uint32_t new_size);
+int inode_promote(struct btree_filesystem *fs, struct inode *inode);
+uint32_t inode_bmap(struct btree_filesystem *fs, struct inode *inode, uint32_t block_idx, int alloc);
 
 // Block operations
 uint32_t block_alloc(struct btree_filesystem *fs);
+uint32_t block_alloc_run(struct btree_filesystem *fs, uint32_t goal, uint32_t count, uint32_t *allocated);
 void block_free(struct btree_filesystem *fs, uint32_t block_num);
-uint8_t *block_get_ptr(struct btree_filesystem *fs, uint32_t block_num);
+int block_read(struct btree_filesystem *fs, uint32_t block_num, uint32_t count, void *buf);
+int block_write(struct btree_filesystem *fs, uint32_t block_num, uint32_t count, const void *buf);
 int block_is_allocated(struct btree_filesystem *fs, uint32_t block_num);
 
+// Extent operations (extent.c)
+struct inode_extent *extent_find(struct inode *inode, uint32_t block_idx);
+struct inode_extent *extent_next(struct inode *inode, uint32_t block_idx);
+int extent_map_run(struct btree_filesystem *fs, struct inode *inode, uint32_t block_idx,
+                   uint32_t count, uint32_t *start, uint32_t *length);
+void extent_truncate(struct btree_filesystem *fs, struct inode *inode, uint32_t first_block);
+void extent_punch(struct btree_filesystem *fs, struct inode *inode, uint32_t first_block, uint32_t count);
+int extent_add(struct inode *inode, uint32_t logical, uint32_t start, uint32_t length, uint32_t stored);
+void extent_print(struct inode *inode);
+
+// Transparent compression (compress.c): one page-cache page is one cluster
+int compress_read_cluster(struct btree_filesystem *fs, struct inode_extent *ext, uint8_t *out);
+int compress_write_cluster(struct btree_filesystem *fs, struct inode *inode, uint32_t index,
+                           const uint8_t *data, uint32_t len);
+
 // File operations using B-Tree and i-nodes
 int btree_fs_create(struct btree_filesystem *fs, const char *filename, uint32_t type);
 int btree_fs_open(struct btree_filesystem *fs, const char *filename);
 int btree_fs_read(struct btree_filesystem *fs, const char *filename, void *buffer, uint32_t size);
 int btree_fs_write(struct btree_filesystem *fs, const char *filename, const void *data, uint32_t size);
+int btree_fs_fsync(struct btree_filesystem *fs, const char *filename);
+int btree_fs_set_compress(struct btree_filesystem *fs, const char *filename, int enable);
+
+// Open files (reads and writes continue from the file position)
+struct btree_file *btree_file_open(struct btree_filesystem *fs, const char *filename);
+int btree_file_read(struct btree_file *file, void *buffer, uint32_t size);
+int btree_file_write(struct btree_file *file, const void *data, uint32_t size);
+int btree_file_seek(struct btree_file *file, uint32_t pos);
+void btree_file_close(struct btree_file *file);
+
+// 흩어진 조각을 파일 위치에서 이어서 읽기/쓰기 (쓰기는 전체 범위의 블록을 한 번에 매핑)
+int btree_file_readv(struct btree_file *file, const struct iovec *iov, int iovcnt);
+int btree_file_writev(struct btree_file *file, const struct iovec *iov, int iovcnt);
 int btree_fs_delete(struct btree_filesystem *fs, const char *filename);
 void btree_fs_list(struct btree_filesystem *fs);
 void btree_fs_stat(struct btree_filesystem *fs, const char *filename);
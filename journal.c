@@ -0,0 +1,318 @@
+#include "journal.h"
+#include "inode.h"
+#include "bitmap.h"
+#include "string.h"
+
+// 트랜잭션 이미지에서 k번째 사본의 위치: 사본 FS_JOURNAL_TAGS개마다 디스크립터가 하나 앞섬
+static uint32_t journal_slot(uint32_t k) {
+    return (k / FS_JOURNAL_TAGS) * (FS_JOURNAL_TAGS + 1) + 1 + k % FS_JOURNAL_TAGS;
+}
+
+static struct journal_descriptor *journal_descriptor(struct journal *j, uint32_t k) {
+    return (struct journal_descriptor *)(j->image + (k / FS_JOURNAL_TAGS) * (FS_JOURNAL_TAGS + 1) * FS_BLOCK_SIZE);
+}
+
+static uint8_t *journal_copy(struct journal *j, uint32_t k) {
+    return j->image + journal_slot(k) * FS_BLOCK_SIZE;
+}
+
+static uint32_t journal_tag(struct journal *j, uint32_t k) {
+    return journal_descriptor(j, k)->tags[k % FS_JOURNAL_TAGS];
+}
+
+// 디스크립터와 사본이 차지하는 블록 수 (커밋 블록 제외)
+static uint32_t journal_used(uint32_t count) {
+    return count ? journal_slot(count - 1) + 1 : 0;
+}
+
+static uint32_t journal_checksum(uint32_t hash, const uint8_t *data, uint32_t len) {
+    for (uint32_t i = 0; i < len; i++) {
+        hash = ((hash << 5) + hash) + data[i];
+    }
+    return hash;
+}
+
+int journal_init(struct btree_filesystem *fs) {
+    struct journal *j = &fs->journal;
+    uint32_t area = fs->sb.journal_blocks;
+    uint32_t bitmap_bytes = fs->sb.block_bitmap_blocks * FS_BLOCK_SIZE;
+
+    // One block of the area is the commit block
+    uint32_t groups = (area - 1 + FS_JOURNAL_TAGS) / (FS_JOURNAL_TAGS + 1);
+    j->start = fs->sb.journal_start;
+    j->capacity = area - 1 - groups;
+    j->seq = fs->sb.journal_seq;
+    j->count = 0;
+    j->ops = 0;
+    j->opened_at = 0;
+    j->commits = 0;
+    j->committed_ops = 0;
+    j->logged_blocks = 0;
+
+    j->image = (uint8_t *)kmalloc((area - 1) * FS_BLOCK_SIZE);
+    j->new_blocks = (uint32_t *)kmalloc(bitmap_bytes);
+    j->freed_blocks = (uint32_t *)kmalloc(bitmap_bytes);
+    if (!j->image || !j->new_blocks || !j->freed_blocks) {
+        printf("Error: No memory for the journal\n");
+        journal_destroy(fs);
+        return -1;
+    }
+    bitmap_init(j->new_blocks, bitmap_bytes * 8);
+    bitmap_init(j->freed_blocks, bitmap_bytes * 8);
+    return 0;
+}
+
+void journal_destroy(struct btree_filesystem *fs) {
+    struct journal *j = &fs->journal;
+    kfree(j->image);
+    kfree(j->new_blocks);
+    kfree(j->freed_blocks);
+    j->image = NULL;
+    j->new_blocks = NULL;
+    j->freed_blocks = NULL;
+}
+
+static int journal_find(struct journal *j, uint32_t block) {
+    for (uint32_t k = 0; k < j->count; k++) {
+        if (journal_tag(j, k) == block) {
+            return (int)k;
+        }
+    }
+    return -1;
+}
+
+int journal_read(struct btree_filesystem *fs, uint32_t block, void *buf) {
+    struct journal *j = &fs->journal;
+    int k = journal_find(j, block);
+    if (k < 0) {
+        return block_read(fs, block, 1, buf);
+    }
+
+    memcpy(buf, journal_copy(j, k), FS_BLOCK_SIZE);
+    return 0;
+}
+
+int journal_write(struct btree_filesystem *fs, uint32_t block, const void *buf) {
+    struct journal *j = &fs->journal;
+    int k = journal_find(j, block);
+    if (k < 0) {
+        if (j->count == j->capacity) {
+            return -1;
+        }
+        k = (int)j->count++;
+        journal_descriptor(j, k)->tags[k % FS_JOURNAL_TAGS] = block;
+    }
+    block_csum_set(fs, block, 1, buf);
+
+    memcpy(journal_copy(j, k), buf, FS_BLOCK_SIZE);
+    return 0;
+}
+
+uint32_t journal_space(struct btree_filesystem *fs) {
+    return fs->journal.capacity - fs->journal.count;
+}
+
+void journal_note_op(struct btree_filesystem *fs) {
+    struct journal *j = &fs->journal;
+    if (j->ops++ == 0) {
+        j->opened_at = read_time();
+    }
+}
+
+int journal_should_commit(struct btree_filesystem *fs) {
+    struct journal *j = &fs->journal;
+    return j->ops >= JOURNAL_COMMIT_OPS ||
+           (j->ops > 0 && read_time() - j->opened_at >= JOURNAL_COMMIT_INTERVAL);
+}
+
+void journal_block_allocated(struct btree_filesystem *fs, uint32_t start, uint32_t count) {
+    bitmap_set_range(fs->journal.new_blocks, start, count);
+}
+
+// 이번 트랜잭션에서 할당한 블록이면 바로 해제해도 되므로 0, 미뤄야 하면 1
+int journal_block_freed(struct btree_filesystem *fs, uint32_t block) {
+    struct journal *j = &fs->journal;
+    if (bitmap_test(j->new_blocks, block)) {
+        bitmap_clear(j->new_blocks, block);
+        return 0;
+    }
+    bitmap_set(j->freed_blocks, block);
+    return 1;
+}
+
+// 미뤄 둔 해제를 비트맵에 반영 (비트맵을 트랜잭션에 기록하기 직전에 호출)
+void journal_release_freed(struct btree_filesystem *fs) {
+    uint32_t words = fs->sb.block_bitmap_blocks * FS_BLOCK_SIZE / sizeof(uint32_t);
+    for (uint32_t w = 0; w < words; w++) {
+        fs->block_bitmap[w] &= ~fs->journal.freed_blocks[w];
+        fs->journal.freed_blocks[w] = 0;
+    }
+}
+
+// 제자리 기록: 블록 번호가 이어지는 사본은 조각 목록으로 묶어 요청 하나로
+static int journal_checkpoint(struct btree_filesystem *fs, int superblock) {
+    struct journal *j = &fs->journal;
+    uint32_t k = 0;
+    while (k < j->count) {
+        uint32_t home = journal_tag(j, k);
+        if ((home == 0) != superblock) {
+            k++;
+            continue;
+        }
+
+        struct blkdev_segment segs[BLKDEV_MAX_SEGMENTS];
+        int nsegs = 0;
+        uint32_t n = 0;
+        while (k + n < j->count && nsegs < BLKDEV_MAX_SEGMENTS && journal_tag(j, k + n) == home + n &&
+               (home + n == 0) == superblock) {
+            segs[nsegs].buf = journal_copy(j, k + n);
+            segs[nsegs].count = 1;
+            nsegs++;
+            n++;
+        }
+        if (blkdev_write_segments(fs->dev, home, segs, nsegs) < 0) {
+            return -1;
+        }
+        k += n;
+    }
+    return blkdev_flush(fs->dev);
+}
+
+int journal_commit(struct btree_filesystem *fs) {
+    struct journal *j = &fs->journal;
+    if (j->count == 0) {
+        j->ops = 0;
+        return 0;
+    }
+
+    // Descriptors and copies in one request, then the commit block once they are stable
+    uint32_t used = journal_used(j->count);
+    uint32_t checksum = j->seq;
+    for (uint32_t k = 0; k < j->count; k += FS_JOURNAL_TAGS) {
+        struct journal_descriptor *desc = journal_descriptor(j, k);
+        desc->header.magic = FS_JOURNAL_MAGIC;
+        desc->header.type = FS_JOURNAL_DESCRIPTOR;
+        desc->header.seq = j->seq;
+        desc->header.count = j->count - k < FS_JOURNAL_TAGS ? j->count - k : FS_JOURNAL_TAGS;
+    }
+    for (uint32_t k = 0; k < j->count; k++) {
+        uint32_t tag = journal_tag(j, k);
+        checksum = journal_checksum(checksum, (const uint8_t *)&tag, sizeof(tag));
+        checksum = journal_checksum(checksum, journal_copy(j, k), FS_BLOCK_SIZE);
+    }
+    if (blkdev_write(fs->dev, j->start, used, j->image) < 0 || blkdev_flush(fs->dev) < 0) {
+        return -1;
+    }
+
+    uint8_t block[FS_BLOCK_SIZE];
+    memset(block, 0, FS_BLOCK_SIZE);
+    struct journal_commit *commit = (struct journal_commit *)block;
+    commit->header.magic = FS_JOURNAL_MAGIC;
+    commit->header.type = FS_JOURNAL_COMMIT;
+    commit->header.seq = j->seq;
+    commit->header.count = j->count;
+    commit->checksum = checksum;
+    if (blkdev_write(fs->dev, j->start + used, 1, block) < 0 || blkdev_flush(fs->dev) < 0) {
+        return -1;
+    }
+
+    // The superblock goes home last: its journal_seq moving past this transaction
+    // is what tells a later mount there is nothing left to replay
+    if (journal_checkpoint(fs, 0) < 0 || journal_checkpoint(fs, 1) < 0) {
+        return -1;
+    }
+
+    j->commits++;
+    j->committed_ops += j->ops;
+    j->logged_blocks += j->count;
+    j->seq++;
+    j->count = 0;
+    j->ops = 0;
+    bitmap_init(j->new_blocks, fs->sb.block_bitmap_blocks * FS_BITS_PER_BLOCK);
+    return 0;
+}
+
+int journal_replay(struct block_device *dev, const struct fs_superblock *sb) {
+    uint8_t block[FS_BLOCK_SIZE];
+    struct journal_descriptor *desc = (struct journal_descriptor *)block;
+
+    // Walk the descriptors of the transaction the superblock is waiting for
+    uint32_t count = 0;
+    uint32_t slot = 0;
+    for (;;) {
+        if (slot >= sb->journal_blocks || blkdev_read(dev, sb->journal_start + slot, 1, block) < 0) {
+            return -1;
+        }
+        if (desc->header.magic != FS_JOURNAL_MAGIC || desc->header.type != FS_JOURNAL_DESCRIPTOR ||
+            desc->header.seq != sb->journal_seq || desc->header.count > FS_JOURNAL_TAGS) {
+            break;
+        }
+        count += desc->header.count;
+        slot += desc->header.count + 1;
+        if (desc->header.count < FS_JOURNAL_TAGS) {
+            break;
+        }
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    uint32_t used = journal_used(count);
+    if (used + 1 > sb->journal_blocks || blkdev_read(dev, sb->journal_start + used, 1, block) < 0) {
+        return 0;
+    }
+    struct journal_commit *commit = (struct journal_commit *)block;
+    if (commit->header.magic != FS_JOURNAL_MAGIC || commit->header.type != FS_JOURNAL_COMMIT ||
+        commit->header.seq != sb->journal_seq || commit->header.count != count) {
+        printf("Journal: transaction %u was not committed, discarded\n", sb->journal_seq);
+        return 0;
+    }
+    uint32_t expected = commit->checksum;
+
+    uint8_t *image = (uint8_t *)kmalloc(used * FS_BLOCK_SIZE);
+    if (!image) {
+        return -1;
+    }
+    if (blkdev_read(dev, sb->journal_start, used, image) < 0) {
+        kfree(image);
+        return -1;
+    }
+
+    struct journal j;
+    j.image = image;
+    uint32_t checksum = sb->journal_seq;
+    for (uint32_t k = 0; k < count; k++) {
+        uint32_t tag = journal_tag(&j, k);
+        checksum = journal_checksum(checksum, (const uint8_t *)&tag, sizeof(tag));
+        checksum = journal_checksum(checksum, journal_copy(&j, k), FS_BLOCK_SIZE);
+    }
+    if (checksum != expected) {
+        printf("Journal: transaction %u has a bad checksum, discarded\n", sb->journal_seq);
+        kfree(image);
+        return 0;
+    }
+
+    // Same order as a checkpoint: everything else, then the superblock
+    int result = 1;
+    for (int pass = 0; pass < 2 && result > 0; pass++) {
+        for (uint32_t k = 0; k < count; k++) {
+            uint32_t home = journal_tag(&j, k);
+            if ((home == 0) != pass) {
+                continue;
+            }
+            if (home >= sb->total_blocks || blkdev_write(dev, home, 1, journal_copy(&j, k)) < 0) {
+                result = -1;
+                break;
+            }
+        }
+        if (result > 0 && blkdev_flush(dev) < 0) {
+            result = -1;
+        }
+    }
+    kfree(image);
+
+    if (result > 0) {
+        printf("Journal: replayed transaction %u (%u blocks)\n", sb->journal_seq, count);
+    }
+    return result;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "kernel.h"
+
+struct btree_filesystem;
+struct block_device;
+struct fs_superblock;
+
+// 메타데이터 저널 (물리 블록 단위 redo 로그)
+// 메타데이터 블록은 제자리에 쓰지 않고 실행 중인 트랜잭션에 사본으로 모았다가,
+// 커밋할 때 저널 영역에 한 번에 기록한 뒤 제자리로 옮김 (checkpoint)
+// 여러 연산이 트랜잭션 하나를 함께 씀 (group commit)
+#define JOURNAL_COMMIT_OPS 64                    // Commit once this many updates are waiting
+#define JOURNAL_COMMIT_INTERVAL 50000000ULL      // or the oldest is 5 s old (10 MHz timer)
+
+struct journal {
+    uint32_t start;                              // First block of the on-disk journal area
+    uint32_t capacity;                           // Block copies one transaction can hold
+    uint32_t seq;                                // Sequence number of the running transaction
+    uint8_t *image;                              // Descriptors and copies, laid out as on disk
+    uint32_t count;                              // Copies logged so far
+    uint32_t ops;                                // Metadata updates since the last commit
+    uint64_t opened_at;                          // Time of the first of them
+    uint32_t *new_blocks;                        // Allocated since the last commit (bitmap)
+    uint32_t *freed_blocks;                      // Freed since the last commit, reusable after it
+    uint32_t commits;                            // Transactions committed
+    uint32_t committed_ops;                      // Updates they carried
+    uint32_t logged_blocks;                      // Block copies they carried
+};
+
+int journal_init(struct btree_filesystem *fs);
+void journal_destroy(struct btree_filesystem *fs);
+
+// 메타데이터 블록 읽기/기록 (기록은 트랜잭션의 사본만 바꿈, 자리가 없으면 -1)
+int journal_read(struct btree_filesystem *fs, uint32_t block, void *buf);
+int journal_write(struct btree_filesystem *fs, uint32_t block, const void *buf);
+uint32_t journal_space(struct btree_filesystem *fs);
+
+// 메타데이터 변경 하나를 기록해 두고, 커밋할 때가 되었는지 확인
+void journal_note_op(struct btree_filesystem *fs);
+int journal_should_commit(struct btree_filesystem *fs);
+
+// 블록 할당/해제 추적: 커밋된 메타데이터가 가리키던 블록은 커밋 전까지 재사용하지 않음
+void journal_block_allocated(struct btree_filesystem *fs, uint32_t start, uint32_t count);
+int journal_block_freed(struct btree_filesystem *fs, uint32_t block);
+void journal_release_freed(struct btree_filesystem *fs);
+
+// 트랜잭션 커밋: 저널 기록 -> 커밋 블록 -> 제자리 기록 (슈퍼블록이 마지막)
+int journal_commit(struct btree_filesystem *fs);
+
+// 마운트 전에 커밋되었지만 제자리에 옮기지 못한 트랜잭션 재실행 (재실행하면 1)
+int journal_replay(struct block_device *dev, const struct fs_superblock *sb);
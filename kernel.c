@@ -1,15 +1,18 @@
 #include "kernel.h"
 #include "common.h"
+#include "inode.h"
+#include "vm.h"
+#include "uring.h"
+#include "vfs.h"
+#include "string.h"
+#include "console.h"
+#include "log.h"
+#include "trace.h"
 
 extern char bss[], bss_end[], __stack_top[];
 extern char __free_ram[], __free_ram_end[];
 
 
-void putchar(char ch) {
-    sbi_call(ch, 0, 0, 0, 0, 0, 0, 1);
-}
-
-
 
 paddr_t alloc_pages(uint32_t n) {
     static paddr_t next_paddr = (paddr_t) __free_ram;
@@ -24,10 +27,26 @@ paddr_t alloc_pages(uint32_t n) {
 }
 
 
+void spin_init(struct spinlock *lock) {
+    lock->locked = 0;
+}
+
+void spin_lock(struct spinlock *lock) {
+    while (__atomic_exchange_n(&lock->locked, 1, __ATOMIC_ACQUIRE)) {
+        while (lock->locked) {}
+    }
+}
+
+void spin_unlock(struct spinlock *lock) {
+    __atomic_store_n(&lock->locked, 0, __ATOMIC_RELEASE);
+}
+
 void handle_trap(struct trap_frame *f) {
     uint32_t scause = READ_CSR(scause);
     uint32_t stval = READ_CSR(stval);
     uint32_t user_pc = READ_CSR(sepc);
+    // kernel_entry saves only the integer registers: the interrupted code may be mid vector loop
+    mem_trap_enter();
     
     if (scause & SCAUSE_INTERRUPT) {
         uint32_t interrupt_type = scause & 0x7FFFFFFF;
@@ -39,84 +58,169 @@ void handle_trap(struct trap_frame *f) {
     } else if (scause == SCAUSE_ECALL) {
         handle_syscall(f);
         user_pc += 4;
+    } else if ((scause == SCAUSE_LOAD_PAGE_FAULT || scause == SCAUSE_STORE_PAGE_FAULT) &&
+               vm_handle_fault(vm_current, stval, scause == SCAUSE_STORE_PAGE_FAULT) == 0) {
+        // Demand-mapped page: the faulting instruction runs again
     } else {
         PANIC("unexpected trap scause=%x, stval=%x, sepc=%x\n", scause, stval, user_pc);
     }
 
+    mem_trap_exit();
     WRITE_CSR(sepc, user_pc);
 }
  
 struct process processes[MAX_PROCESSES];
 struct process *current_proc = NULL;
+static vaddr_t boot_sp;                          // Boot flow (kernel_main) while processes run
+
+// 준비 큐 (FIFO, 꺼낸 순서가 곧 라운드로빈)와 빈 슬롯 목록: 둘 다 process.next로 연결
+// 큐에 있는지는 상태가 아니라 on_rq로 판단 (깨우기가 schedule보다 먼저 올 수 있음)
+// 목록은 인터럽트를 끈 채로 고침: process_wake는 인터럽트 경로에서도 부를 수 있음
+static struct process *ready_head, *ready_tail;
+static struct process *free_procs;
+
+static void ready_push(struct process *proc) {
+    uint32_t irq = interrupts_disable();
+    if (!proc->on_rq) {
+        proc->on_rq = 1;
+        proc->next = NULL;
+        if (ready_tail) {
+            ready_tail->next = proc;
+        } else {
+            ready_head = proc;
+        }
+        ready_tail = proc;
+    }
+    interrupts_restore(irq);
+}
+
+static struct process *ready_pop(void) {
+    uint32_t irq = interrupts_disable();
+    struct process *proc = ready_head;
+    if (proc) {
+        ready_head = proc->next;
+        if (!ready_head) {
+            ready_tail = NULL;
+        }
+        proc->on_rq = 0;
+    }
+    interrupts_restore(irq);
+    return proc;
+}
+
+// 큐 중간에서 빼기 (깨어난 뒤 schedule 없이 끝나는 드문 경우만)
+static void ready_remove(struct process *proc) {
+    uint32_t irq = interrupts_disable();
+    if (proc->on_rq) {
+        struct process **link = &ready_head;
+        struct process *before = NULL;
+        while (*link != proc) {
+            before = *link;
+            link = &(*link)->next;
+        }
+        *link = proc->next;
+        if (ready_tail == proc) {
+            ready_tail = before;
+        }
+        proc->on_rq = 0;
+    }
+    interrupts_restore(irq);
+}
 
 void scheduler_init(void) {
-    for (int i = 0; i < MAX_PROCESSES; i++) {
+    free_procs = NULL;
+    // Pushed in reverse so slot 0 is handed out first
+    for (int i = MAX_PROCESSES - 1; i >= 0; i--) {
         processes[i].pid = i;
         processes[i].state = PROC_UNUSED;
         processes[i].sp = 0;
-        processes[i].page_table = NULL;
-        processes[i].trap_frame = NULL;
+        processes[i].vm = NULL;
+        processes[i].entry = NULL;
+        processes[i].on_rq = 0;
+        processes[i].next = free_procs;
+        free_procs = &processes[i];
     }
+    ready_head = ready_tail = NULL;
     current_proc = NULL;
 }
 
+// 새 프로세스가 처음 switch_context에서 돌아오는 곳
+static void process_start(void) {
+    current_proc->entry();
+    process_exit();
+}
+
+// 커널 스택 맨 위에 switch_context 프레임을 만들어 둠: 처음 전환되면 process_start로 돌아감
+void process_init_context(struct process *proc, void (*entry_point)(void)) {
+    uint32_t *frame = (uint32_t *)&proc->stack[STACK_SIZE - SWITCH_FRAME_SIZE];
+    memset(frame, 0, SWITCH_FRAME_SIZE);
+    frame[0] = (uint32_t)process_start;          // ra
+    proc->entry = entry_point;
+    proc->sp = (vaddr_t)frame;
+}
+
 struct process *create_process(void (*entry_point)(void)) {
-    struct process *proc = NULL;
-    
-    for (int i = 0; i < MAX_PROCESSES; i++) {
-        if (processes[i].state == PROC_UNUSED) {
-            proc = &processes[i];
-            break;
-        }
+    uint32_t irq = interrupts_disable();
+    struct process *proc = free_procs;
+    if (proc) {
+        free_procs = proc->next;
     }
-    
+    interrupts_restore(irq);
     if (!proc) {
         printf("No free process slots\n");
         return NULL;
     }
 
     proc->state = PROC_READY;
-    proc->sp = (vaddr_t)&proc->stack[STACK_SIZE - sizeof(struct trap_frame)];
-    proc->trap_frame = (struct trap_frame *)proc->sp;
+    proc->vm = NULL;
+    process_init_context(proc, entry_point);
+    ready_push(proc);
     
-    memset(proc->trap_frame, 0, sizeof(struct trap_frame));
-    proc->trap_frame->ra = (uint32_t)entry_point;
-    proc->trap_frame->sp = (uint32_t)&proc->stack[STACK_SIZE - 8];
-    
-    printf("Created process %d\n", proc->pid);
+    trace(TRACE_PROC_CREATE, proc->pid, 0, 0);
+    LOG_DEBUG("Created process %d\n", proc->pid);
     return proc;
 }
 
+// 다음 READY 프로세스로 전환 (callee-saved 레지스터만 switch_context가 저장)
+// 부팅 흐름에서 부르면 실행할 프로세스가 없어질 때까지 돌아오지 않음
 void schedule(void) {
-    struct process *next = NULL;
-    
-    if (current_proc && current_proc->state == PROC_RUNNING) {
-        current_proc->state = PROC_READY;
+    struct process *prev = current_proc;
+    if (btree_in_read_section()) {
+        // The per-hart read section would be closed by whichever task runs next
+        PANIC("schedule inside a B-Tree read section");
     }
     
-    int start = current_proc ? (current_proc->pid + 1) % MAX_PROCESSES : 0;
-    for (int i = 0; i < MAX_PROCESSES; i++) {
-        int idx = (start + i) % MAX_PROCESSES;
-        if (processes[idx].state == PROC_READY) {
-            next = &processes[idx];
-            break;
-        }
+    // Still runnable (preempted, or yield marked it READY): back of the queue,
+    // unless a wakeup already queued it
+    if (prev && (prev->state == PROC_RUNNING || prev->state == PROC_READY)) {
+        prev->state = PROC_READY;
+        ready_push(prev);
     }
     
+    struct process *next = ready_pop();
     if (!next) {
-        printf("No ready processes\n");
+        LOG_DEBUG("No ready processes\n");
+        if (prev) {
+            // prev exited or blocked: back to the boot flow
+            current_proc = NULL;
+            trace(TRACE_SCHED_SWITCH, prev->pid, (uint32_t)-1, 0);
+            vm_activate(NULL);
+            switch_context((uint32_t **)&prev->sp, (uint32_t *)boot_sp);
+        }
         return;
     }
     
-    struct process *prev = current_proc;
+    next->state = PROC_RUNNING;
+    if (next == prev) {
+        return;
+    }
     current_proc = next;
-    current_proc->state = PROC_RUNNING;
     
-    printf("Switching to process %d\n", current_proc->pid);
+    trace(TRACE_SCHED_SWITCH, prev ? (uint32_t)prev->pid : (uint32_t)-1, next->pid, 0);
+    LOG_DEBUG("Switching to process %d\n", next->pid);
     
-    if (prev) {
-        context_switch(prev, current_proc);
-    }
+    vm_activate(next->vm);
+    switch_context((uint32_t **)(prev ? &prev->sp : &boot_sp), (uint32_t *)next->sp);
 }
 
 void yield(void) {
@@ -126,89 +230,31 @@ void yield(void) {
     }
 }
 
+void process_wake(struct process *proc) {
+    uint32_t irq = interrupts_disable();
+    if (proc->state == PROC_BLOCKED) {
+        proc->state = PROC_READY;
+        ready_push(proc);
+    }
+    interrupts_restore(irq);
+}
+
+// 슬롯을 빈 목록에 돌려주고 전환: 지금 쓰는 커널 스택은 다음 create_process 전까지 그대로 남음
 void process_exit(void) {
     if (current_proc) {
         printf("Process %d exiting\n", current_proc->pid);
+        vm_destroy(current_proc->vm);
+        current_proc->vm = NULL;
+        uint32_t irq = interrupts_disable();
         current_proc->state = PROC_UNUSED;
-        current_proc = NULL;
+        ready_remove(current_proc);
+        current_proc->next = free_procs;
+        free_procs = current_proc;
+        interrupts_restore(irq);
         schedule();
     }
 }
 
-void context_switch(struct process *prev, struct process *next) {
-    struct trap_frame *prev_frame = prev->trap_frame;
-    struct trap_frame *next_frame = next->trap_frame;
-    
-    __asm__ __volatile__(
-        "sw ra, 4 * 0(%0)\n"
-        "sw gp, 4 * 1(%0)\n"
-        "sw tp, 4 * 2(%0)\n"
-        "sw t0, 4 * 3(%0)\n"
-        "sw t1, 4 * 4(%0)\n"
-        "sw t2, 4 * 5(%0)\n"
-        "sw t3, 4 * 6(%0)\n"
-        "sw t4, 4 * 7(%0)\n"
-        "sw t5, 4 * 8(%0)\n"
-        "sw t6, 4 * 9(%0)\n"
-        "sw a0, 4 * 10(%0)\n"
-        "sw a1, 4 * 11(%0)\n"
-        "sw a2, 4 * 12(%0)\n"
-        "sw a3, 4 * 13(%0)\n"
-        "sw a4, 4 * 14(%0)\n"
-        "sw a5, 4 * 15(%0)\n"
-        "sw a6, 4 * 16(%0)\n"
-        "sw a7, 4 * 17(%0)\n"
-        "sw s0, 4 * 18(%0)\n"
-        "sw s1, 4 * 19(%0)\n"
-        "sw s2, 4 * 20(%0)\n"
-        "sw s3, 4 * 21(%0)\n"
-        "sw s4, 4 * 22(%0)\n"
-        "sw s5, 4 * 23(%0)\n"
-        "sw s6, 4 * 24(%0)\n"
-        "sw s7, 4 * 25(%0)\n"
-        "sw s8, 4 * 26(%0)\n"
-        "sw s9, 4 * 27(%0)\n"
-        "sw s10, 4 * 28(%0)\n"
-        "sw s11, 4 * 29(%0)\n"
-        "sw sp, 4 * 30(%0)\n"
-
-        "lw ra, 4 * 0(%1)\n"
-        "lw gp, 4 * 1(%1)\n"
-        "lw tp, 4 * 2(%1)\n"
-        "lw t0, 4 * 3(%1)\n"
-        "lw t1, 4 * 4(%1)\n"
-        "lw t2, 4 * 5(%1)\n"
-        "lw t3, 4 * 6(%1)\n"
-        "lw t4, 4 * 7(%1)\n"
-        "lw t5, 4 * 8(%1)\n"
-        "lw t6, 4 * 9(%1)\n"
-        "lw a0, 4 * 10(%1)\n"
-        "lw a1, 4 * 11(%1)\n"
-        "lw a2, 4 * 12(%1)\n"
-        "lw a3, 4 * 13(%1)\n"
-        "lw a4, 4 * 14(%1)\n"
-        "lw a5, 4 * 15(%1)\n"
-        "lw a6, 4 * 16(%1)\n"
-        "lw a7, 4 * 17(%1)\n"
-        "lw s0, 4 * 18(%1)\n"
-        "lw s1, 4 * 19(%1)\n"
-        "lw s2, 4 * 20(%1)\n"
-        "lw s3, 4 * 21(%1)\n"
-        "lw s4, 4 * 22(%1)\n"
-        "lw s5, 4 * 23(%1)\n"
-        "lw s6, 4 * 24(%1)\n"
-        "lw s7, 4 * 25(%1)\n"
-        "lw s8, 4 * 26(%1)\n"
-        "lw s9, 4 * 27(%1)\n"
-        "lw s10, 4 * 28(%1)\n"
-        "lw s11, 4 * 29(%1)\n"
-        "lw sp, 4 * 30(%1)\n"
-        :
-        : "r" (prev_frame), "r" (next_frame)
-        : "memory"
-    );
-}
-
 void process_a(void) {
     for (int i = 0; i < 5; i++) {
         printf("Process A: iteration %d\n", i);
@@ -349,70 +395,112 @@ void test_memory_allocation(void) {
 
 static struct filesystem fs;
 
-int strcmp(const char *s1, const char *s2) {
-    while (*s1 && (*s1 == *s2)) {
-        s1++;
-        s2++;
-    }
-    return *(unsigned char*)s1 - *(unsigned char*)s2;
+// 슬롯 번호를 담을 버킷 (해시를 섞어 비슷한 이름이 한쪽에 몰리지 않게 함)
+static uint32_t fs_bucket(uint32_t hash) {
+    return (hash * 2654435761u) & fs.bucket_mask;
 }
 
-int strlen(const char *s) {
-    int len = 0;
-    while (*s++) len++;
-    return len;
-}
+// 이름의 버킷 찾기: 있으면 그 버킷, 없으면 -1 (free가 있으면 넣을 수 있는 첫 버킷을 돌려줌)
+static int fs_probe(const char *filename, uint32_t hash, int *free) {
+    int first_free = -1;
+    uint32_t b = fs_bucket(hash);
 
-const char *strchr(const char *s, int c) {
-    while (*s) {
-        if (*s == c) return s;
-        s++;
+    for (uint32_t n = 0; n <= fs.bucket_mask; n++, b = (b + 1) & fs.bucket_mask) {
+        int32_t slot = fs.buckets[b];
+        if (slot == FS_BUCKET_EMPTY) {
+            if (first_free < 0) {
+                first_free = b;
+            }
+            break;
+        }
+        if (slot == FS_BUCKET_DELETED) {
+            if (first_free < 0) {
+                first_free = b;
+            }
+        } else if (fs.files[slot].hash == hash && strcmp(fs.files[slot].name, filename) == 0) {
+            return b;
+        }
     }
-    return (c == '\0') ? s : NULL;
-}
 
-const char *strstr(const char *haystack, const char *needle) {
-    if (!*needle) return haystack;
-    
-    for (const char *h = haystack; *h; h++) {
-        const char *h2 = h;
-        const char *n = needle;
-        
-        while (*h2 && *n && *h2 == *n) {
-            h2++;
-            n++;
-        }
-        
-        if (!*n) return h;
+    if (free) {
+        *free = first_free;
     }
-    
-    return NULL;
+    return -1;
 }
 
-int sscanf(const char *str, const char *format, ...) {
-    return 0;
+static struct file *fs_lookup(const char *filename) {
+    int b = fs_probe(filename, hash_string(filename), NULL);
+    return b < 0 ? NULL : &fs.files[fs.buckets[b]];
 }
 
-void strcpy(char *dest, const char *src) {
-    while (*src) {
-        *dest++ = *src++;
+// 슬롯 배열과 버킷 테이블 (다시) 만들기: 파일은 번호 그대로 옮기고 버킷은 새로 채움 (묘비도 사라짐)
+static int fs_resize(uint32_t capacity) {
+    uint32_t buckets = 1;
+    while (buckets < capacity * 2) {
+        buckets <<= 1;
     }
-    *dest = '\0';
-}
 
-int snprintf(char *str, size_t size, const char *format, ...) {
-    strcpy(str, "Basic snprintf implementation");
-    return strlen(str);
+    struct file *files = (struct file *)kmalloc(capacity * sizeof(struct file));
+    int32_t *table = (int32_t *)kmalloc(buckets * sizeof(int32_t));
+    uint32_t *free_slots = (uint32_t *)kmalloc(capacity * sizeof(uint32_t));
+    if (!files || !table || !free_slots) {
+        kfree(files);
+        kfree(table);
+        kfree(free_slots);
+        printf("No memory to grow the file table\n");
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < capacity; i++) {
+        if (i < fs.capacity) {
+            files[i] = fs.files[i];
+        } else {
+            files[i].is_used = 0;
+            files[i].pages = NULL;
+            files[i].page_slots = 0;
+            files[i].size = 0;
+        }
+    }
+    for (uint32_t i = 0; i < buckets; i++) {
+        table[i] = FS_BUCKET_EMPTY;
+    }
+
+    kfree(fs.files);
+    kfree(fs.buckets);
+    kfree(fs.free_slots);
+    fs.files = files;
+    fs.capacity = capacity;
+    fs.buckets = table;
+    fs.bucket_mask = buckets - 1;
+    fs.free_slots = free_slots;
+    fs.tombstones = 0;
+
+    // Free slots are popped from the top, lowest number first
+    fs.free_top = 0;
+    for (uint32_t i = capacity; i-- > 0;) {
+        if (!files[i].is_used) {
+            fs.free_slots[fs.free_top++] = i;
+            continue;
+        }
+        uint32_t b = fs_bucket(files[i].hash);
+        while (fs.buckets[b] != FS_BUCKET_EMPTY) {
+            b = (b + 1) & fs.bucket_mask;
+        }
+        fs.buckets[b] = i;
+    }
+    return 0;
 }
 
 void fs_init(void) {
-    for (int i = 0; i < MAX_FILES; i++) {
-        fs.files[i].is_used = 0;
-        fs.files[i].data = NULL;
-        fs.files[i].size = 0;
-    }
+    fs.files = NULL;
+    fs.buckets = NULL;
+    fs.free_slots = NULL;
+    fs.capacity = 0;
     fs.file_count = 0;
-    printf("Filesystem initialized: %d file slots available\n", MAX_FILES);
+    if (fs_resize(FS_INITIAL_FILES) < 0) {
+        PANIC("Failed to allocate the file table");
+    }
+    printf("Filesystem initialized: %d file slots available\n", FS_INITIAL_FILES);
 }
 
 int fs_create(const char *filename, size_t size) {
@@ -420,94 +508,206 @@ int fs_create(const char *filename, size_t size) {
         printf("File size too large: %d bytes (max: %d)\n", (int)size, MAX_FILESIZE);
         return -1;
     }
-    
-    if (fs_exists(filename)) {
+    if (strlen(filename) >= MAX_FILENAME) {
+        printf("File name too long: '%s'\n", filename);
+        return -1;
+    }
+
+    // One probe answers both "does it exist" and "where does it go"
+    uint32_t hash = hash_string(filename);
+    int b;
+    if (fs_probe(filename, hash, &b) >= 0) {
         printf("File '%s' already exists\n", filename);
         return -1;
     }
-    
-    for (int i = 0; i < MAX_FILES; i++) {
-        if (!fs.files[i].is_used) {
-            strcpy(fs.files[i].name, filename);
-            fs.files[i].data = (uint8_t *)kmalloc(size);
-            if (!fs.files[i].data) {
-                printf("Failed to allocate memory for file '%s'\n", filename);
-                return -1;
-            }
-            fs.files[i].size = size;
-            fs.files[i].is_used = 1;
-            fs.file_count++;
-            printf("Created file '%s' (%d bytes)\n", filename, (int)size);
-            return i;
+
+    // Out of slots, or too many tombstones for short probes: rebuild (bigger if full)
+    if (fs.free_top == 0 || fs.file_count + fs.tombstones + 1 > (fs.bucket_mask + 1) * 3 / 4) {
+        if (fs_resize(fs.free_top == 0 ? fs.capacity * 2 : fs.capacity) < 0) {
+            return -1;
         }
+        fs_probe(filename, hash, &b);
     }
-    printf("No free file slots available\n");
-    return -1;
+
+    int slot = fs.free_slots[--fs.free_top];
+    struct file *file = &fs.files[slot];
+    strcpy(file->name, filename);
+    file->hash = hash;
+    file->pages = NULL;
+    file->page_slots = 0;
+    file->size = size;
+    file->opens = 0;
+    file->is_used = 1;
+    if (fs.buckets[b] == FS_BUCKET_DELETED) {
+        fs.tombstones--;
+    }
+    fs.buckets[b] = slot;
+    fs.file_count++;
+    return slot;
 }
 
-int fs_write(const char *filename, const void *data, size_t size) {
-    for (int i = 0; i < MAX_FILES; i++) {
-        if (fs.files[i].is_used && strcmp(fs.files[i].name, filename) == 0) {
-            if (size > fs.files[i].size) {
-                printf("Write size too large for file '%s'\n", filename);
-                return -1;
-            }
-            
-            for (size_t j = 0; j < size; j++) {
-                fs.files[i].data[j] = ((const uint8_t *)data)[j];
+// 페이지 목록을 page_count개 이상 담을 수 있게 늘림
+static int fs_reserve_pages(struct file *file, uint32_t page_count) {
+    if (page_count <= file->page_slots) {
+        return 0;
+    }
+
+    uint32_t slots = file->page_slots ? file->page_slots : 1;
+    while (slots < page_count) {
+        slots *= 2;
+    }
+    uint8_t **pages = (uint8_t **)kmalloc(slots * sizeof(uint8_t *));
+    if (!pages) {
+        return -1;
+    }
+    for (uint32_t i = 0; i < slots; i++) {
+        pages[i] = i < file->page_slots ? file->pages[i] : NULL;
+    }
+    kfree(file->pages);
+    file->pages = pages;
+    file->page_slots = slots;
+    return 0;
+}
+
+static int fs_file_write(struct file *file, const void *data, size_t offset, size_t size) {
+    if (offset > MAX_FILESIZE || size > MAX_FILESIZE - offset) {
+        printf("Write size too large for file '%s'\n", file->name);
+        return -1;
+    }
+    if (size == 0) {
+        return 0;
+    }
+    if (fs_reserve_pages(file, (offset + size + FS_PAGE_SIZE - 1) / FS_PAGE_SIZE) < 0) {
+        printf("No memory to grow file '%s'\n", file->name);
+        return -1;
+    }
+
+    const uint8_t *src = (const uint8_t *)data;
+    size_t done = 0;
+    while (done < size) {
+        size_t pos = offset + done;
+        uint32_t index = pos / FS_PAGE_SIZE;
+        uint32_t page_offset = pos % FS_PAGE_SIZE;
+        size_t n = FS_PAGE_SIZE - page_offset;
+        if (n > size - done) {
+            n = size - done;
+        }
+
+        uint8_t *page = file->pages[index];
+        if (!page) {
+            page = (uint8_t *)kmalloc(FS_PAGE_SIZE);
+            if (!page) {
+                break;
             }
-            
-            printf("Wrote %d bytes to file '%s'\n", (int)size, filename);
-            return 0;
+            memset(page, 0, FS_PAGE_SIZE);
+            file->pages[index] = page;
         }
+        memcpy(page + page_offset, src + done, n);
+        done += n;
     }
-    printf("File '%s' not found\n", filename);
-    return -1;
+
+    if (offset + done > file->size) {
+        file->size = offset + done;
+    }
+    return (int)done;
 }
 
-int fs_read(const char *filename, void *buffer, size_t size) {
-    for (int i = 0; i < MAX_FILES; i++) {
-        if (fs.files[i].is_used && strcmp(fs.files[i].name, filename) == 0) {
-            size_t read_size = (size < fs.files[i].size) ? size : fs.files[i].size;
-            
-            for (size_t j = 0; j < read_size; j++) {
-                ((uint8_t *)buffer)[j] = fs.files[i].data[j];
-            }
-            
-            printf("Read %d bytes from file '%s'\n", (int)read_size, filename);
-            return read_size;
+static int fs_file_read(struct file *file, void *buffer, size_t offset, size_t size) {
+    if (offset >= file->size) {
+        return 0;
+    }
+    if (size > file->size - offset) {
+        size = file->size - offset;
+    }
+
+    uint8_t *dst = (uint8_t *)buffer;
+    size_t done = 0;
+    while (done < size) {
+        size_t pos = offset + done;
+        uint32_t index = pos / FS_PAGE_SIZE;
+        uint32_t page_offset = pos % FS_PAGE_SIZE;
+        size_t n = FS_PAGE_SIZE - page_offset;
+        if (n > size - done) {
+            n = size - done;
         }
+
+        // Pages never written read as zeros
+        uint8_t *page = index < file->page_slots ? file->pages[index] : NULL;
+        if (page) {
+            memcpy(dst + done, page + page_offset, n);
+        } else {
+            memset(dst + done, 0, n);
+        }
+        done += n;
     }
-    printf("File '%s' not found\n", filename);
-    return -1;
+    return (int)done;
+}
+
+int fs_write_at(const char *filename, const void *data, size_t offset, size_t size) {
+    struct file *file = fs_lookup(filename);
+    if (!file) {
+        printf("File '%s' not found\n", filename);
+        return -1;
+    }
+    return fs_file_write(file, data, offset, size);
+}
+
+int fs_read_at(const char *filename, void *buffer, size_t offset, size_t size) {
+    struct file *file = fs_lookup(filename);
+    if (!file) {
+        printf("File '%s' not found\n", filename);
+        return -1;
+    }
+    return fs_file_read(file, buffer, offset, size);
+}
+
+int fs_write(const char *filename, const void *data, size_t size) {
+    return fs_write_at(filename, data, 0, size) < (int)size ? -1 : 0;
+}
+
+int fs_read(const char *filename, void *buffer, size_t size) {
+    return fs_read_at(filename, buffer, 0, size);
 }
 
 int fs_delete(const char *filename) {
-    for (int i = 0; i < MAX_FILES; i++) {
-        if (fs.files[i].is_used && strcmp(fs.files[i].name, filename) == 0) {
-            kfree(fs.files[i].data);
-            fs.files[i].is_used = 0;
-            fs.files[i].data = NULL;
-            fs.files[i].size = 0;
-            fs.file_count--;
-            printf("Deleted file '%s'\n", filename);
-            return 0;
-        }
+    int b = fs_probe(filename, hash_string(filename), NULL);
+    if (b < 0) {
+        printf("File '%s' not found\n", filename);
+        return -1;
     }
-    printf("File '%s' not found\n", filename);
-    return -1;
+
+    int slot = fs.buckets[b];
+    struct file *file = &fs.files[slot];
+    if (file->opens > 0) {
+        printf("File '%s' is open\n", filename);
+        return -1;
+    }
+    for (uint32_t i = 0; i < file->page_slots; i++) {
+        kfree(file->pages[i]);
+    }
+    kfree(file->pages);
+    file->pages = NULL;
+    file->page_slots = 0;
+    file->size = 0;
+    file->is_used = 0;
+
+    fs.buckets[b] = FS_BUCKET_DELETED;
+    fs.tombstones++;
+    fs.free_slots[fs.free_top++] = slot;
+    fs.file_count--;
+    return 0;
 }
 
 void fs_list(void) {
     printf("\n=== File System Listing ===\n");
-    printf("Files: %d/%d\n", fs.file_count, MAX_FILES);
+    printf("Files: %d/%d\n", fs.file_count, (int)fs.capacity);
     
     if (fs.file_count == 0) {
         printf("No files in filesystem\n");
         return;
     }
     
-    for (int i = 0; i < MAX_FILES; i++) {
+    for (uint32_t i = 0; i < fs.capacity; i++) {
         if (fs.files[i].is_used) {
             printf("  %s (%d bytes)\n", fs.files[i].name, (int)fs.files[i].size);
         }
@@ -515,14 +715,64 @@ void fs_list(void) {
 }
 
 int fs_exists(const char *filename) {
-    for (int i = 0; i < MAX_FILES; i++) {
-        if (fs.files[i].is_used && strcmp(fs.files[i].name, filename) == 0) {
-            return 1;
-        }
+    return fs_lookup(filename) != NULL;
+}
+
+// VFS 연산: 슬롯 배열은 커지면서 옮겨지므로 열린 파일은 포인터 대신 슬롯 번호(ino)를 가짐
+static int ramfs_open(struct vfs_mount *mnt, const char *path, struct vfs_file *file) {
+    (void)mnt;
+    int b = fs_probe(path, hash_string(path), NULL);
+    if (b < 0) {
+        return -1;
     }
+    file->ino = fs.buckets[b];
+    fs.files[file->ino].opens++;
     return 0;
 }
 
+static void ramfs_release(struct vfs_file *file) {
+    fs.files[file->ino].opens--;
+}
+
+static int ramfs_read(struct vfs_file *file, void *buf, uint32_t size) {
+    return fs_file_read(&fs.files[file->ino], buf, file->offset, size);
+}
+
+static int ramfs_write(struct vfs_file *file, const void *buf, uint32_t size) {
+    return fs_file_write(&fs.files[file->ino], buf, file->offset, size);
+}
+
+static uint32_t ramfs_size(struct vfs_file *file) {
+    return fs.files[file->ino].size;
+}
+
+static int ramfs_create(struct vfs_mount *mnt, const char *path) {
+    (void)mnt;
+    return fs_create(path, 0) < 0 ? -1 : 0;
+}
+
+static int ramfs_unlink(struct vfs_mount *mnt, const char *path) {
+    (void)mnt;
+    return fs_delete(path);
+}
+
+static void ramfs_list(struct vfs_mount *mnt) {
+    (void)mnt;
+    fs_list();
+}
+
+const struct vfs_ops ramfs_vfs_ops = {
+    .name = "ramfs",
+    .open = ramfs_open,
+    .release = ramfs_release,
+    .read = ramfs_read,
+    .write = ramfs_write,
+    .size = ramfs_size,
+    .create = ramfs_create,
+    .unlink = ramfs_unlink,
+    .list = ramfs_list,
+};
+
 void test_filesystem(void) {
     printf("\n=== File System Test ===\n");
     
@@ -619,7 +869,7 @@ void shell_execute_command(const char *cmd, char *args[], int argc) {
     if (strcmp(cmd, "help") == 0) {
         cmd_help();
     } else if (strcmp(cmd, "ls") == 0) {
-        cmd_ls();
+        cmd_ls(argc > 1 ? args[1] : NULL);
     } else if (strcmp(cmd, "cat") == 0) {
         if (argc > 1) {
             cmd_cat(args[1]);
@@ -642,6 +892,8 @@ void shell_execute_command(const char *cmd, char *args[], int argc) {
         cmd_memstat();
     } else if (strcmp(cmd, "clear") == 0) {
         cmd_clear();
+    } else if (strcmp(cmd, "trace") == 0) {
+        cmd_trace(argc > 1 ? args[1] : NULL);
     } else if (strcmp(cmd, "echo") == 0) {
         cmd_echo(args, argc);
     } else if (strcmp(cmd, "exit") == 0) {
@@ -669,31 +921,44 @@ void shell_parse_command(const char *input) {
 void cmd_help(void) {
     printf("\n=== Fru1t OS Shell Commands ===\n");
     printf("help          - Show this help message\n");
-    printf("ls            - List files in filesystem\n");
-    printf("cat <file>    - Display file contents\n");
+    printf("ls [path]     - List files (and mount points) under a path\n");
+    printf("cat <file>    - Display file contents (/disk/... for the disk)\n");
     printf("create <file> <size> - Create new file\n");
     printf("delete <file> - Delete file\n");
     printf("echo [args]   - Print arguments\n");
     printf("memstat       - Show memory statistics\n");
+    printf("trace [n|clear] - Decode the last n trace events (default 32)\n");
     printf("clear         - Clear screen\n");
     printf("exit          - Exit shell\n");
     printf("\n");
 }
 
-void cmd_ls(void) {
-    fs_list();
+void cmd_ls(char *path) {
+    vfs_list(path ? path : "/");
 }
 
 void cmd_cat(char *filename) {
-    char buffer[MAX_FILESIZE];
-    int bytes_read = fs_read(filename, buffer, MAX_FILESIZE);
-    if (bytes_read > 0) {
-        printf("Content of %s:\n", filename);
-        for (int i = 0; i < bytes_read && buffer[i] != '\0'; i++) {
+    int fd = vfs_open(filename, 0);
+    if (fd < 0) {
+        return;
+    }
+
+    // A page at a time, so files of any size print without a big stack buffer
+    char buffer[FS_PAGE_SIZE];
+    printf("Content of %s:\n", filename);
+    int bytes_read;
+    while ((bytes_read = fd_read(fd, buffer, sizeof(buffer))) > 0) {
+        for (int i = 0; i < bytes_read; i++) {
+            if (buffer[i] == '\0') {
+                printf("\n");
+                fd_close(fd);
+                return;
+            }
             putchar(buffer[i]);
         }
-        printf("\n");
     }
+    printf("\n");
+    fd_close(fd);
 }
 
 void cmd_create(char *filename, char *size_str) {
@@ -702,17 +967,50 @@ void cmd_create(char *filename, char *size_str) {
         printf("Invalid size. Must be 1-%d bytes\n", MAX_FILESIZE);
         return;
     }
-    fs_create(filename, size);
+    if (vfs_create(filename) < 0) {
+        return;
+    }
+
+    // Writing the last byte sizes the file; everything before it reads as zeros
+    int fd = vfs_open(filename, 0);
+    char zero = 0;
+    int ok = fd >= 0 && vfs_seek(fd, size - 1) == 0 && fd_write(fd, &zero, 1) == 1;
+    if (fd >= 0) {
+        fd_close(fd);
+    }
+    if (ok) {
+        printf("Created file '%s' (%d bytes)\n", filename, size);
+    }
 }
 
 void cmd_delete(char *filename) {
-    fs_delete(filename);
+    if (vfs_unlink(filename) == 0) {
+        printf("Deleted file '%s'\n", filename);
+    }
 }
 
 void cmd_memstat(void) {
     print_memory_stats();
 }
 
+void cmd_trace(char *arg) {
+    if (arg && strcmp(arg, "clear") == 0) {
+        trace_clear();
+        printf("Trace cleared\n");
+        return;
+    }
+    int n = arg ? str_to_int(arg) : 32;
+    if (n <= 0) {
+        printf("Usage: trace [n|clear]\n");
+        return;
+    }
+    if (trace_count() == 0) {
+        printf("No trace events\n");
+        return;
+    }
+    trace_dump(n);
+}
+
 void cmd_clear(void) {
     printf("\033[2J\033[H");
 }
@@ -746,10 +1044,12 @@ void shell_run(void) {
                 if (shell.buffer_pos > 0) {
                     shell.buffer_pos--;
                     printf("\b \b");
+                    console_flush();
                 }
             } else if (c >= 32 && c < 127 && shell.buffer_pos < SHELL_BUFFER_SIZE - 1) {
                 shell.input_buffer[shell.buffer_pos++] = c;
                 putchar(c);
+                console_flush();
             }
         }
     }
@@ -780,6 +1080,7 @@ int uart_rx_ready(void) {
 }
 
 char uart_getchar(void) {
+    console_flush();                             // A prompt without a newline is still pending
     while (!uart_rx_ready()) {
         wait_for_interrupt();
     }
@@ -787,7 +1088,7 @@ char uart_getchar(void) {
 }
 
 void uart_putchar(char c) {
-    while (!(uart_read_reg(UART_LSR) & 0x20)) {
+    while (!(uart_read_reg(UART_LSR) & UART_LSR_TX_EMPTY)) {
     }
     uart_write_reg(UART_THR, c);
 }
@@ -838,6 +1139,7 @@ char getchar_blocking(void) {
         printf("Waiting for keyboard input... (try typing!)\n");
         first_time = 0;
     }
+    console_flush();
     
     while (1) {
         int c = sbi_console_getchar();
@@ -864,7 +1166,7 @@ void shell_demo(void) {
     cmd_help();
 
     printf("fru1t-os> ls\n");
-    cmd_ls();
+    cmd_ls(NULL);
 
     printf("fru1t-os> cat welcome.txt\n");
     cmd_cat("welcome.txt");
@@ -877,7 +1179,7 @@ void shell_demo(void) {
     cmd_echo(echo_args, 4);
 
     printf("fru1t-os> ls\n");
-    cmd_ls();
+    cmd_ls(NULL);
 
     printf("fru1t-os> memstat\n");
     cmd_memstat();
@@ -886,7 +1188,7 @@ void shell_demo(void) {
     cmd_delete("test.txt");
 
     printf("fru1t-os> ls\n");
-    cmd_ls();
+    cmd_ls(NULL);
 
     printf("fru1t-os> exit\n");
     printf("Goodbye!\n");
@@ -897,14 +1199,53 @@ void shell_demo(void) {
 /* Test function declarations */
 extern void test_all_features(void);
 
+// virtio 디스크의 B-트리 파일시스템 (디스크가 없으면 사용하지 않음)
+static struct btree_filesystem disk_fs;
+
+// 디스크 마운트 후 부팅 횟수 파일을 갱신해 재시작 후에도 남는지 확인
+void disk_fs_init(void) {
+    struct block_device *disk = virtio_blk_probe();
+    if (!disk) {
+        printf("No virtio block device found\n");
+        return;
+    }
+    if (inode_fs_mount(&disk_fs, disk) < 0) {
+        return;
+    }
+    vfs_mount("/disk", &btree_vfs_ops, &disk_fs);
+
+    uint32_t boots = 0;
+    if (btree_fs_open(&disk_fs, "boot.count") < 0) {
+        btree_fs_create(&disk_fs, "boot.count", INODE_TYPE_FILE);
+    } else {
+        btree_fs_read(&disk_fs, "boot.count", &boots, sizeof(boots));
+    }
+    boots++;
+    btree_fs_write(&disk_fs, "boot.count", &boots, sizeof(boots));
+    btree_fs_fsync(&disk_fs, "boot.count");
+    printf("Disk boot count: %u\n", boots);
+}
+
 void kernel_main(void) {
     memset(bss, 0, (size_t) bss_end - (size_t) bss);
+    console_init();
+    mem_init();
 
     printf("Initializing memory allocator...\n");
     memory_init();
 
+    // Traps (page faults of file mappings, interrupts) go through kernel_entry
+    WRITE_CSR(stvec, (uint32_t)kernel_entry);
+
+    scheduler_init();
+
     printf("Initializing filesystem...\n");
     fs_init();
+    fd_init();
+    vfs_mount("/", &ramfs_vfs_ops, NULL);
+
+    printf("Mounting disk filesystem...\n");
+    disk_fs_init();
 
     printf("Initializing UART and keyboard interrupts...\n");
     uart_init();
@@ -934,8 +1275,12 @@ void kernel_main(void) {
     printf("================================================\n");
     printf("\nPress Ctrl+A, X to exit QEMU\n\n");
 
-    // Halt the system instead of running the shell
+    // Halt the system instead of running the shell; the idle loop doubles as the
+    // page cache and journal flusher and the io_uring worker until kernel threads can host them
     while (1) {
+        inode_fs_flusher();
+        io_uring_worker();
+        console_flush();
         __asm__ volatile("wfi"); // Wait for interrupt (low power mode)
     }
 }
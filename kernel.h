@@ -23,16 +23,23 @@ typedef uint32_t size_t;
 #define SCAUSE_INTERRUPT 0x80000000
 #define SCAUSE_EXTERNAL_INTERRUPT 9
 #define SCAUSE_TIMER_INTERRUPT 5
+#define SCAUSE_INSTRUCTION_PAGE_FAULT 12
+#define SCAUSE_LOAD_PAGE_FAULT 13
+#define SCAUSE_STORE_PAGE_FAULT 15
 
 #define UART_BASE 0x10000000
 #define UART_RHR 0
 #define UART_THR 0
 #define UART_IER 1
 #define UART_IIR 2
+#define UART_FCR 2                               // Write side of IIR
 #define UART_LCR 3
 #define UART_LSR 5
 
 #define UART_LSR_RX_READY (1 << 0)
+#define UART_LSR_TX_EMPTY (1 << 5)
+#define UART_FCR_ENABLE (1 << 0)
+#define UART_FCR_CLEAR (3 << 1)                  // Reset both FIFOs
 #define UART_IER_RX_ENABLE (1 << 0)
 
 #define PROC_UNUSED   0
@@ -40,17 +47,27 @@ typedef uint32_t size_t;
 #define PROC_RUNNING  2
 #define PROC_BLOCKED  3
 
-#define MAX_PROCESSES 8
+#ifndef MAX_PROCESSES
+#define MAX_PROCESSES 8                          // Each slot holds its kernel stack
+#endif
 #define STACK_SIZE 8192
 #define TIME_SLICE 10
 
+struct vm_space;
+
+// switch_context가 커널 스택에 쌓는 프레임: ra, s0-s11 (16바이트 정렬)
+#define SWITCH_FRAME_SIZE 64
+#define TIMEBASE_HZ 10000000                     // QEMU virt mtime (read_time) frequency
+
 struct process {
     int pid;
     int state;
-    vaddr_t sp;
-    uint32_t *page_table; 
-    uint8_t stack[STACK_SIZE];
-    struct trap_frame *trap_frame;
+    vaddr_t sp;                                  // Kernel sp while switched out (switch frame on top)
+    struct vm_space *vm;                         // Sv32 page table and file mappings (NULL = no paging)
+    void (*entry)(void);
+    struct process *next;                        // Ready queue or free-slot list link
+    int on_rq;                                   // On the ready queue (set and cleared with it)
+    uint8_t stack[STACK_SIZE] __attribute__((aligned(16))); // Per-task kernel stack
 };
 
 struct trap_frame {
@@ -69,13 +86,19 @@ extern struct sbiret sbi_call(long arg0, long arg1, long arg2, long arg3, long a
 extern void switch_to_user(uint32_t pc, uint32_t sp, uint32_t satp);
 extern uint32_t read_csr_satp(void);
 extern void write_csr_satp(uint32_t value);
+extern void write_csr_stvec(uint32_t value);
+extern void kernel_entry(void);
 extern uint32_t read_csr_scause(void);
 extern uint32_t read_csr_stval(void);
 extern uint32_t read_csr_sepc(void);
 extern void write_csr_sepc(uint32_t value);
 extern void switch_context(uint32_t **old_sp, uint32_t *new_sp);
 extern void enable_interrupts(void);
+extern uint32_t interrupts_disable(void);       // Returns the previous state for interrupts_restore
+extern void interrupts_restore(uint32_t saved);
 extern void wait_for_interrupt(void);
+extern uint32_t cpu_id(void);
+extern uint64_t read_time(void);
 
 #define READ_CSR(reg) read_csr_##reg()
 #define WRITE_CSR(reg, value) write_csr_##reg(value)
@@ -87,8 +110,27 @@ extern void wait_for_interrupt(void);
     } while (0)
 
 void *memset(void *s, int c, size_t n);
+
+// 서식 출력 (common.c, printf와 같은 엔진)
+int snprintf(char *buf, size_t size, const char *fmt, ...);
+int vsnprintf(char *buf, size_t size, const char *fmt, va_list vargs);
+int sscanf(const char *str, const char *fmt, ...);
+paddr_t alloc_pages(uint32_t n);
 void handle_syscall(struct trap_frame *f);
 
+// 시스템 콜 번호 (a7), 인자는 a0부터, 결과는 a0
+#define SYS_IO_URING_ENTER 1                     // a0 = ring, a1 = to_submit, a2 = min_complete
+
+#define MAX_HARTS 4
+
+struct spinlock {
+    volatile uint32_t locked;
+};
+
+void spin_init(struct spinlock *lock);
+void spin_lock(struct spinlock *lock);
+void spin_unlock(struct spinlock *lock);
+
 extern struct process processes[MAX_PROCESSES];
 extern struct process *current_proc;
 
@@ -97,7 +139,8 @@ void schedule(void);
 struct process *create_process(void (*entry_point)(void));
 void yield(void);
 void process_exit(void);
-void context_switch(struct process *prev, struct process *next);
+void process_wake(struct process *proc);       // BLOCKED -> READY, queued behind the others
+void process_init_context(struct process *proc, void (*entry_point)(void));
 
 #define HEAP_SIZE (4 * 1024 * 1024)
 #define BLOCK_SIZE 32
@@ -114,19 +157,35 @@ void *kmalloc(size_t size);
 void kfree(void *ptr);
 void print_memory_stats(void);
 
-#define MAX_FILES 32
+// 평면 RAM 파일시스템
+// 파일 이름 -> 슬롯은 주소 지정 해시 테이블(선형 탐사)로 찾고, 빈 슬롯은 스택으로 관리
+// 슬롯이 모자라면 테이블을 두 배로 늘리며, 파일 데이터는 FS_PAGE_SIZE 페이지 목록에 보관
+#define FS_INITIAL_FILES 32                      // Slots to start with
 #define MAX_FILENAME 64
-#define MAX_FILESIZE 1024
+#define FS_PAGE_SIZE 512                         // File data page (small files stay small)
+#define MAX_FILESIZE (1024 * 1024)               // Largest file
+
+#define FS_BUCKET_EMPTY   -1
+#define FS_BUCKET_DELETED -2                     // Tombstone: probing continues past it
 
 struct file {
     char name[MAX_FILENAME];
-    uint8_t *data;
+    uint32_t hash;                               // hash_string(name), compared before the name
+    uint8_t **pages;                             // Data pages (NULL entry = never written, reads as zeros)
+    uint32_t page_slots;                         // Entries in pages[] (grows by doubling)
     size_t size;
+    uint32_t opens;                              // Open VFS files (deleting waits until 0)
     int is_used;
 };
 
 struct filesystem {
-    struct file files[MAX_FILES];
+    struct file *files;                          // Slot array
+    uint32_t capacity;                           // Slots in files[]
+    int32_t *buckets;                            // Slot number, FS_BUCKET_EMPTY or FS_BUCKET_DELETED
+    uint32_t bucket_mask;                        // Bucket count - 1 (twice the slots, power of two)
+    uint32_t *free_slots;                        // Stack of unused slot numbers
+    uint32_t free_top;
+    uint32_t tombstones;
     int file_count;
 };
 
@@ -138,6 +197,10 @@ int fs_delete(const char *filename);
 void fs_list(void);
 int fs_exists(const char *filename);
 
+// 오프셋 지정 읽기/쓰기 (쓰기는 파일을 늘릴 수 있음, 전송한 바이트 수 또는 -1)
+int fs_read_at(const char *filename, void *buffer, size_t offset, size_t size);
+int fs_write_at(const char *filename, const void *data, size_t offset, size_t size);
+
 #define SHELL_BUFFER_SIZE 256
 #define MAX_ARGS 10
 
@@ -155,12 +218,13 @@ int shell_tokenize(const char *input, char *args[], int max_args);
 void shell_print_prompt(void);
 
 void cmd_help(void);
-void cmd_ls(void);
+void cmd_ls(char *path);
 void cmd_cat(char *filename);
 void cmd_create(char *filename, char *size_str);
 void cmd_delete(char *filename);
 void cmd_memstat(void);
 void cmd_clear(void);
+void cmd_trace(char *arg);
 void cmd_echo(char *args[], int argc);
 
 #define INPUT_BUFFER_SIZE 256
@@ -0,0 +1,27 @@
+#pragma once
+#include "common.h"
+
+// 로그 수준: LOG_LEVEL보다 자세한 로그는 컴파일 때 빠짐 (인자 형식 검사는 그대로)
+// 빌드할 때 -DLOG_LEVEL=LOG_LEVEL_DEBUG 등으로 바꿈
+
+#define LOG_LEVEL_NONE  0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_INFO  3
+#define LOG_LEVEL_DEBUG 4                        // Per-operation messages from hot paths
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+#define LOG_AT(level, fmt, ...)                                                \
+    do {                                                                       \
+        if (LOG_LEVEL >= (level)) {                                            \
+            printf(fmt, ##__VA_ARGS__);                                        \
+        }                                                                      \
+    } while (0)
+
+#define LOG_ERROR(fmt, ...) LOG_AT(LOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
+#define LOG_WARN(fmt, ...)  LOG_AT(LOG_LEVEL_WARN, fmt, ##__VA_ARGS__)
+#define LOG_INFO(fmt, ...)  LOG_AT(LOG_LEVEL_INFO, fmt, ##__VA_ARGS__)
+#define LOG_DEBUG(fmt, ...) LOG_AT(LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
@@ -0,0 +1,175 @@
+#include "lz4.h"
+#include "string.h"
+
+#define LZ4_MIN_MATCH 4
+#define LZ4_LAST_LITERALS 5                      // The block always ends with this many literals
+#define LZ4_MATCH_LIMIT 12                       // No match may start in the last 12 bytes
+#define LZ4_MAX_DISTANCE 65535
+#define LZ4_HASH_BITS 12
+
+// 4바이트 값의 해시 -> 그 값이 마지막으로 나온 위치 (압축할 때마다 비움)
+static uint16_t hash_table[1 << LZ4_HASH_BITS];
+
+// Byte loads: the input may be at any alignment
+static uint32_t read32(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint32_t lz4_hash(uint32_t seq) {
+    return (seq * 2654435761u) >> (32 - LZ4_HASH_BITS);
+}
+
+// 길이 필드가 15를 넘으면 나머지를 255 단위 바이트로 이어 씀
+static uint32_t put_length(uint8_t *dst, uint32_t op, uint32_t len) {
+    while (len >= 255) {
+        dst[op++] = 255;
+        len -= 255;
+    }
+    dst[op++] = (uint8_t)len;
+    return op;
+}
+
+// 리터럴 lit_len개와 (match_len > 0이면) 일치 하나를 시퀀스로 기록, 넘치면 0
+static uint32_t put_sequence(uint8_t *dst, uint32_t op, uint32_t cap, const uint8_t *lit, uint32_t lit_len,
+                             uint32_t distance, uint32_t match_len) {
+    // Worst case: token, literal length bytes, literals, distance, match length bytes
+    uint32_t need = 1 + lit_len / 255 + 1 + lit_len + 2 + match_len / 255 + 1;
+    if (op + need > cap) {
+        return 0;
+    }
+
+    uint32_t token_pos = op++;
+    uint8_t token = (uint8_t)((lit_len < 15 ? lit_len : 15) << 4);
+    if (lit_len >= 15) {
+        op = put_length(dst, op, lit_len - 15);
+    }
+    memcpy(dst + op, lit, lit_len);
+    op += lit_len;
+
+    if (match_len > 0) {
+        uint32_t ml = match_len - LZ4_MIN_MATCH;
+        token |= ml < 15 ? ml : 15;
+        dst[op++] = (uint8_t)distance;
+        dst[op++] = (uint8_t)(distance >> 8);
+        if (ml >= 15) {
+            op = put_length(dst, op, ml - 15);
+        }
+    }
+    dst[token_pos] = token;
+    return op;
+}
+
+uint32_t lz4_compress(const uint8_t *src, uint32_t len, uint8_t *dst, uint32_t cap) {
+    uint32_t op = 0;
+    uint32_t anchor = 0;
+
+    if (len > LZ4_MATCH_LIMIT) {
+        memset(hash_table, 0, sizeof(hash_table));
+        uint32_t limit = len - LZ4_MATCH_LIMIT;
+        uint32_t ip = 0;
+
+        while (ip < limit) {
+            uint32_t seq = read32(src + ip);
+            uint32_t h = lz4_hash(seq);
+            uint32_t ref = hash_table[h];
+            hash_table[h] = (uint16_t)ip;
+
+            if (ref >= ip || ip - ref > LZ4_MAX_DISTANCE || read32(src + ref) != seq) {
+                // Skip faster through data that keeps failing to match
+                ip += 1 + ((ip - anchor) >> 6);
+                continue;
+            }
+
+            // Extend backwards over literals, then forwards up to the last literals
+            while (ip > anchor && ref > 0 && src[ip - 1] == src[ref - 1]) {
+                ip--;
+                ref--;
+            }
+            uint32_t match_len = LZ4_MIN_MATCH;
+            while (ip + match_len < len - LZ4_LAST_LITERALS && src[ref + match_len] == src[ip + match_len]) {
+                match_len++;
+            }
+
+            op = put_sequence(dst, op, cap, src + anchor, ip - anchor, ip - ref, match_len);
+            if (op == 0) {
+                return 0;
+            }
+            ip += match_len;
+            anchor = ip;
+
+            // Remember a position inside the match so the next search has a recent candidate
+            if (ip - 2 < limit) {
+                hash_table[lz4_hash(read32(src + ip - 2))] = (uint16_t)(ip - 2);
+            }
+        }
+    }
+
+    // Whatever is left goes out as literals in a final sequence without a match
+    op = put_sequence(dst, op, cap, src + anchor, len - anchor, 0, 0);
+    return op;
+}
+
+int lz4_decompress(const uint8_t *src, uint32_t len, uint8_t *dst, uint32_t cap) {
+    uint32_t ip = 0;
+    uint32_t op = 0;
+
+    while (ip < len) {
+        uint8_t token = src[ip++];
+
+        uint32_t lit_len = token >> 4;
+        if (lit_len == 15) {
+            uint8_t b;
+            do {
+                if (ip >= len) {
+                    return -1;
+                }
+                b = src[ip++];
+                lit_len += b;
+            } while (b == 255);
+        }
+        if (lit_len > len - ip || lit_len > cap - op) {
+            return -1;
+        }
+        memcpy(dst + op, src + ip, lit_len);
+        op += lit_len;
+        ip += lit_len;
+
+        // The last sequence has literals only
+        if (ip == len) {
+            break;
+        }
+
+        if (len - ip < 2) {
+            return -1;
+        }
+        uint32_t distance = src[ip] | (src[ip + 1] << 8);
+        ip += 2;
+        if (distance == 0 || distance > op) {
+            return -1;
+        }
+
+        uint32_t match_len = token & 15;
+        if (match_len == 15) {
+            uint8_t b;
+            do {
+                if (ip >= len) {
+                    return -1;
+                }
+                b = src[ip++];
+                match_len += b;
+            } while (b == 255);
+        }
+        match_len += LZ4_MIN_MATCH;
+        if (match_len > cap - op) {
+            return -1;
+        }
+
+        // Byte by byte, so a match may overlap the bytes it produces (runs)
+        for (uint32_t i = 0; i < match_len; i++) {
+            dst[op] = dst[op - distance];
+            op++;
+        }
+    }
+
+    return (int)op;
+}
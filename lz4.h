@@ -0,0 +1,11 @@
+#pragma once
+#include "kernel.h"
+
+// LZ4 블록 형식 압축/해제 (프레임 헤더 없음, 입력은 64KB 이하)
+// 시퀀스 = 토큰(리터럴 길이 4비트 | 일치 길이 4비트), 리터럴, 2바이트 거리, 추가 길이 바이트
+
+// src[0..len)을 압축해 dst에 기록하고 압축된 길이를 반환 (cap 안에 들어가지 않으면 0)
+uint32_t lz4_compress(const uint8_t *src, uint32_t len, uint8_t *dst, uint32_t cap);
+
+// src[0..len)을 풀어 dst에 기록하고 풀린 길이를 반환 (형식이 잘못되었거나 cap을 넘으면 -1)
+int lz4_decompress(const uint8_t *src, uint32_t len, uint8_t *dst, uint32_t cap);
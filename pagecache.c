@@ -0,0 +1,696 @@
+#include "pagecache.h"
+#include "inode.h"
+#include "radix.h"
+#include "string.h"
+
+// 프레임 풀과 CLOCK 바늘
+static struct cached_page pages[PAGE_CACHE_PAGES];
+static int clock_hand;
+static int page_cache_ready;
+static int dirty_pages;
+static int mapped_pages;
+static struct page_cache_stats stats;
+
+// 한 번에 장치로 보낼 블록 목록 (write-back과 미리 읽기가 함께 씀, 물리 블록 순)
+struct io_block {
+    uint32_t phys;
+    struct cached_page *page;
+    uint32_t slot;                               // Block index within the page
+};
+static struct io_block io_list[PAGE_CACHE_PAGES * PAGE_CACHE_BLOCKS_PER_PAGE];
+
+// 압축된 클러스터를 일부만 비어 있는 페이지에 풀 때 거치는 곳
+static uint8_t decoded[PAGE_SIZE];
+
+int page_cache_init(void) {
+    if (page_cache_ready) {
+        return 0;
+    }
+
+    // Page-aligned frames from free RAM, so a frame can be mapped into a page table as is
+    uint8_t *frames = (uint8_t *)alloc_pages(PAGE_CACHE_PAGES);
+
+    for (int i = 0; i < PAGE_CACHE_PAGES; i++) {
+        pages[i].fs = NULL;
+        pages[i].inode = NULL;
+        pages[i].data = frames + i * PAGE_SIZE;
+        pages[i].valid = 0;
+        pages[i].dirty = 0;
+        pages[i].referenced = 0;
+        pages[i].readahead = 0;
+        pages[i].mapcount = 0;
+        pages[i].dirtied_at = 0;
+    }
+    clock_hand = 0;
+    dirty_pages = 0;
+    mapped_pages = 0;
+    page_cache_ready = 1;
+    return 0;
+}
+
+// 페이지 안 [offset, offset + len) 범위가 걸치는 블록 비트
+static uint8_t page_block_mask(uint32_t offset, uint32_t len) {
+    uint32_t first = offset / FS_BLOCK_SIZE;
+    uint32_t last = (offset + len - 1) / FS_BLOCK_SIZE;
+    return (uint8_t)(((1u << (last + 1)) - 1) & ~((1u << first) - 1));
+}
+
+static void page_set_dirty(struct cached_page *page, uint8_t mask) {
+    if (!page->dirty) {
+        page->dirtied_at = read_time();
+        dirty_pages++;
+    }
+    page->dirty |= mask;
+}
+
+static void page_clear_dirty(struct cached_page *page, uint8_t mask) {
+    if (page->dirty && !(page->dirty & ~mask)) {
+        dirty_pages--;
+    }
+    page->dirty &= ~mask;
+}
+
+// i번째 블록(물리 블록 phys)부터 mask 안에서 물리 블록이 이어지는 개수
+static uint32_t page_block_run(struct cached_page *page, uint8_t mask, uint32_t i, uint32_t phys) {
+    uint32_t first = page->index * PAGE_CACHE_BLOCKS_PER_PAGE;
+    uint32_t n = 1;
+    while (i + n < PAGE_CACHE_BLOCKS_PER_PAGE && (mask & (1u << (i + n))) &&
+           inode_bmap(page->fs, page->inode, first + i + n, 0) == phys + n) {
+        n++;
+    }
+    return n;
+}
+
+// 압축 파일의 페이지가 압축된 클러스터에 매핑되어 있으면 그 익스텐트
+static struct inode_extent *page_cluster(struct cached_page *page) {
+    if (!(page->inode->flags & INODE_FLAG_COMPRESS)) {
+        return NULL;
+    }
+    struct inode_extent *ext = extent_find(page->inode, page->index * PAGE_CACHE_BLOCKS_PER_PAGE);
+    return ext && ext->stored ? ext : NULL;
+}
+
+// mask 중 아직 없는 블록을 장치에서 읽기 (구멍은 0으로 채움)
+static int page_fill(struct cached_page *page, uint8_t mask) {
+    uint32_t first = page->index * PAGE_CACHE_BLOCKS_PER_PAGE;
+    mask &= ~page->valid;
+
+    // A compressed cluster is decoded whole; blocks already cached (maybe dirty) are kept
+    struct inode_extent *cluster = mask ? page_cluster(page) : NULL;
+    if (cluster) {
+        uint8_t *out = page->valid ? decoded : page->data;
+        if (compress_read_cluster(page->fs, cluster, out) < 0) {
+            return -1;
+        }
+        if (out == decoded) {
+            for (uint32_t i = 0; i < PAGE_CACHE_BLOCKS_PER_PAGE; i++) {
+                if (!(page->valid & (1u << i))) {
+                    memcpy(page->data + i * FS_BLOCK_SIZE, decoded + i * FS_BLOCK_SIZE, FS_BLOCK_SIZE);
+                }
+            }
+        }
+        page->valid = 0xFF;
+        return 0;
+    }
+
+    uint32_t i = 0;
+    while (i < PAGE_CACHE_BLOCKS_PER_PAGE) {
+        if (!(mask & (1u << i))) {
+            i++;
+            continue;
+        }
+
+        uint8_t *dst = page->data + i * FS_BLOCK_SIZE;
+        uint32_t phys = inode_bmap(page->fs, page->inode, first + i, 0);
+        if (phys == 0) {
+            memset(dst, 0, FS_BLOCK_SIZE);
+            page->valid |= 1u << i;
+            i++;
+            continue;
+        }
+
+        uint32_t n = page_block_run(page, mask, i, phys);
+        if (block_read(page->fs, phys, n, dst) < 0) {
+            return -1;
+        }
+        page->valid |= ((1u << n) - 1) << i;
+        i += n;
+    }
+    return 0;
+}
+
+// 압축 파일의 페이지: 파일 끝(또는 마지막 유효 블록)까지 채워 통째로 압축해 새 블록에 기록
+static int page_write_cluster(struct cached_page *page) {
+    uint32_t start = page->index * PAGE_SIZE;
+    uint32_t len = page->inode->size > start ? page->inode->size - start : 0;
+    if (len > PAGE_SIZE) {
+        len = PAGE_SIZE;
+    }
+
+    // Blocks written past the recorded size belong to a write still in progress
+    for (uint32_t i = PAGE_CACHE_BLOCKS_PER_PAGE; i > 0; i--) {
+        if (page->valid & (1u << (i - 1))) {
+            if (len < i * FS_BLOCK_SIZE) {
+                len = i * FS_BLOCK_SIZE;
+            }
+            break;
+        }
+    }
+
+    uint8_t dirty = page->dirty;
+    if (page_fill(page, page_block_mask(0, len)) < 0 ||
+        compress_write_cluster(page->fs, page->inode, page->index, page->data, len) < 0) {
+        return -1;
+    }
+    for (uint32_t i = 0; i < PAGE_CACHE_BLOCKS_PER_PAGE; i++) {
+        stats.writebacks += (dirty >> i) & 1;
+    }
+    stats.requests++;
+    page_clear_dirty(page, dirty);
+    return 0;
+}
+
+// 더티 블록을 장치에 기록 (물리적으로 연속인 블록은 한 번에)
+static int page_writeback(struct cached_page *page) {
+    uint32_t first = page->index * PAGE_CACHE_BLOCKS_PER_PAGE;
+    if (page->inode->flags & INODE_FLAG_COMPRESS) {
+        return page_write_cluster(page);
+    }
+
+    uint32_t i = 0;
+    while (i < PAGE_CACHE_BLOCKS_PER_PAGE) {
+        if (!(page->dirty & (1u << i))) {
+            i++;
+            continue;
+        }
+
+        uint32_t phys = inode_bmap(page->fs, page->inode, first + i, 0);
+        if (phys == 0) {
+            // The block was released underneath us; nothing to write
+            page_clear_dirty(page, 1u << i);
+            i++;
+            continue;
+        }
+
+        uint32_t n = page_block_run(page, page->dirty, i, phys);
+        if (block_write(page->fs, phys, n, page->data + i * FS_BLOCK_SIZE) < 0) {
+            return -1;
+        }
+        stats.writebacks += n;
+        stats.requests++;
+        page_clear_dirty(page, ((1u << n) - 1) << i);
+        i += n;
+    }
+    return 0;
+}
+
+// io_list[0..n)을 보냄: 물리적으로 이어지는 블록은 페이지가 달라도 조각 목록으로 묶어 요청 하나로
+// 성공한 블록은 읽기면 유효, 쓰기면 깨끗한 상태가 됨
+static int page_io_list(int n, int write) {
+    int result = 0;
+    int i = 0;
+    while (i < n) {
+        struct io_block *head = &io_list[i];
+        struct blkdev_segment segs[BLKDEV_MAX_SEGMENTS];
+        int nsegs = 1;
+        segs[0].buf = head->page->data + head->slot * FS_BLOCK_SIZE;
+        segs[0].count = 1;
+
+        // Extend while the next block follows on disk; it joins the last piece if it
+        // also follows in memory, otherwise it starts a new one
+        int j = i + 1;
+        while (j < n && io_list[j].page->fs == head->page->fs && io_list[j].phys == io_list[j - 1].phys + 1) {
+            struct io_block *prev = &io_list[j - 1];
+            struct io_block *cur = &io_list[j];
+            if (cur->page == prev->page && cur->slot == prev->slot + 1) {
+                segs[nsegs - 1].count++;
+            } else if (nsegs < BLKDEV_MAX_SEGMENTS) {
+                segs[nsegs].buf = cur->page->data + cur->slot * FS_BLOCK_SIZE;
+                segs[nsegs].count = 1;
+                nsegs++;
+            } else {
+                break;
+            }
+            j++;
+        }
+
+        struct btree_filesystem *fs = head->page->fs;
+        if (write) {
+            for (int k = i; k < j; k++) {
+                block_csum_set(fs, io_list[k].phys, 1, io_list[k].page->data + io_list[k].slot * FS_BLOCK_SIZE);
+            }
+            if (block_csum_unverify(fs, head->phys, (uint32_t)(j - i)) < 0 ||
+                blkdev_write_segments(fs->dev, head->phys, segs, nsegs) < 0) {
+                result = -1;
+            } else {
+                stats.writebacks += j - i;
+                stats.requests++;
+                for (int k = i; k < j; k++) {
+                    page_clear_dirty(io_list[k].page, 1u << io_list[k].slot);
+                }
+            }
+        } else {
+            if (blkdev_read_segments(fs->dev, head->phys, segs, nsegs) < 0) {
+                result = -1;
+            } else {
+                // A block that fails verification stays invalid, so the reader sees the error
+                for (int k = i; k < j; k++) {
+                    if (block_csum_check(fs, io_list[k].phys, 1,
+                                         io_list[k].page->data + io_list[k].slot * FS_BLOCK_SIZE) < 0) {
+                        result = -1;
+                        continue;
+                    }
+                    io_list[k].page->valid |= 1u << io_list[k].slot;
+                }
+            }
+        }
+        i = j;
+    }
+    return result;
+}
+
+// 조건에 맞는 더티 블록을 모아 물리 블록 순으로 정렬한 뒤 기록
+// fs나 inode가 NULL이면 전부, dirtied_before 이전에 더러워진 페이지만 대상
+static int page_cache_writeback(struct btree_filesystem *fs, struct inode *inode, uint64_t dirtied_before) {
+    int result = 0;
+    int n = 0;
+    for (int p = 0; p < PAGE_CACHE_PAGES; p++) {
+        struct cached_page *page = &pages[p];
+        if (!page->dirty || (fs && page->fs != fs) || (inode && page->inode != inode) ||
+            page->dirtied_at >= dirtied_before) {
+            continue;
+        }
+        if (page->inode->flags & INODE_FLAG_COMPRESS) {
+            if (page_write_cluster(page) < 0) {
+                result = -1;
+            }
+            continue;
+        }
+
+        uint32_t first = page->index * PAGE_CACHE_BLOCKS_PER_PAGE;
+        for (uint32_t i = 0; i < PAGE_CACHE_BLOCKS_PER_PAGE; i++) {
+            if (!(page->dirty & (1u << i))) {
+                continue;
+            }
+            uint32_t phys = inode_bmap(page->fs, page->inode, first + i, 0);
+            if (phys == 0) {
+                page_clear_dirty(page, 1u << i);
+                continue;
+            }
+            io_list[n].phys = phys;
+            io_list[n].page = page;
+            io_list[n].slot = i;
+            n++;
+        }
+    }
+
+    // Insertion sort by (filesystem, block): pages of one file are mostly in order already
+    for (int i = 1; i < n; i++) {
+        struct io_block key = io_list[i];
+        int j = i - 1;
+        while (j >= 0 && (io_list[j].page->fs > key.page->fs ||
+                          (io_list[j].page->fs == key.page->fs && io_list[j].phys > key.phys))) {
+            io_list[j + 1] = io_list[j];
+            j--;
+        }
+        io_list[j + 1] = key;
+    }
+
+    if (page_io_list(n, 1) < 0) {
+        result = -1;
+    }
+    return result;
+}
+
+// 페이지를 i-node에서 떼어 빈 프레임으로 만듦
+static void page_release(struct cached_page *page) {
+    radix_tree_delete(&page->inode->page_tree, page->index);
+    page_clear_dirty(page, page->dirty);
+    page->fs = NULL;
+    page->inode = NULL;
+    page->valid = 0;
+    page->referenced = 0;
+    page->readahead = 0;
+}
+
+// CLOCK: 빈 프레임이나 참조 비트가 꺼진 페이지가 나올 때까지 바늘을 돌림
+static struct cached_page *page_evict(void) {
+    for (;;) {
+        struct cached_page *page = &pages[clock_hand];
+        clock_hand = (clock_hand + 1) % PAGE_CACHE_PAGES;
+
+        if (!page->inode) {
+            return page;
+        }
+        if (page->mapcount) {
+            continue;
+        }
+        if (page->referenced) {
+            page->referenced = 0;
+            continue;
+        }
+
+        // A dirty victim takes the rest of its filesystem's dirty pages along in one batch
+        if (page->dirty && page_cache_writeback(page->fs, NULL, ~(uint64_t)0) < 0 && page->dirty) {
+            printf("Error: Write-back of i-node %u page %u failed, data lost\n",
+                   page->inode->inode_num, page->index);
+        }
+        page_release(page);
+        stats.evictions++;
+        return page;
+    }
+}
+
+// 페이지 찾기 (없으면 프레임을 받아 등록, 내용은 아직 비어 있음)
+static struct cached_page *page_get(struct btree_filesystem *fs, struct inode *inode, uint32_t index) {
+    struct cached_page *page = (struct cached_page *)radix_tree_lookup(&inode->page_tree, index);
+    if (page) {
+        return page;
+    }
+
+    page = page_evict();
+    if (radix_tree_insert(&inode->page_tree, index, page) < 0) {
+        return NULL;
+    }
+    page->fs = fs;
+    page->inode = inode;
+    page->index = index;
+    return page;
+}
+
+// [start, start + count) 페이지 중 비어 있는 블록을 큰 요청으로 읽어 둠
+// marker 페이지에 닿으면 다음 창을 읽기 시작함
+static void page_cache_readahead(struct btree_filesystem *fs, struct inode *inode,
+                                 uint32_t start, uint32_t count, uint32_t marker) {
+    if (inode->size == 0) {
+        return;
+    }
+    uint32_t last = (inode->size - 1) / PAGE_SIZE;
+    if (start > last) {
+        return;
+    }
+    if (count > last - start + 1) {
+        count = last - start + 1;
+    }
+
+    // Take all the frames first: evicting a dirty page reuses io_list for its write-back.
+    // The window is a quarter of the cache, so CLOCK cannot come back around to these
+    struct cached_page *window[PAGE_CACHE_RA_MAX];
+    for (uint32_t p = 0; p < count; p++) {
+        window[p] = page_get(fs, inode, start + p);
+        if (!window[p]) {
+            count = p;
+            break;
+        }
+        window[p]->referenced = 1;
+    }
+
+    int n = 0;
+    for (uint32_t p = 0; p < count; p++) {
+        struct cached_page *page = window[p];
+        if (page->valid == 0xFF) {
+            continue;
+        }
+        if (start + p == marker) {
+            page->readahead = 1;
+        }
+        stats.readahead++;
+        if (page_cluster(page)) {
+            page_fill(page, 0xFF);
+            continue;
+        }
+
+        uint32_t first = page->index * PAGE_CACHE_BLOCKS_PER_PAGE;
+        for (uint32_t i = 0; i < PAGE_CACHE_BLOCKS_PER_PAGE; i++) {
+            if (page->valid & (1u << i)) {
+                continue;
+            }
+            uint32_t phys = inode_bmap(fs, inode, first + i, 0);
+            if (phys == 0) {
+                memset(page->data + i * FS_BLOCK_SIZE, 0, FS_BLOCK_SIZE);
+                page->valid |= 1u << i;
+                continue;
+            }
+            io_list[n].phys = phys;
+            io_list[n].page = page;
+            io_list[n].slot = i;
+            n++;
+        }
+    }
+
+    // Failed blocks stay invalid and are read again on demand
+    page_io_list(n, 0);
+}
+
+// 읽으려는 페이지가 준비되지 않음: 순차 접근이면 창을 키워 미리 읽고, 아니면 창을 초기화
+static void page_cache_ra_miss(struct btree_filesystem *fs, struct inode *inode, struct file_ra_state *ra,
+                               uint32_t index, uint32_t req_pages) {
+    if (index != ra->next_index) {
+        ra->size = 0;
+        return;
+    }
+
+    uint32_t size = ra->size ? ra->size * 2 : req_pages * 4;
+    if (size < PAGE_CACHE_RA_MIN) {
+        size = PAGE_CACHE_RA_MIN;
+    }
+    if (size > PAGE_CACHE_RA_MAX) {
+        size = PAGE_CACHE_RA_MAX;
+    }
+    if (size < req_pages) {
+        req_pages = size;
+    }
+
+    ra->start = index;
+    ra->size = size;
+    ra->async_size = size - req_pages;
+    page_cache_readahead(fs, inode, ra->start, ra->size,
+                         ra->async_size ? ra->start + ra->size - ra->async_size : ra->start + ra->size);
+}
+
+// 표시된 페이지에 닿음: 현재 창을 다 쓰기 전에 다음 창(두 배 크기)을 읽어 둠
+static void page_cache_ra_marker(struct btree_filesystem *fs, struct inode *inode, struct file_ra_state *ra,
+                                 uint32_t index) {
+    ra->start = ra->size ? ra->start + ra->size : index + 1;
+    ra->size = ra->size * 2 > PAGE_CACHE_RA_MAX ? PAGE_CACHE_RA_MAX : ra->size * 2;
+    if (ra->size < PAGE_CACHE_RA_MIN) {
+        ra->size = PAGE_CACHE_RA_MIN;
+    }
+    ra->async_size = ra->size;
+    page_cache_readahead(fs, inode, ra->start, ra->size, ra->start);
+}
+
+int page_cache_read(struct btree_filesystem *fs, struct inode *inode, struct file_ra_state *ra,
+                    void *buffer, uint32_t offset, uint32_t size) {
+    uint8_t *buf = (uint8_t *)buffer;
+    uint32_t done = 0;
+    uint32_t last_page = size ? (offset + size - 1) / PAGE_SIZE : 0;
+
+    while (done < size) {
+        uint32_t pos = offset + done;
+        uint32_t index = pos / PAGE_SIZE;
+        uint32_t page_offset = pos % PAGE_SIZE;
+        uint32_t n = PAGE_SIZE - page_offset;
+        if (n > size - done) {
+            n = size - done;
+        }
+        uint8_t need = page_block_mask(page_offset, n);
+
+        struct cached_page *page = (struct cached_page *)radix_tree_lookup(&inode->page_tree, index);
+        int ready = page && (page->valid & need) == need;
+        if (ready) {
+            stats.hits++;
+        } else {
+            stats.misses++;
+        }
+
+        if (ra && !ready) {
+            page_cache_ra_miss(fs, inode, ra, index, last_page - index + 1);
+        } else if (ra && page->readahead) {
+            page->readahead = 0;
+            page_cache_ra_marker(fs, inode, ra, index);
+        }
+
+        // Read-ahead may have brought the page in (or evicted it), so look it up again
+        page = page_get(fs, inode, index);
+        if (!page || page_fill(page, need) < 0) {
+            break;
+        }
+        page->referenced = 1;
+
+        memcpy(buf + done, page->data + page_offset, n);
+        done += n;
+        if (ra) {
+            ra->next_index = index + (page_offset + n == PAGE_SIZE);
+        }
+    }
+
+    return done;
+}
+
+int page_cache_write(struct btree_filesystem *fs, struct inode *inode, const void *data, uint32_t offset, uint32_t size) {
+    const uint8_t *buf = (const uint8_t *)data;
+    uint32_t done = 0;
+
+    while (done < size) {
+        uint32_t pos = offset + done;
+        uint32_t page_offset = pos % PAGE_SIZE;
+        uint32_t n = PAGE_SIZE - page_offset;
+        if (n > size - done) {
+            n = size - done;
+        }
+
+        struct cached_page *page = page_get(fs, inode, pos / PAGE_SIZE);
+        if (!page) {
+            break;
+        }
+
+        // Blocks that are only partly overwritten need their old contents first
+        uint8_t partial = 0;
+        if (page_offset % FS_BLOCK_SIZE) {
+            partial |= page_block_mask(page_offset, 1);
+        }
+        if ((page_offset + n) % FS_BLOCK_SIZE) {
+            partial |= page_block_mask(page_offset + n - 1, 1);
+        }
+        if (page_fill(page, partial) < 0) {
+            break;
+        }
+
+        memcpy(page->data + page_offset, buf + done, n);
+        uint8_t written = page_block_mask(page_offset, n);
+        page->valid |= written;
+        page_set_dirty(page, written);
+        page->referenced = 1;
+        done += n;
+    }
+
+    // Too much unwritten data: the writer pays for the write-back itself
+    if (dirty_pages > PAGE_CACHE_DIRTY_LIMIT) {
+        page_cache_writeback(NULL, NULL, ~(uint64_t)0);
+    }
+
+    return done;
+}
+
+int page_cache_new_blocks(struct btree_filesystem *fs, struct inode *inode, uint32_t block_idx, uint32_t count) {
+    while (count > 0) {
+        uint32_t slot = block_idx % PAGE_CACHE_BLOCKS_PER_PAGE;
+        uint32_t n = PAGE_CACHE_BLOCKS_PER_PAGE - slot;
+        if (n > count) {
+            n = count;
+        }
+
+        struct cached_page *page = page_get(fs, inode, block_idx / PAGE_CACHE_BLOCKS_PER_PAGE);
+        if (!page) {
+            return -1;
+        }
+        memset(page->data + slot * FS_BLOCK_SIZE, 0, n * FS_BLOCK_SIZE);
+        uint8_t mask = (uint8_t)(((1u << n) - 1) << slot);
+        page->valid |= mask;
+        page_set_dirty(page, mask);
+
+        block_idx += n;
+        count -= n;
+    }
+    return 0;
+}
+
+uint8_t *page_cache_map(struct btree_filesystem *fs, struct inode *inode, uint32_t index) {
+    if (mapped_pages >= PAGE_CACHE_MAX_MAPPED) {
+        printf("Error: Too many mapped pages\n");
+        return NULL;
+    }
+
+    // The whole frame becomes visible; blocks past the end of the file read as zeros
+    struct cached_page *page = page_get(fs, inode, index);
+    if (!page || page_fill(page, 0xFF) < 0) {
+        return NULL;
+    }
+    if (page->mapcount++ == 0) {
+        mapped_pages++;
+    }
+    page->referenced = 1;
+    return page->data;
+}
+
+void page_cache_map_dirty(struct inode *inode, uint32_t index) {
+    struct cached_page *page = (struct cached_page *)radix_tree_lookup(&inode->page_tree, index);
+    uint32_t start = index * PAGE_SIZE;
+    if (!page || inode->size <= start) {
+        return;
+    }
+    uint32_t len = inode->size - start < PAGE_SIZE ? inode->size - start : PAGE_SIZE;
+    page_set_dirty(page, page_block_mask(0, len));
+}
+
+void page_cache_unmap(struct inode *inode, uint32_t index) {
+    struct cached_page *page = (struct cached_page *)radix_tree_lookup(&inode->page_tree, index);
+    if (page && page->mapcount > 0 && --page->mapcount == 0) {
+        mapped_pages--;
+    }
+}
+
+int page_cache_flush(struct btree_filesystem *fs, struct inode *inode) {
+    return page_cache_writeback(fs, inode, ~(uint64_t)0);
+}
+
+void page_cache_flusher(void) {
+    if (!page_cache_ready || dirty_pages == 0) {
+        return;
+    }
+
+    uint64_t now = read_time();
+    uint64_t cutoff = now > PAGE_CACHE_DIRTY_EXPIRE ? now - PAGE_CACHE_DIRTY_EXPIRE : 0;
+    if (dirty_pages > PAGE_CACHE_DIRTY_BACKGROUND) {
+        cutoff = ~(uint64_t)0;
+    }
+    page_cache_writeback(NULL, NULL, cutoff);
+}
+
+void page_cache_truncate(struct btree_filesystem *fs, struct inode *inode, uint32_t new_size) {
+    uint32_t first_dropped = (new_size + PAGE_SIZE - 1) / PAGE_SIZE;
+
+    for (int i = 0; i < PAGE_CACHE_PAGES; i++) {
+        struct cached_page *page = &pages[i];
+        if (page->fs != fs || page->inode != inode) {
+            continue;
+        }
+        if (page->index < new_size / PAGE_SIZE) {
+            continue;
+        }
+
+        // The page holding the new end keeps its data, so save it before dropping
+        if (page->index < first_dropped && page->dirty) {
+            page_writeback(page);
+        }
+        page_release(page);
+    }
+}
+
+void page_cache_drop_fs(struct btree_filesystem *fs) {
+    for (int i = 0; i < PAGE_CACHE_PAGES; i++) {
+        if (pages[i].fs == fs) {
+            page_release(&pages[i]);
+        }
+    }
+}
+
+void page_cache_get_stats(struct page_cache_stats *out) {
+    *out = stats;
+    out->dirty = dirty_pages;
+}
+
+void page_cache_print_stats(void) {
+    int cached = 0;
+    for (int i = 0; i < PAGE_CACHE_PAGES; i++) {
+        if (pages[i].inode) {
+            cached++;
+        }
+    }
+
+    printf("  Page cache: %d/%d pages (%d dirty), %u hits, %u misses, %u evictions\n",
+           cached, PAGE_CACHE_PAGES, dirty_pages, stats.hits, stats.misses, stats.evictions);
+    printf("  Write-back: %u blocks in %u requests, read-ahead: %u pages\n",
+           stats.writebacks, stats.requests, stats.readahead);
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include "kernel.h"
+
+struct btree_filesystem;
+struct inode;
+
+// 페이지 캐시: 파일 데이터를 (i-node, 페이지 번호)로 찾는 4KB 페이지에 보관
+// 모든 파일시스템이 프레임 풀 하나를 함께 쓰고, 풀이 차면 CLOCK으로 내보냄
+// 페이지 안의 블록마다 유효/더티 비트를 따로 두어 필요한 블록만 읽고 씀
+#define PAGE_CACHE_PAGES 64
+#define PAGE_CACHE_BLOCKS_PER_PAGE 8             // PAGE_SIZE / FS_BLOCK_SIZE
+
+// 지연 쓰기: 더티 페이지는 flusher가 모아서 기록
+// 오래된 페이지나 기준을 넘은 더티 페이지는 flusher가, 한도를 넘으면 쓰는 쪽이 직접 기록
+#define PAGE_CACHE_DIRTY_BACKGROUND 16           // Flusher writes everything above this
+#define PAGE_CACHE_DIRTY_LIMIT 48                // Writers flush synchronously above this
+#define PAGE_CACHE_DIRTY_EXPIRE 50000000ULL      // 5 s of the 10 MHz timer
+
+// 메모리 매핑으로 고정할 수 있는 페이지 수 (나머지는 CLOCK이 돌릴 수 있게 남김)
+#define PAGE_CACHE_MAX_MAPPED (PAGE_CACHE_PAGES / 4)
+
+// 미리 읽기 창 크기 (페이지): 순차 읽기가 이어질수록 두 배씩 커짐
+#define PAGE_CACHE_RA_MIN 4
+#define PAGE_CACHE_RA_MAX (PAGE_CACHE_PAGES / 4)
+
+struct cached_page {
+    struct btree_filesystem *fs;                 // Owning filesystem (NULL if the frame is free)
+    struct inode *inode;                         // Owning i-node
+    uint32_t index;                              // Page number within the file
+    uint8_t *data;                               // PAGE_SIZE bytes
+    uint8_t valid;                               // Blocks loaded from disk (one bit per block)
+    uint8_t dirty;                               // Blocks modified since the last write-back
+    uint8_t referenced;                          // CLOCK reference bit
+    uint8_t readahead;                           // Reaching this page starts the next read-ahead window
+    uint16_t mapcount;                           // Page-table mappings of the frame (never evicted while > 0)
+    uint64_t dirtied_at;                         // Time the page went from clean to dirty
+};
+
+struct page_cache_stats {
+    uint32_t hits;                               // Page found with the needed blocks loaded
+    uint32_t misses;                             // Page missing or blocks had to be read
+    uint32_t evictions;                          // Pages evicted by CLOCK
+    uint32_t writebacks;                         // Blocks written back to the device
+    uint32_t requests;                           // Device write requests issued for them
+    uint32_t readahead;                          // Pages read ahead of the reader
+    uint32_t dirty;                              // Pages dirty right now
+};
+
+// 열린 파일마다 두는 미리 읽기 상태 (0으로 초기화하면 파일 처음부터 순차 읽기로 봄)
+struct file_ra_state {
+    uint32_t start;                              // First page of the current window
+    uint32_t size;                               // Pages in the window (0 = not streaming)
+    uint32_t async_size;                         // Trailing pages read ahead of the request
+    uint32_t next_index;                         // Page a sequential reader touches next
+};
+
+int page_cache_init(void);
+
+// 캐시를 거쳐 파일 데이터 읽기/쓰기 (쓰기 대상 블록은 미리 할당되어 있어야 함)
+// ra가 있으면 순차 읽기를 감지해 뒤따르는 페이지를 미리 읽음
+int page_cache_read(struct btree_filesystem *fs, struct inode *inode, struct file_ra_state *ra,
+                    void *buffer, uint32_t offset, uint32_t size);
+int page_cache_write(struct btree_filesystem *fs, struct inode *inode, const void *data, uint32_t offset, uint32_t size);
+
+// 새로 할당한 블록을 장치에서 읽지 않고 0으로 채운 더티 블록으로 올림
+int page_cache_new_blocks(struct btree_filesystem *fs, struct inode *inode, uint32_t block_idx, uint32_t count);
+
+// 메모리 매핑 (vm.c): 페이지 전체를 읽어 두고 고정한 프레임 주소 반환 (실패하면 NULL)
+// 매핑으로 쓴 페이지는 map_dirty로 파일 끝 안의 블록을 더티로 표시
+uint8_t *page_cache_map(struct btree_filesystem *fs, struct inode *inode, uint32_t index);
+void page_cache_map_dirty(struct inode *inode, uint32_t index);
+void page_cache_unmap(struct inode *inode, uint32_t index);
+
+// 더티 페이지 기록 (inode가 NULL이면 fs 전체)
+int page_cache_flush(struct btree_filesystem *fs, struct inode *inode);
+
+// 백그라운드 flusher 한 번 실행: 만료된 더티 페이지(많으면 전부)를 기록
+void page_cache_flusher(void);
+
+// new_size 이후의 페이지 버림 (경계에 걸친 페이지는 먼저 기록)
+void page_cache_truncate(struct btree_filesystem *fs, struct inode *inode, uint32_t new_size);
+
+// fs의 페이지를 모두 버림 (언마운트용, 기록하지 않음)
+void page_cache_drop_fs(struct btree_filesystem *fs);
+
+void page_cache_get_stats(struct page_cache_stats *stats);
+void page_cache_print_stats(void);
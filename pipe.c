@@ -0,0 +1,158 @@
+#include "pipe.h"
+#include "common.h"
+#include "string.h"
+
+/* 링 버퍼에서 n바이트 꺼내기 (끝에서 감기면 두 번에 나눠 복사) */
+static void pipe_copy_out(struct pipe *p, uint8_t *dst, uint32_t n) {
+    uint32_t first = PIPE_BUF_SIZE - p->head;
+    if (first > n) {
+        first = n;
+    }
+    memcpy(dst, p->buf + p->head, first);
+    memcpy(dst + first, p->buf, n - first);
+    p->head = (p->head + n) % PIPE_BUF_SIZE;
+    p->count -= n;
+}
+
+static void pipe_copy_in(struct pipe *p, const uint8_t *src, uint32_t n) {
+    uint32_t tail = (p->head + p->count) % PIPE_BUF_SIZE;
+    uint32_t first = PIPE_BUF_SIZE - tail;
+    if (first > n) {
+        first = n;
+    }
+    memcpy(p->buf + tail, src, first);
+    memcpy(p->buf, src + first, n - first);
+    p->count += n;
+}
+
+/* 조각들을 차례로 채움: 버퍼에 있는 만큼만 */
+static int pipe_fd_readv(void *ctx, const struct iovec *iov, int iovcnt) {
+    struct pipe *p = (struct pipe *)ctx;
+    int total = 0;
+
+    for (int i = 0; i < iovcnt && p->count > 0; i++) {
+        uint32_t n = iov[i].iov_len < p->count ? iov[i].iov_len : p->count;
+        pipe_copy_out(p, (uint8_t *)iov[i].iov_base, n);
+        total += n;
+    }
+
+    return total;
+}
+
+/* 조각들을 차례로 넣음: 남은 공간만큼만, 읽는 쪽이 모두 닫혔으면 -1 */
+static int pipe_fd_writev(void *ctx, const struct iovec *iov, int iovcnt) {
+    struct pipe *p = (struct pipe *)ctx;
+    if (p->readers == 0) {
+        return -1;
+    }
+
+    int total = 0;
+    for (int i = 0; i < iovcnt && p->count < PIPE_BUF_SIZE; i++) {
+        uint32_t space = PIPE_BUF_SIZE - p->count;
+        uint32_t n = iov[i].iov_len < space ? iov[i].iov_len : space;
+        pipe_copy_in(p, (const uint8_t *)iov[i].iov_base, n);
+        total += n;
+    }
+
+    return total;
+}
+
+static int pipe_fd_read(void *ctx, void *buf, size_t count) {
+    struct iovec iov = { buf, count };
+    return pipe_fd_readv(ctx, &iov, 1);
+}
+
+static int pipe_fd_write(void *ctx, const void *buf, size_t count) {
+    struct iovec iov = { (void *)buf, count };
+    return pipe_fd_writev(ctx, &iov, 1);
+}
+
+static int pipe_read_fd_poll(void *ctx) {
+    struct pipe *p = (struct pipe *)ctx;
+    int flags = 0;
+
+    if (p->count > 0) {
+        flags |= FD_READABLE;
+    }
+    /* 쓰는 쪽이 모두 닫혔으면 남은 데이터를 읽은 뒤 EOF */
+    if (p->writers == 0) {
+        flags |= FD_READABLE | FD_HANGUP;
+    }
+
+    return flags;
+}
+
+static int pipe_write_fd_poll(void *ctx) {
+    struct pipe *p = (struct pipe *)ctx;
+    if (p->readers == 0) {
+        return FD_ERROR;
+    }
+    return p->count < PIPE_BUF_SIZE ? FD_WRITABLE : 0;
+}
+
+/* 양쪽이 모두 닫히면 파이프 해제 */
+static void pipe_release(struct pipe *p) {
+    if (p->readers == 0 && p->writers == 0) {
+        kfree(p->buf);
+        kfree(p);
+    }
+}
+
+static void pipe_read_fd_close(void *ctx) {
+    struct pipe *p = (struct pipe *)ctx;
+    p->readers--;
+    pipe_release(p);
+}
+
+static void pipe_write_fd_close(void *ctx) {
+    struct pipe *p = (struct pipe *)ctx;
+    p->writers--;
+    pipe_release(p);
+}
+
+struct fd_ops pipe_read_fd_ops = {
+    .read = pipe_fd_read,
+    .readv = pipe_fd_readv,
+    .poll = pipe_read_fd_poll,
+    .close = pipe_read_fd_close,
+};
+
+struct fd_ops pipe_write_fd_ops = {
+    .write = pipe_fd_write,
+    .writev = pipe_fd_writev,
+    .poll = pipe_write_fd_poll,
+    .close = pipe_write_fd_close,
+};
+
+/* 파이프 생성 */
+int pipe_create(int fds[2]) {
+    struct pipe *p = (struct pipe *)kmalloc(sizeof(struct pipe));
+    uint8_t *buf = (uint8_t *)kmalloc(PIPE_BUF_SIZE);
+    if (!p || !buf) {
+        printf("Error: No memory for a pipe\n");
+        kfree(p);
+        kfree(buf);
+        return -1;
+    }
+    p->buf = buf;
+    p->head = 0;
+    p->count = 0;
+    p->readers = 0;
+    p->writers = 0;
+
+    fds[0] = fd_alloc(FD_TYPE_PIPE, p, &pipe_read_fd_ops);
+    if (fds[0] < 0) {
+        pipe_release(p);
+        return -1;
+    }
+    p->readers = 1;
+
+    fds[1] = fd_alloc(FD_TYPE_PIPE, p, &pipe_write_fd_ops);
+    if (fds[1] < 0) {
+        fd_close(fds[0]);
+        return -1;
+    }
+    p->writers = 1;
+
+    return 0;
+}
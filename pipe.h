@@ -0,0 +1,22 @@
+#pragma once
+#include "kernel.h"
+#include "fd.h"
+
+/* 파이프: 쓰는 쪽 fd에서 읽는 쪽 fd로 바이트를 넘기는 고정 크기 링 버퍼 */
+/* 블로킹은 없음: 비어 있으면 읽기가 0, 가득 차면 쓰기가 들어간 만큼만 반환 */
+
+#define PIPE_BUF_SIZE 4096
+
+struct pipe {
+    uint8_t *buf;            /* PIPE_BUF_SIZE 바이트 */
+    uint32_t head;           /* 다음에 읽을 위치 */
+    uint32_t count;          /* 버퍼에 있는 바이트 수 */
+    int readers;             /* 열린 읽기 쪽 fd 수 */
+    int writers;             /* 열린 쓰기 쪽 fd 수 */
+};
+
+/* 파이프 생성: fds[0]은 읽기 쪽, fds[1]은 쓰기 쪽 (성공 0, 실패 -1) */
+int pipe_create(int fds[2]);
+
+extern struct fd_ops pipe_read_fd_ops;
+extern struct fd_ops pipe_write_fd_ops;
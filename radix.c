@@ -0,0 +1,121 @@
+#include "radix.h"
+
+static struct radix_node *radix_node_alloc(void) {
+    struct radix_node *node = (struct radix_node *)kmalloc(sizeof(struct radix_node));
+    if (node) {
+        memset(node, 0, sizeof(*node));
+    }
+    return node;
+}
+
+// 높이 height의 트리가 담을 수 있는 가장 큰 인덱스
+static uint32_t radix_max_index(uint32_t height) {
+    if (height * RADIX_TREE_BITS >= 32) {
+        return 0xFFFFFFFF;
+    }
+    return (1u << (height * RADIX_TREE_BITS)) - 1;
+}
+
+void radix_tree_init(struct radix_tree *tree) {
+    tree->root = NULL;
+    tree->height = 0;
+}
+
+void *radix_tree_lookup(struct radix_tree *tree, uint32_t index) {
+    if (!tree->root || index > radix_max_index(tree->height)) {
+        return NULL;
+    }
+
+    struct radix_node *node = tree->root;
+    for (uint32_t level = tree->height; level > 1; level--) {
+        uint32_t shift = (level - 1) * RADIX_TREE_BITS;
+        node = (struct radix_node *)node->slots[(index >> shift) & (RADIX_TREE_SLOTS - 1)];
+        if (!node) {
+            return NULL;
+        }
+    }
+    return node->slots[index & (RADIX_TREE_SLOTS - 1)];
+}
+
+int radix_tree_insert(struct radix_tree *tree, uint32_t index, void *item) {
+    // Grow upwards until index fits; the old root becomes slot 0 of the new one
+    while (!tree->root || index > radix_max_index(tree->height)) {
+        struct radix_node *node = radix_node_alloc();
+        if (!node) {
+            return -1;
+        }
+        if (tree->root) {
+            node->slots[0] = tree->root;
+            node->count = 1;
+        }
+        tree->root = node;
+        tree->height++;
+    }
+
+    struct radix_node *node = tree->root;
+    for (uint32_t level = tree->height; level > 1; level--) {
+        uint32_t shift = (level - 1) * RADIX_TREE_BITS;
+        uint32_t slot = (index >> shift) & (RADIX_TREE_SLOTS - 1);
+        if (!node->slots[slot]) {
+            node->slots[slot] = radix_node_alloc();
+            if (!node->slots[slot]) {
+                return -1;
+            }
+            node->count++;
+        }
+        node = (struct radix_node *)node->slots[slot];
+    }
+
+    uint32_t slot = index & (RADIX_TREE_SLOTS - 1);
+    if (!node->slots[slot]) {
+        node->count++;
+    }
+    node->slots[slot] = item;
+    return 0;
+}
+
+void *radix_tree_delete(struct radix_tree *tree, uint32_t index) {
+    if (!tree->root || index > radix_max_index(tree->height)) {
+        return NULL;
+    }
+
+    // Remember the path so emptied nodes can be freed bottom-up
+    struct radix_node *path[RADIX_TREE_MAX_HEIGHT];
+    uint32_t slots[RADIX_TREE_MAX_HEIGHT];
+    struct radix_node *node = tree->root;
+    uint32_t depth = 0;
+
+    for (uint32_t level = tree->height; level > 0; level--) {
+        uint32_t shift = (level - 1) * RADIX_TREE_BITS;
+        path[depth] = node;
+        slots[depth] = (index >> shift) & (RADIX_TREE_SLOTS - 1);
+        if (level > 1) {
+            node = (struct radix_node *)node->slots[slots[depth]];
+            if (!node) {
+                return NULL;
+            }
+        }
+        depth++;
+    }
+
+    struct radix_node *leaf = path[depth - 1];
+    void *item = leaf->slots[slots[depth - 1]];
+    if (!item) {
+        return NULL;
+    }
+
+    while (depth > 0) {
+        depth--;
+        node = path[depth];
+        node->slots[slots[depth]] = NULL;
+        if (--node->count > 0) {
+            break;
+        }
+        kfree(node);
+        if (depth == 0) {
+            tree->root = NULL;
+            tree->height = 0;
+        }
+    }
+    return item;
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include "kernel.h"
+
+// 기수 트리: 32비트 인덱스를 6비트씩 잘라 64갈래 노드로 찾아감
+// 높이는 가장 큰 인덱스에 맞춰 늘어나므로 작은 파일은 노드 하나로 끝남
+#define RADIX_TREE_BITS  6
+#define RADIX_TREE_SLOTS (1 << RADIX_TREE_BITS)
+#define RADIX_TREE_MAX_HEIGHT ((32 + RADIX_TREE_BITS - 1) / RADIX_TREE_BITS)
+
+struct radix_node {
+    void *slots[RADIX_TREE_SLOTS];               // 자식 노드 또는 (마지막 단계에서) 항목
+    uint32_t count;                              // 비어 있지 않은 슬롯 수
+};
+
+struct radix_tree {
+    struct radix_node *root;
+    uint32_t height;                             // 0이면 빈 트리
+};
+
+void radix_tree_init(struct radix_tree *tree);
+void *radix_tree_lookup(struct radix_tree *tree, uint32_t index);
+int radix_tree_insert(struct radix_tree *tree, uint32_t index, void *item);
+void *radix_tree_delete(struct radix_tree *tree, uint32_t index);
@@ -5,14 +5,22 @@ set -xue
 CC=/opt/homebrew/opt/llvm/bin/clang  # Ubuntu 등 환경에 따라 경로 조정: CC=clang
 CFLAGS="-std=c11 -O2 -g3 -Wall -Wextra --target=riscv32-unknown-elf -fno-stack-protector -ffreestanding -nostdlib"
 
-# 커널 빌드 (Red-Black Tree, CFS, epoll, B-Tree, i-node 포함)
+# 커널 빌드 (Red-Black Tree, CFS, epoll, 파이프, io_uring, VFS, B-Tree, 비트맵, i-node, extent 포함)
 $CC $CFLAGS -Wl,-Tkernel.ld -Wl,-Map=kernel.map -o kernel.elf \
-    kernel.c common.c asm_functions.s rbtree.c cfs.c fd.c epoll.c test_features.c btree.c inode.c test_btree_fs.c
+    kernel.c common.c console.c trace.c asm_functions.s string.c rbtree.c cfs.c fd.c pipe.c uring.c vfs.c epoll.c test_features.c btree.c bitmap.c blkdev.c virtio_blk.c radix.c dcache.c inode.c extent.c compress.c lz4.c pagecache.c vm.c journal.c crc32c.c fs_disk.c test_btree_fs.c
+
+# 디스크 이미지 (없을 때만 mkfs로 생성, 있으면 재부팅 후에도 내용 유지)
+HOST_CC=cc
+$HOST_CC -O2 -Wall -Wextra -o mkfs tools/mkfs.c
+[ -f disk.img ] || ./mkfs disk.img 8
 
 # QEMU 실행
 /opt/homebrew/bin/qemu-system-riscv32 \
     -machine virt \
+    -cpu rv32,v=true \
     -bios default \
     -nographic \
     --no-reboot \
+    -drive id=drive0,file=disk.img,format=raw,if=none \
+    -device virtio-blk-device,drive=drive0,bus=virtio-mmio-bus.0 \
     -kernel kernel.elf
@@ -0,0 +1,305 @@
+#include "string.h"
+
+extern uint32_t vector_probe(void);
+
+static int use_rvv;
+
+// 트랩 중첩 깊이 (하트별): kernel_entry는 벡터 레지스터를 저장하지 않으므로, 트랩 처리 중에는
+// 중단된 코드(예: 페이지 폴트를 낸 memcpy_rvv)의 v0-v31/vl/vtype을 건드리지 않도록 워드 경로만 씀
+static uint32_t trap_depth[MAX_HARTS];
+
+void mem_init(void) {
+    use_rvv = vector_probe() != 0;
+    printf("Memory copy: %s\n", use_rvv ? "RVV vector loops" : "word loops");
+}
+
+int mem_has_rvv(void) {
+    return use_rvv;
+}
+
+void mem_trap_enter(void) {
+    trap_depth[cpu_id() % MAX_HARTS]++;
+}
+
+void mem_trap_exit(void) {
+    trap_depth[cpu_id() % MAX_HARTS]--;
+}
+
+static inline int rvv_usable(void) {
+    return use_rvv && trap_depth[cpu_id() % MAX_HARTS] == 0;
+}
+
+void *memcpy_bytes(void *dst, const void *src, size_t n) {
+    uint8_t *d = (uint8_t *)dst;
+    const uint8_t *s = (const uint8_t *)src;
+    while (n--) {
+        *d++ = *s++;
+    }
+    return dst;
+}
+
+// 정렬된 워드 복사: 32바이트씩 펼치고 남은 워드, 끝 바이트
+static void copy_aligned_words(mem_word *d, const mem_word *s, size_t words) {
+    while (words >= 8) {
+        uint32_t w0 = s[0], w1 = s[1], w2 = s[2], w3 = s[3];
+        uint32_t w4 = s[4], w5 = s[5], w6 = s[6], w7 = s[7];
+        d[0] = w0; d[1] = w1; d[2] = w2; d[3] = w3;
+        d[4] = w4; d[5] = w5; d[6] = w6; d[7] = w7;
+        d += 8;
+        s += 8;
+        words -= 8;
+    }
+    while (words--) {
+        *d++ = *s++;
+    }
+}
+
+// 원본이 워드 경계에서 shift바이트 어긋난 경우: 정렬된 워드 둘을 이어 붙여 씀
+// (읽는 워드는 원본 범위를 포함하는 워드뿐이라 다른 페이지를 건드리지 않음)
+static void copy_shifted_words(mem_word *d, const uint8_t *s, size_t words, uint32_t shift) {
+    const mem_word *ws = (const mem_word *)(s - shift);
+    uint32_t lo = shift * 8, hi = 32 - lo;
+    uint32_t prev = *ws++;
+    while (words--) {
+        uint32_t next = *ws++;
+        *d++ = (prev >> lo) | (next << hi);      // Little endian
+        prev = next;
+    }
+}
+
+void *memcpy_words(void *dst, const void *src, size_t n) {
+    uint8_t *d = (uint8_t *)dst;
+    const uint8_t *s = (const uint8_t *)src;
+
+    if (n >= 16) {
+        // Align the destination; the source may still be off by 1-3 bytes
+        while ((uintptr_t)d & 3) {
+            *d++ = *s++;
+            n--;
+        }
+        size_t words = n / 4;
+        uint32_t shift = (uintptr_t)s & 3;
+        if (shift == 0) {
+            copy_aligned_words((mem_word *)d, (const mem_word *)s, words);
+        } else {
+            copy_shifted_words((mem_word *)d, s, words, shift);
+        }
+        d += words * 4;
+        s += words * 4;
+        n &= 3;
+    }
+
+    while (n--) {
+        *d++ = *s++;
+    }
+    return dst;
+}
+
+void *memcpy(void *dst, const void *src, size_t n) {
+    if (n >= MEM_RVV_MIN && rvv_usable()) {
+        return memcpy_rvv(dst, src, n);
+    }
+    return memcpy_words(dst, src, n);
+}
+
+void *memmove(void *dst, const void *src, size_t n) {
+    uint8_t *d = (uint8_t *)dst;
+    const uint8_t *s = (const uint8_t *)src;
+    // Forward copies read ahead of what they write, so only a destination
+    // that starts inside the source has to go backwards
+    if (d <= s || d >= s + n) {
+        return memcpy(dst, src, n);
+    }
+
+    d += n;
+    s += n;
+    if ((((uintptr_t)d ^ (uintptr_t)s) & 3) == 0) {
+        while (n > 0 && ((uintptr_t)d & 3)) {
+            *--d = *--s;
+            n--;
+        }
+        while (n >= 4) {
+            d -= 4;
+            s -= 4;
+            *(mem_word *)d = *(const mem_word *)s;
+            n -= 4;
+        }
+    }
+    while (n--) {
+        *--d = *--s;
+    }
+    return dst;
+}
+
+void *memset_words(void *s, int c, size_t n) {
+    uint8_t *p = (uint8_t *)s;
+
+    if (n >= 16) {
+        while ((uintptr_t)p & 3) {
+            *p++ = (uint8_t)c;
+            n--;
+        }
+        uint32_t w = (uint8_t)c * 0x01010101u;
+        mem_word *wp = (mem_word *)p;
+        size_t words = n / 4;
+        while (words >= 8) {
+            wp[0] = w; wp[1] = w; wp[2] = w; wp[3] = w;
+            wp[4] = w; wp[5] = w; wp[6] = w; wp[7] = w;
+            wp += 8;
+            words -= 8;
+        }
+        while (words--) {
+            *wp++ = w;
+        }
+        p = (uint8_t *)wp;
+        n &= 3;
+    }
+
+    while (n--) {
+        *p++ = (uint8_t)c;
+    }
+    return s;
+}
+
+void *memset(void *s, int c, size_t n) {
+    if (n >= MEM_RVV_MIN && rvv_usable()) {
+        return memset_rvv(s, c, n);
+    }
+    return memset_words(s, c, n);
+}
+
+// 워드 안에 0 바이트가 있으면 0이 아님
+static inline uint32_t has_zero(uint32_t w) {
+    return (w - 0x01010101u) & ~w & 0x80808080u;
+}
+
+// Aligned words never cross a page, so reading past the terminator within one is safe
+size_t strlen_words(const char *s) {
+    const char *p = s;
+    while ((uintptr_t)p & 3) {
+        if (*p == '\0') {
+            return p - s;
+        }
+        p++;
+    }
+
+    const mem_word *w = (const mem_word *)p;
+    while (!has_zero(*w)) {
+        w++;
+    }
+    p = (const char *)w;
+    while (*p) {
+        p++;
+    }
+    return p - s;
+}
+
+size_t strlen(const char *s) {
+    return rvv_usable() ? strlen_rvv(s) : strlen_words(s);
+}
+
+int strcmp_words(const char *s1, const char *s2) {
+    // Word compares only when both strings reach a word boundary together
+    if ((((uintptr_t)s1 ^ (uintptr_t)s2) & 3) == 0) {
+        while ((uintptr_t)s1 & 3) {
+            if (*s1 == '\0' || *s1 != *s2) {
+                return *(const uint8_t *)s1 - *(const uint8_t *)s2;
+            }
+            s1++;
+            s2++;
+        }
+        const mem_word *w1 = (const mem_word *)s1;
+        const mem_word *w2 = (const mem_word *)s2;
+        while (*w1 == *w2 && !has_zero(*w1)) {
+            w1++;
+            w2++;
+        }
+        s1 = (const char *)w1;
+        s2 = (const char *)w2;
+    }
+
+    while (*s1 && *s1 == *s2) {
+        s1++;
+        s2++;
+    }
+    return *(const uint8_t *)s1 - *(const uint8_t *)s2;
+}
+
+int strcmp(const char *s1, const char *s2) {
+    return rvv_usable() ? strcmp_rvv(s1, s2) : strcmp_words(s1, s2);
+}
+
+char *strchr_words(const char *s, int c) {
+    uint8_t ch = (uint8_t)c;
+    while ((uintptr_t)s & 3) {
+        if (*(const uint8_t *)s == ch) {
+            return (char *)s;
+        }
+        if (*s == '\0') {
+            return NULL;
+        }
+        s++;
+    }
+
+    // Skip words holding neither the terminator nor c
+    uint32_t pattern = ch * 0x01010101u;
+    const mem_word *w = (const mem_word *)s;
+    while (!has_zero(*w) && !has_zero(*w ^ pattern)) {
+        w++;
+    }
+    for (s = (const char *)w; ; s++) {
+        if (*(const uint8_t *)s == ch) {
+            return (char *)s;
+        }
+        if (*s == '\0') {
+            return NULL;
+        }
+    }
+}
+
+char *strchr(const char *s, int c) {
+    return rvv_usable() ? strchr_rvv(s, c) : strchr_words(s, c);
+}
+
+// Boyer-Moore-Horspool: on a mismatch, shift by how far the haystack byte under the
+// needle's last position is from the needle's end (the whole needle if it is not in it)
+char *strstr(const char *haystack, const char *needle) {
+    size_t m = strlen(needle);
+    if (m <= 1) {
+        return m == 0 ? (char *)haystack : strchr(haystack, needle[0]);
+    }
+    size_t n = strlen(haystack);
+    if (n < m) {
+        return NULL;
+    }
+
+    uint32_t shift[256];
+    for (int i = 0; i < 256; i++) {
+        shift[i] = m;
+    }
+    for (size_t i = 0; i < m - 1; i++) {
+        shift[(uint8_t)needle[i]] = m - 1 - i;
+    }
+
+    const uint8_t *h = (const uint8_t *)haystack;
+    const uint8_t *nd = (const uint8_t *)needle;
+    uint8_t last = nd[m - 1];
+    for (size_t pos = 0; pos <= n - m; pos += shift[h[pos + m - 1]]) {
+        if (h[pos + m - 1] != last) {
+            continue;
+        }
+        size_t i = 0;
+        while (i < m - 1 && h[pos + i] == nd[i]) {
+            i++;
+        }
+        if (i == m - 1) {
+            return (char *)(h + pos);
+        }
+    }
+    return NULL;
+}
+
+char *strcpy(char *dst, const char *src) {
+    memcpy(dst, src, strlen(src) + 1);
+    return dst;
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include "kernel.h"
+
+// 메모리 복사/채우기: 정렬된 워드 단위(8워드씩 펼침)로 처리하고,
+// 부팅할 때 V 확장이 있으면 긴 구간은 RVV 루프(asm_functions.s)로 넘김
+// 문자열: 정렬된 워드에서 0 바이트를 한 번에 찾고(has-zero), V가 있으면 fault-only-first 로드로 처리
+
+#define MEM_RVV_MIN 64                           // Below this the vsetvli setup costs more than it saves
+
+// Word accesses to buffers of any type
+typedef uint32_t __attribute__((may_alias)) mem_word;
+
+void mem_init(void);                             // Picks the vector path if the hart has V
+int mem_has_rvv(void);
+void mem_trap_enter(void);                       // Trap handler entry/exit: no vector code in between
+void mem_trap_exit(void);
+
+void *memcpy(void *dst, const void *src, size_t n);
+void *memmove(void *dst, const void *src, size_t n);
+// memset is declared in kernel.h
+
+size_t strlen(const char *s);
+int strcmp(const char *s1, const char *s2);
+char *strchr(const char *s, int c);
+char *strstr(const char *haystack, const char *needle);  // Boyer-Moore-Horspool
+char *strcpy(char *dst, const char *src);
+
+// 경로별 구현 (벤치마크와 테스트에서 직접 비교)
+void *memcpy_bytes(void *dst, const void *src, size_t n);
+void *memcpy_words(void *dst, const void *src, size_t n);
+void *memset_words(void *s, int c, size_t n);
+size_t strlen_words(const char *s);
+int strcmp_words(const char *s1, const char *s2);
+char *strchr_words(const char *s, int c);
+
+// RVV 루프 (mem_has_rvv()일 때만 호출)
+extern void *memcpy_rvv(void *dst, const void *src, size_t n);
+extern void *memset_rvv(void *s, int c, size_t n);
+extern size_t strlen_rvv(const char *s);
+extern int strcmp_rvv(const char *s1, const char *s2);
+extern char *strchr_rvv(const char *s, int c);
@@ -4,8 +4,14 @@
 #include "cfs.h"
 #include "fd.h"
 #include "epoll.h"
+#include "pipe.h"
+#include "uring.h"
 #include "btree.h"
 #include "inode.h"
+#include "vfs.h"
+#include "string.h"
+#include "console.h"
+#include "trace.h"
 
 /* Test Red-Black Tree */
 void test_rbtree(void) {
@@ -187,6 +193,874 @@ void test_epoll(void) {
     printf("\nepoll test completed!\n");
 }
 
+/* 조각마다 read/write만 있는 fd (fd_readv/fd_writev의 대체 경로 확인용) */
+static uint8_t plain_buf[64];
+static uint32_t plain_len, plain_pos;
+
+static int plain_fd_read(void *ctx, void *buf, size_t count) {
+    (void)ctx;
+    uint8_t *cbuf = (uint8_t *)buf;
+    size_t i;
+    for (i = 0; i < count && plain_pos < plain_len; i++) {
+        cbuf[i] = plain_buf[plain_pos++];
+    }
+    return (int)i;
+}
+
+static int plain_fd_write(void *ctx, const void *buf, size_t count) {
+    (void)ctx;
+    const uint8_t *cbuf = (const uint8_t *)buf;
+    size_t i;
+    for (i = 0; i < count && plain_len < sizeof(plain_buf); i++) {
+        plain_buf[plain_len++] = cbuf[i];
+    }
+    return (int)i;
+}
+
+static struct fd_ops plain_fd_ops = {
+    .read = plain_fd_read,
+    .write = plain_fd_write,
+};
+
+/* Test pipes and readv/writev */
+void test_vectored_fds(void) {
+    printf("\n=== Pipe and Vectored I/O Test ===\n");
+
+    fd_init();
+
+    int fds[2];
+    if (pipe_create(fds) < 0) {
+        printf("Failed to create pipe\n");
+        return;
+    }
+
+    /* A header and a body in one call, read back split differently */
+    char header[] = "LEN 11\n";
+    char body[] = "hello world";
+    struct iovec out[2] = { { header, 7 }, { body, 11 } };
+    int written = fd_writev(fds[1], out, 2);
+    char first[4], rest[32];
+    struct iovec in[2] = { { first, 4 }, { rest, sizeof(rest) } };
+    int got = fd_readv(fds[0], in, 2);
+    int errors = written != 18 || got != 18;
+    for (int i = 0; i < 18; i++) {
+        char c = i < 4 ? first[i] : rest[i - 4];
+        errors += c != (i < 7 ? header[i] : body[i - 7]);
+    }
+    printf("Pipe writev/readv: %d written, %d read: %s\n", written, got, errors == 0 ? "PASS" : "FAIL");
+
+    /* Wrapping around the ring and filling it: writes stop at the free space */
+    static uint8_t chunk[3000];
+    errors = 0;
+    for (int round = 0; round < 4; round++) {
+        for (int i = 0; i < 3000; i++) {
+            chunk[i] = (uint8_t)(round * 31 + i);
+        }
+        struct iovec wiov[2] = { { chunk, 1000 }, { chunk + 1000, 2000 } };
+        errors += fd_writev(fds[1], wiov, 2) != 3000;
+        errors += fd_read(fds[0], chunk, 3000) != 3000;
+        for (int i = 0; i < 3000; i++) {
+            errors += chunk[i] != (uint8_t)(round * 31 + i);
+        }
+    }
+    struct iovec fill[2] = { { chunk, 3000 }, { chunk, 3000 } };
+    errors += fd_writev(fds[1], fill, 2) != PIPE_BUF_SIZE;
+    errors += fd_poll(fds[1]) & FD_WRITABLE;
+    printf("Pipe wrap-around and full buffer: %s\n", errors == 0 ? "PASS" : "FAIL");
+
+    /* Closing the writer: the reader drains what is left, then sees a hang-up */
+    fd_close(fds[1]);
+    errors = !(fd_poll(fds[0]) & FD_HANGUP);
+    while (fd_read(fds[0], chunk, sizeof(chunk)) > 0) {
+    }
+    errors += fd_read(fds[0], chunk, sizeof(chunk)) != 0;
+    fd_close(fds[0]);
+    printf("Pipe hang-up: %s\n", errors == 0 ? "PASS" : "FAIL");
+
+    /* An fd with only read/write goes through the per-piece fallback */
+    int plain = fd_alloc(FD_TYPE_SOCKET, NULL, &plain_fd_ops);
+    plain_len = 0;
+    plain_pos = 0;
+    written = fd_writev(plain, out, 2);
+    got = fd_readv(plain, in, 2);
+    errors = written != 18 || got != 18 || first[0] != 'L' || rest[3] != 'h';
+    fd_close(plain);
+    printf("Fallback for fds without readv/writev: %s\n", errors == 0 ? "PASS" : "FAIL");
+
+    /* The UART writes every piece in one call */
+    int uart_fd = fd_alloc(FD_TYPE_UART, NULL, &uart_fd_ops);
+    struct iovec line[3] = { { "UART ", 5 }, { "writev", 6 }, { "\n", 1 } };
+    printf("UART writev: %s\n", fd_writev(uart_fd, line, 3) == 12 ? "PASS" : "FAIL");
+    fd_close(uart_fd);
+
+    printf("\nVectored I/O test completed!\n");
+}
+
+/* CQ에 쌓인 완료를 모두 꺼내 user_data 순서대로 결과를 기록, 꺼낸 수 반환 */
+static int drain_cq(struct io_uring *ring, int32_t *results, int max) {
+    int n = 0;
+    struct io_uring_cqe *cqe;
+    while ((cqe = io_uring_peek_cqe(ring)) != NULL) {
+        if (cqe->user_data < (uint64_t)max) {
+            results[cqe->user_data] = cqe->res;
+        }
+        io_uring_cqe_seen(ring);
+        n++;
+    }
+    return n;
+}
+
+/* Test io_uring submission/completion rings */
+void test_io_uring(void) {
+    printf("\n=== io_uring Test ===\n");
+
+    fd_init();
+    int fds[2];
+    struct io_uring *ring = io_uring_setup(16, 0);
+    if (!ring || pipe_create(fds) < 0) {
+        printf("Failed to set up io_uring test\n");
+        return;
+    }
+
+    /* A poll on the empty pipe waits; four writes go in the same batch */
+    int32_t res[16];
+    struct io_uring_sqe *sqe = io_uring_get_sqe(ring);
+    io_uring_prep_rw(sqe, IORING_OP_POLL_ADD, fds[0], NULL, 0, 0);
+    sqe->poll_events = FD_READABLE;
+    const char *msgs[4] = { "one ", "two ", "three ", "four" };
+    for (int i = 0; i < 4; i++) {
+        int len = 0;
+        while (msgs[i][len]) {
+            len++;
+        }
+        io_uring_prep_rw(io_uring_get_sqe(ring), IORING_OP_WRITE, fds[1], (void *)msgs[i], len, i + 1);
+    }
+    int submitted = io_uring_submit(ring);
+    int done = drain_cq(ring, res, 16);
+    int errors = submitted != 5 || done != 4 || res[1] != 4 || res[3] != 6 || ring->inflight != 1;
+
+    /* The worker finds the pipe readable and completes the poll */
+    io_uring_worker();
+    done = drain_cq(ring, res, 16);
+    errors += done != 1 || !(res[0] & FD_READABLE);
+    printf("Batched writes and a waiting poll: %d submitted in %u enter(s): %s\n",
+           submitted, ring->stats.enters, errors == 0 ? "PASS" : "FAIL");
+
+    /* Scattered read and an invalid fd, completed through the ring */
+    char head[4], tail[32];
+    struct iovec iov[2] = { { head, 4 }, { tail, sizeof(tail) } };
+    io_uring_prep_rw(io_uring_get_sqe(ring), IORING_OP_READV, fds[0], iov, 2, 5);
+    io_uring_prep_rw(io_uring_get_sqe(ring), IORING_OP_READ, 60, tail, 4, 6);
+    io_uring_submit(ring);
+    drain_cq(ring, res, 16);
+    errors = res[5] != 18 || head[0] != 'o' || tail[0] != 't' || tail[13] != 'r' || res[6] != -1;
+    printf("Readv and errors through the ring: %s\n", errors == 0 ? "PASS" : "FAIL");
+    fd_close(fds[0]);
+    fd_close(fds[1]);
+
+    /* File I/O: eight block writes and an fsync in one enter */
+    static struct btree_filesystem fs;
+    struct block_device *dev = ramdisk_create(MAX_BLOCKS * 4);
+    inode_fs_format(&fs, dev);
+    vfs_mount("/t", &btree_vfs_ops, &fs);
+    int fd = vfs_open("/t/ring.dat", VFS_O_CREAT);
+    static uint8_t blocks[8][FS_BLOCK_SIZE];
+    for (int i = 0; i < 8; i++) {
+        memset(blocks[i], 'a' + i, FS_BLOCK_SIZE);
+        io_uring_prep_rw(io_uring_get_sqe(ring), IORING_OP_WRITE, fd, blocks[i], FS_BLOCK_SIZE, i);
+    }
+    io_uring_prep_rw(io_uring_get_sqe(ring), IORING_OP_FSYNC, fd, NULL, 0, 8);
+    uint32_t enters = ring->stats.enters;
+    submitted = io_uring_submit(ring);
+    done = drain_cq(ring, res, 16);
+    errors = submitted != 9 || done != 9 || ring->stats.enters != enters + 1 || res[8] != 0;
+    for (int i = 0; i < 8; i++) {
+        errors += res[i] != FS_BLOCK_SIZE;
+    }
+    fd_close(fd);
+
+    /* The ring has 16 entries: a 17th SQE has to wait for the next submit */
+    int full = 0;
+    for (int i = 0; i < 17; i++) {
+        full += io_uring_get_sqe(ring) == NULL;
+    }
+    io_uring_submit(ring);
+    drain_cq(ring, res, 16);
+    errors += full != 1;
+
+    vfs_umount("/t");
+    inode_fs_unmount(&fs);
+    inode_fs_mount(&fs, dev);
+    static uint8_t check[8 * FS_BLOCK_SIZE];
+    errors += btree_fs_read(&fs, "ring.dat", check, sizeof(check)) != (int)sizeof(check);
+    for (uint32_t i = 0; i < sizeof(check); i++) {
+        errors += check[i] != 'a' + i / FS_BLOCK_SIZE;
+    }
+    printf("File writes and fsync in one batch: %s\n", errors == 0 ? "PASS" : "FAIL");
+    inode_fs_unmount(&fs);
+    ramdisk_destroy(dev);
+    io_uring_destroy(ring);
+
+    /* SQPOLL: the worker picks up submissions without an enter */
+    ring = io_uring_setup(4, IORING_SETUP_SQPOLL);
+    io_uring_prep_rw(io_uring_get_sqe(ring), IORING_OP_NOP, -1, NULL, 0, 7);
+    io_uring_submit(ring);
+    errors = io_uring_peek_cqe(ring) != NULL;
+    io_uring_worker();
+    errors += drain_cq(ring, res, 16) != 1 || res[7] != 0 || ring->stats.enters != 0;
+    printf("SQPOLL worker: %s\n", errors == 0 ? "PASS" : "FAIL");
+
+    /* The system call takes only a live ring, never an arbitrary address */
+    struct trap_frame frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.a7 = SYS_IO_URING_ENTER;
+    frame.a0 = (uint32_t)(uintptr_t)ring;
+    handle_syscall(&frame);
+    errors = frame.a0 != 0 || ring->stats.enters != 1;
+    frame.a0 = (uint32_t)(uintptr_t)ring + 4;
+    handle_syscall(&frame);
+    errors += frame.a0 != (uint32_t)-1;
+    uint32_t stale = (uint32_t)(uintptr_t)ring;
+    io_uring_destroy(ring);
+    frame.a0 = stale;
+    handle_syscall(&frame);
+    errors += frame.a0 != (uint32_t)-1;
+    printf("Syscall rejects unregistered rings: %s\n", errors == 0 ? "PASS" : "FAIL");
+
+    printf("\nio_uring test completed!\n");
+}
+
+/* 숫자를 붙인 파일 이름 ("ram" + 10진수) */
+static void ramfs_name(char *name, uint32_t n) {
+    char digits[10];
+    int len = 0;
+    do {
+        digits[len++] = '0' + n % 10;
+        n /= 10;
+    } while (n);
+
+    name[0] = 'r';
+    name[1] = 'a';
+    name[2] = 'm';
+    for (int i = 0; i < len; i++) {
+        name[3 + i] = digits[len - 1 - i];
+    }
+    name[3 + len] = '\0';
+}
+
+/* memcpy/memmove/memset: every alignment and length against the byte loop, then timings */
+void test_mem_ops(void) {
+    printf("\n=== Memory Copy Test ===\n");
+
+    static uint8_t src[320], dst[320], ref[320];
+    for (uint32_t i = 0; i < sizeof(src); i++) {
+        src[i] = (uint8_t)(i * 13 + 7);
+    }
+
+    int errors = 0;
+    for (uint32_t sa = 0; sa < 4; sa++) {
+        for (uint32_t da = 0; da < 4; da++) {
+            for (uint32_t n = 0; n < 260; n += (n < 40 ? 1 : 17)) {
+                memset_words(dst, 0xEE, sizeof(dst));
+                memset_words(ref, 0xEE, sizeof(ref));
+                memcpy(dst + da, src + sa, n);
+                memcpy_bytes(ref + da, src + sa, n);
+                for (uint32_t i = 0; i < sizeof(dst); i++) {
+                    errors += dst[i] != ref[i];
+                }
+
+                memset(dst + da, sa, n);
+                for (uint32_t i = 0; i < sizeof(dst); i++) {
+                    errors += dst[i] != (i >= da && i < da + n ? sa : ref[i]);
+                }
+            }
+        }
+    }
+    printf("memcpy and memset at every alignment: %s\n", errors == 0 ? "PASS" : "FAIL");
+
+    /* Overlapping moves in both directions */
+    errors = 0;
+    for (uint32_t shift = 1; shift < 9; shift++) {
+        for (uint32_t n = 0; n < 200; n += 7) {
+            memcpy_bytes(dst, src, sizeof(dst));
+            memmove(dst + shift, dst, n);
+            for (uint32_t i = 0; i < n; i++) {
+                errors += dst[shift + i] != src[i];
+            }
+            memcpy_bytes(dst, src, sizeof(dst));
+            memmove(dst, dst + shift, n);
+            for (uint32_t i = 0; i < n; i++) {
+                errors += dst[i] != src[shift + i];
+            }
+        }
+    }
+    printf("Overlapping memmove: %s\n", errors == 0 ? "PASS" : "FAIL");
+
+    /* Ticks per copy: byte loop, word loop, and memcpy (which takes RVV when present) */
+    static uint8_t big_src[16384 + 4], big_dst[16384 + 4];
+    static const uint32_t sizes[] = { 16, 256, 4096, 16384 };
+    printf("Vector path: %s\n", mem_has_rvv() ? "yes" : "no");
+    for (uint32_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        for (uint32_t misalign = 0; misalign < 2; misalign++) {
+            uint32_t n = sizes[s];
+            uint32_t rounds = 65536 / n;
+            uint32_t ticks[3];
+            for (int path = 0; path < 3; path++) {
+                uint64_t t0 = read_time();
+                for (uint32_t r = 0; r < rounds; r++) {
+                    uint8_t *d = big_dst + misalign;
+                    const uint8_t *sp = big_src + misalign * 3;
+                    if (path == 0) {
+                        memcpy_bytes(d, sp, n);
+                    } else if (path == 1) {
+                        memcpy_words(d, sp, n);
+                    } else {
+                        memcpy(d, sp, n);
+                    }
+                }
+                ticks[path] = (uint32_t)(read_time() - t0);
+            }
+            printf("%u bytes%s x%u: bytes %u, words %u, memcpy %u ticks\n",
+                   n, misalign ? " (misaligned)" : "", rounds, ticks[0], ticks[1], ticks[2]);
+        }
+    }
+
+    printf("\nMemory copy test completed!\n");
+}
+
+/* Test the buffered console: one device write (and at most one SBI call) per line */
+void test_console(void) {
+    printf("\n=== Console Test ===\n");
+
+    const struct console_stats *stats = console_get_stats();
+    uint32_t per_line = console_backend() == CONSOLE_SBI_DBCN ? 1 : 0;
+    printf("Backend: %s\n", console_backend() == CONSOLE_SBI_DBCN ? "SBI debug console" :
+                            console_backend() == CONSOLE_UART ? "UART" : "legacy SBI putchar");
+
+    /* A 60-character line, built from several conversions */
+    uint32_t flushes = stats->flushes, calls = stats->sbi_calls, bytes = stats->bytes;
+    printf("%s %d %x %s\n", "console line of sixty characters here:", -12345, 0xC0FFEEu, "done");
+    int errors = stats->flushes - flushes != 1 || stats->bytes - bytes != 60;
+    errors += console_backend() != CONSOLE_SBI_LEGACY && stats->sbi_calls - calls != per_line;
+    printf("60-char printf: %u flush, %u SBI call(s) (one per byte before): %s\n",
+           stats->flushes - flushes, stats->sbi_calls - calls, errors == 0 ? "PASS" : "FAIL");
+
+    /* A line built from several printf calls still goes out once */
+    flushes = stats->flushes;
+    printf("one line, ");
+    printf("three %s, ", "printfs");
+    printf("one flush\n");
+    errors = stats->flushes - flushes != 1;
+    printf("Line from three printfs: %s\n", errors == 0 ? "PASS" : "FAIL");
+
+    /* Lines longer than the buffer go out in buffer-sized pieces; bulk writes flush what is pending first */
+    flushes = stats->flushes;
+    for (int i = 0; i < CONSOLE_LINE_MAX + 20; i++) {
+        putchar('=');
+    }
+    putchar('\n');
+    errors = stats->flushes - flushes != 2;
+    flushes = stats->flushes;
+    putchar('>');
+    console_write(" bulk\n", 6);
+    errors += stats->flushes - flushes != 2;
+    printf("Long lines and bulk writes: %s\n", errors == 0 ? "PASS" : "FAIL");
+
+    printf("\nConsole test completed!\n");
+}
+
+/* Test the trace ring: hot paths record events, the shell decodes them later */
+void test_trace(void) {
+    printf("\n=== Trace Ring Test ===\n");
+
+    /* fd and epoll operations leave events with their arguments */
+    fd_init();
+    epoll_init();
+    trace_clear();
+    int fds[2];
+    pipe_create(fds);
+    int epfd = epoll_create(0);
+    struct epoll_event ev = { EPOLLIN, 7 };
+    epoll_ctl(epfd, EPOLL_CTL_ADD, fds[0], &ev);
+    fd_write(fds[1], "x", 1);
+    struct epoll_event out[2];
+    epoll_wait(epfd, out, 2, 0);
+    epoll_close(epfd);
+    fd_close(fds[0]);
+    fd_close(fds[1]);
+
+    static const uint32_t expect[] = { TRACE_FD_ALLOC, TRACE_FD_ALLOC, TRACE_EPOLL_CTL, TRACE_EPOLL_READY,
+                                       TRACE_EPOLL_WAIT, TRACE_FD_CLOSE, TRACE_FD_CLOSE };
+    struct trace_ring *ring = &trace_rings[cpu_id() % MAX_HARTS];
+    int errors = ring->head != sizeof(expect) / sizeof(expect[0]);
+    for (uint32_t i = 0; i < ring->head && i < sizeof(expect) / sizeof(expect[0]); i++) {
+        errors += ring->events[i].id != expect[i];
+    }
+    errors += ring->events[2].args[2] != (uint32_t)fds[0] || ring->events[4].args[1] != 1;
+    errors += ring->events[6].time < ring->events[0].time;
+    trace_dump(16);
+    printf("Events recorded in order with arguments: %s\n", errors == 0 ? "PASS" : "FAIL");
+
+    /* A full ring keeps the newest events */
+    trace_clear();
+    for (uint32_t i = 0; i < TRACE_RING_SIZE + 44; i++) {
+        trace(TRACE_FD_CLOSE, i, 0, 0);
+    }
+    errors = trace_count() != TRACE_RING_SIZE;
+    errors += ring->events[ring->head % TRACE_RING_SIZE].args[0] != 44;
+    printf("Wrap-around keeps the newest %u: %s\n", TRACE_RING_SIZE, errors == 0 ? "PASS" : "FAIL");
+
+    /* Cost of a trace event against the printf it replaced */
+    const uint32_t rounds = 1000;
+    uint64_t t0 = read_time();
+    for (uint32_t i = 0; i < rounds; i++) {
+        trace(TRACE_FD_ALLOC, i, FD_TYPE_PIPE, 0);
+    }
+    uint32_t trace_ticks = (uint32_t)(read_time() - t0) / rounds;
+    t0 = read_time();
+    for (int i = 0; i < 4; i++) {
+        printf("FD: Allocated fd %d (type=%d)\n", i, FD_TYPE_PIPE);
+    }
+    uint32_t printf_ticks = (uint32_t)(read_time() - t0) / 4;
+    printf("Per event: trace %u ticks, printf %u ticks\n", trace_ticks, printf_ticks);
+    trace_clear();
+
+    printf("\nTrace ring test completed!\n");
+}
+
+/* 비교용 바이트 단위 문자열 함수 (이전 구현) */
+static size_t strlen_bytes(const char *s) {
+    size_t len = 0;
+    while (s[len]) len++;
+    return len;
+}
+
+static int strcmp_bytes(const char *s1, const char *s2) {
+    while (*s1 && (*s1 == *s2)) {
+        s1++;
+        s2++;
+    }
+    return *(const uint8_t *)s1 - *(const uint8_t *)s2;
+}
+
+static const char *strstr_bytes(const char *haystack, const char *needle) {
+    if (!*needle) return haystack;
+    for (const char *h = haystack; *h; h++) {
+        const char *h2 = h;
+        const char *n = needle;
+        while (*h2 && *n && *h2 == *n) {
+            h2++;
+            n++;
+        }
+        if (!*n) return h;
+    }
+    return NULL;
+}
+
+static int sign(int v) {
+    return (v > 0) - (v < 0);
+}
+
+/* String functions: every alignment and length against the byte loops, then timings */
+void test_string_ops(void) {
+    printf("\n=== String Function Test ===\n");
+
+    static char a[200], b[200];
+    int errors = 0;
+    for (uint32_t align = 0; align < 4; align++) {
+        for (uint32_t len = 0; len < 80; len++) {
+            char *s = a + align;
+            for (uint32_t i = 0; i < len; i++) {
+                s[i] = (char)('a' + (i * 7) % 26);
+            }
+            s[len] = '\0';
+            errors += strlen(s) != len || strlen_words(s) != len;
+            errors += strchr(s, 'z') != (char *)strstr_bytes(s, "z") || strchr(s, '\0') != s + len;
+            errors += len > 5 && strchr_words(s, s[len - 3]) != (char *)strstr_bytes(s, (char[]){ s[len - 3], 0 });
+
+            /* Same and different alignments, differing at every position */
+            for (uint32_t balign = 0; balign < 4; balign++) {
+                char *t = b + balign;
+                strcpy(t, s);
+                errors += strcmp(s, t) != 0 || strcmp_words(s, t) != 0;
+                for (uint32_t d = 0; d < len; d += 5) {
+                    t[d] = (char)(t[d] + 1);
+                    errors += sign(strcmp(s, t)) != sign(strcmp_bytes(s, t));
+                    errors += sign(strcmp_words(t, s)) != sign(strcmp_bytes(t, s));
+                    t[d] = s[d];
+                }
+                t[len / 2] = '\0';
+                errors += sign(strcmp(s, t)) != sign(strcmp_bytes(s, t));
+            }
+        }
+    }
+    printf("strlen, strchr and strcmp at every alignment: %s\n", errors == 0 ? "PASS" : "FAIL");
+
+    /* strstr against the quadratic search, including near misses and repeats */
+    static const char *needles[] = { "", "a", "aab", "abcab", "xyz", "abcabcabd", "ba", "cabcabca" };
+    static char text[400];
+    for (uint32_t i = 0; i < sizeof(text) - 1; i++) {
+        text[i] = "abcabcabcaab"[i % 12];
+    }
+    text[sizeof(text) - 1] = '\0';
+    errors = 0;
+    for (uint32_t i = 0; i < sizeof(needles) / sizeof(needles[0]); i++) {
+        for (uint32_t start = 0; start < 20; start++) {
+            errors += strstr(text + start, needles[i]) != (char *)strstr_bytes(text + start, needles[i]);
+        }
+    }
+    errors += strstr("abc", "abcd") != NULL;
+    printf("Boyer-Moore-Horspool strstr: %s\n", errors == 0 ? "PASS" : "FAIL");
+
+    /* Ticks: filename-sized compares, a long strlen, and a search through 16 KB of text */
+    static char name1[64], name2[64], big[16384];
+    for (int i = 0; i < 40; i++) {
+        name1[i] = name2[i] = (char)('a' + i % 26);
+    }
+    name2[38] = '#';
+    for (uint32_t i = 0; i < sizeof(big) - 1; i++) {
+        big[i] = "the quick brown fox jumps over the lazy dog "[i % 44];
+    }
+    big[sizeof(big) - 1] = '\0';
+    const uint32_t rounds = 2000;
+    volatile int sink = 0;
+    uint32_t ticks[6];
+
+    uint64_t t0 = read_time();
+    for (uint32_t r = 0; r < rounds; r++) sink += strcmp_bytes(name1, name2);
+    ticks[0] = (uint32_t)(read_time() - t0);
+    t0 = read_time();
+    for (uint32_t r = 0; r < rounds; r++) sink += strcmp(name1, name2);
+    ticks[1] = (uint32_t)(read_time() - t0);
+    t0 = read_time();
+    for (uint32_t r = 0; r < 20; r++) sink += (int)strlen_bytes(big);
+    ticks[2] = (uint32_t)(read_time() - t0);
+    t0 = read_time();
+    for (uint32_t r = 0; r < 20; r++) sink += (int)strlen(big);
+    ticks[3] = (uint32_t)(read_time() - t0);
+    t0 = read_time();
+    for (uint32_t r = 0; r < 20; r++) sink += strstr_bytes(big, "the lazy cat") != NULL;
+    ticks[4] = (uint32_t)(read_time() - t0);
+    t0 = read_time();
+    for (uint32_t r = 0; r < 20; r++) sink += strstr(big, "the lazy cat") != NULL;
+    ticks[5] = (uint32_t)(read_time() - t0);
+    (void)sink;
+
+    printf("40-char strcmp x%u: bytes %u, library %u ticks\n", rounds, ticks[0], ticks[1]);
+    printf("16 KB strlen x20: bytes %u, library %u ticks\n", ticks[2], ticks[3]);
+    printf("16 KB strstr x20: naive %u, Horspool %u ticks\n", ticks[4], ticks[5]);
+
+    printf("\nString function test completed!\n");
+}
+
+/* 핑퐁: 두 프로세스가 번갈아 yield, 순서와 전환 너머로 살아 있는 값을 확인 */
+#define PINGPONG_ROUNDS 10000
+static volatile uint32_t pingpong_turn;
+static uint32_t pingpong_errors;
+
+static void pingpong_task(uint32_t me) {
+    uint32_t in_register = me * 0x01010101u;
+    volatile uint32_t on_stack = ~in_register;
+    for (uint32_t i = 0; i < PINGPONG_ROUNDS; i++) {
+        pingpong_errors += pingpong_turn % 2 != me;
+        pingpong_turn++;
+        yield();
+        pingpong_errors += in_register != me * 0x01010101u || on_stack != ~in_register;
+    }
+}
+
+static void pingpong_ping(void) {
+    pingpong_task(0);
+}
+
+static void pingpong_pong(void) {
+    pingpong_task(1);
+}
+
+/* Test the callee-saved context switch: ping-pong yields between two processes */
+void test_context_switch(void) {
+    printf("\n=== Context Switch Test ===\n");
+
+    pingpong_turn = 0;
+    pingpong_errors = 0;
+    struct process *ping = create_process(pingpong_ping);
+    struct process *pong = create_process(pingpong_pong);
+    if (!ping || !pong) {
+        printf("Create processes: FAIL\n");
+        return;
+    }
+
+    /* Runs both from the boot flow until they exit */
+    uint64_t start = read_time();
+    schedule();
+    uint32_t ticks = (uint32_t)(read_time() - start);
+
+    int errors = pingpong_errors != 0 || pingpong_turn != 2 * PINGPONG_ROUNDS || current_proc != NULL;
+    errors += ping->state != PROC_UNUSED || pong->state != PROC_UNUSED;
+    printf("Ping-pong order and saved registers: %s\n", errors == 0 ? "PASS" : "FAIL");
+
+    uint32_t switches = 2 * PINGPONG_ROUNDS;
+    uint32_t per_ms = ticks ? switches * (TIMEBASE_HZ / 1000) / ticks : 0;
+    printf("%u yields in %u ticks: %u ticks per switch, %u switches/s\n",
+           switches, ticks, ticks / switches, per_ms * 1000);
+
+    printf("\nContext switch test completed!\n");
+}
+
+/* 라운드로빈: 프로세스마다 실행 순서를 기록하고 yield */
+#define ROUND_ROBIN_ROUNDS 3
+static int round_robin_log[ROUND_ROBIN_ROUNDS * MAX_PROCESSES];
+static uint32_t round_robin_len;
+
+static void round_robin_task(void) {
+    for (int i = 0; i < ROUND_ROBIN_ROUNDS; i++) {
+        round_robin_log[round_robin_len++] = current_proc->pid;
+        yield();
+    }
+}
+
+/* 막히기 전에 깨우기가 먼저 온 경우: 이미 큐에 있으므로 schedule이 다시 넣으면 안 됨 */
+static void early_wake_task(void) {
+    current_proc->state = PROC_BLOCKED;
+    process_wake(current_proc);
+    create_process(round_robin_task);            /* Queued behind it */
+    schedule();
+    round_robin_log[round_robin_len++] = current_proc->pid;
+}
+
+/* Test the ready queue and free-slot list: creation order is run order, exited slots come back */
+void test_round_robin(void) {
+    printf("\n=== Round-Robin Scheduler Test ===\n");
+
+    int pids[MAX_PROCESSES];
+    int errors = 0;
+    round_robin_len = 0;
+    for (int i = 0; i < MAX_PROCESSES; i++) {
+        struct process *proc = create_process(round_robin_task);
+        errors += proc == NULL;
+        pids[i] = proc ? proc->pid : -1;
+    }
+    errors += create_process(round_robin_task) != NULL;
+    printf("Fill all %d slots, then refuse one more: %s\n", MAX_PROCESSES, errors == 0 ? "PASS" : "FAIL");
+
+    schedule();
+    errors = round_robin_len != ROUND_ROBIN_ROUNDS * MAX_PROCESSES;
+    for (uint32_t i = 0; i < round_robin_len; i++) {
+        errors += round_robin_log[i] != pids[i % MAX_PROCESSES];
+    }
+    printf("Runs in creation order, every round: %s\n", errors == 0 ? "PASS" : "FAIL");
+
+    /* Every slot is free again: the last one to exit is handed out first */
+    errors = 0;
+    round_robin_len = 0;
+    for (int i = 0; i < MAX_PROCESSES; i++) {
+        errors += create_process(round_robin_task) == NULL;
+    }
+    schedule();
+    errors += round_robin_len != ROUND_ROBIN_ROUNDS * MAX_PROCESSES || current_proc != NULL;
+    printf("Exited slots reused: %s\n", errors == 0 ? "PASS" : "FAIL");
+
+    /* A wakeup that beats the sleeper to schedule() leaves one queue entry */
+    round_robin_len = 0;
+    errors = create_process(early_wake_task) == NULL;
+    for (int i = 0; i < 3; i++) {
+        errors += create_process(round_robin_task) == NULL;
+    }
+    schedule();
+    errors += round_robin_len != 1 + 4 * ROUND_ROBIN_ROUNDS || current_proc != NULL;
+    printf("Wakeup before schedule: %s\n", errors == 0 ? "PASS" : "FAIL");
+
+    printf("\nRound-robin scheduler test completed!\n");
+}
+
+/* 결과 문자열과 반환값을 기대값과 비교, 다르면 출력 */
+static int check_format(const char *got, int ret, const char *want) {
+    if (strcmp(got, want) == 0 && ret == (int)strlen(want)) {
+        return 0;
+    }
+    printf("  got \"%s\" (%d), want \"%s\"\n", got, ret, want);
+    return 1;
+}
+
+/* Test snprintf/vsnprintf/sscanf (the same formatting engine as printf) */
+void test_snprintf(void) {
+    printf("\n=== snprintf Test ===\n");
+
+    char buf[64];
+    int errors = 0;
+    int ret;
+
+    ret = snprintf(buf, sizeof(buf), "[%5d|%-5d|%05d|%+d|% d]", 42, 42, -42, 7, 7);
+    errors += check_format(buf, ret, "[   42|42   |-0042|+7| 7]");
+    ret = snprintf(buf, sizeof(buf), "%x %4x %04X %#x %.3u", 0xbeefu, 0xau, 0xabu, 255u, 5u);
+    errors += check_format(buf, ret, "0000beef    a 00AB 0x000000ff 005");
+    ret = snprintf(buf, sizeof(buf), "%llx %llu %lld", 0x123456789abcdefULL, 18446744073709551615ULL,
+                   -9223372036854775807LL - 1);
+    errors += check_format(buf, ret, "0123456789abcdef 18446744073709551615 -9223372036854775808");
+    ret = snprintf(buf, sizeof(buf), "%zu %lu %p %c%c %%", (size_t)4096, 7ul, (void *)0x80200000, 'o', 'k');
+    errors += check_format(buf, ret, "4096 7 0x80200000 ok %");
+    ret = snprintf(buf, sizeof(buf), "<%.*s|%-6s|%6.2s|%s>", 3, "abcdef", "ab", "xyz", (char *)NULL);
+    errors += check_format(buf, ret, "<abc|ab    |    xy|(null)>");
+    printf("Conversions, flags, widths: %s\n", errors == 0 ? "PASS" : "FAIL");
+
+    /* Truncation: always terminated, returns the length it would have written */
+    errors = 0;
+    ret = snprintf(buf, 8, "%s-%d", "truncated", 12345);
+    errors += ret != 15 || strcmp(buf, "truncat") != 0;
+    buf[0] = 'x';
+    ret = snprintf(buf, 0, "%d", 123);
+    errors += ret != 3 || buf[0] != 'x';
+    ret = snprintf(buf, 1, "abc");
+    errors += ret != 3 || buf[0] != '\0';
+    printf("Truncation and return value: %s\n", errors == 0 ? "PASS" : "FAIL");
+
+    /* sscanf */
+    errors = 0;
+    int d = 0;
+    unsigned u = 0, x = 0;
+    char word[16], ch = 0;
+    ret = sscanf("  -17 42 0x1F name:disk rest", "%d %u %x %4s%c", &d, &u, &x, word, &ch);
+    errors += ret != 5 || d != -17 || u != 42 || x != 0x1f || strcmp(word, "name") != 0 || ch != ':';
+    ret = sscanf("pid=12 vr=abc", "pid=%d vr=%u", &d, &u);
+    errors += ret != 1 || d != 12;
+    printf("sscanf: %s\n", errors == 0 ? "PASS" : "FAIL");
+
+    printf("\nsnprintf test completed!\n");
+}
+
+/* Test the hashed flat RAM filesystem */
+void test_ramfs(void) {
+    printf("\n=== RAM Filesystem Scaling Test ===\n");
+
+    const uint32_t count = 2000;
+    char name[MAX_FILENAME];
+    int errors = 0;
+
+    /* Thousands of files: the table grows, lookups stay one probe away */
+    uint64_t t0 = read_time();
+    for (uint32_t i = 0; i < count; i++) {
+        ramfs_name(name, i);
+        errors += fs_create(name, 0) < 0;
+        errors += fs_write(name, &i, sizeof(i)) < 0;
+    }
+    uint32_t create_ticks = (uint32_t)(read_time() - t0);
+
+    t0 = read_time();
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t value = 0;
+        ramfs_name(name, i);
+        errors += fs_read(name, &value, sizeof(value)) != sizeof(value) || value != i;
+    }
+    uint32_t lookup_ticks = (uint32_t)(read_time() - t0);
+    printf("%u files: %u ticks per create, %u ticks per lookup\n",
+           count, create_ticks / count, lookup_ticks / count);
+    printf("Create and look up thousands of files: %s\n", errors == 0 ? "PASS" : "FAIL");
+
+    /* Deleting leaves tombstones that later creates reuse */
+    errors = 0;
+    for (uint32_t i = 0; i < count; i += 2) {
+        ramfs_name(name, i);
+        errors += fs_delete(name) < 0;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        ramfs_name(name, i);
+        errors += fs_exists(name) != (int)(i & 1);
+    }
+    for (uint32_t i = 0; i < count; i += 2) {
+        ramfs_name(name, i);
+        errors += fs_create(name, 0) < 0;
+    }
+    errors += fs_create("ram7", 0) >= 0;
+    printf("Delete, re-create and duplicates: %s\n", errors == 0 ? "PASS" : "FAIL");
+
+    /* A file well past the old 1 KB limit, written in pieces with a hole in it */
+    static uint8_t chunk[3000];
+    errors = fs_create("big.bin", 0) < 0;
+    for (uint32_t off = 0; off < 60000; off += sizeof(chunk)) {
+        for (uint32_t i = 0; i < sizeof(chunk); i++) {
+            chunk[i] = (uint8_t)((off + i) * 7);
+        }
+        errors += fs_write_at("big.bin", chunk, off, sizeof(chunk)) != (int)sizeof(chunk);
+    }
+    errors += fs_write_at("big.bin", "end", 70000, 3) != 3;
+    for (uint32_t off = 0; off < 60000; off += sizeof(chunk)) {
+        errors += fs_read_at("big.bin", chunk, off + 100, sizeof(chunk)) != (int)sizeof(chunk);
+        for (uint32_t i = 0; i < sizeof(chunk) && off + 100 + i < 60000; i++) {
+            errors += chunk[i] != (uint8_t)((off + 100 + i) * 7);
+        }
+    }
+    errors += fs_read_at("big.bin", chunk, 65000, 10) != 10 || chunk[0] != 0;
+    errors += fs_read_at("big.bin", chunk, 70000, 100) != 3 || chunk[2] != 'd';
+    printf("64 KB file with a hole: %s\n", errors == 0 ? "PASS" : "FAIL");
+
+    errors = fs_delete("big.bin") < 0;
+    for (uint32_t i = 0; i < count; i++) {
+        ramfs_name(name, i);
+        errors += fs_delete(name) < 0;
+    }
+    printf("Cleanup: %s\n", errors == 0 ? "PASS" : "FAIL");
+
+    printf("\nRAM filesystem test completed!\n");
+}
+
+/* Test the VFS: RAM filesystem at "/" (mounted at boot), a B-tree ramdisk at "/t" */
+void test_vfs(void) {
+    printf("\n=== VFS Test ===\n");
+
+    static struct btree_filesystem fs;
+    struct block_device *dev = ramdisk_create(MAX_BLOCKS * 4);
+    inode_fs_format(&fs, dev);
+    fd_init();
+    int errors = vfs_mount("/t", &btree_vfs_ops, &fs) < 0;
+    errors += vfs_mount("/t", &btree_vfs_ops, &fs) >= 0;
+
+    /* The same calls reach either filesystem; each open file keeps its own offset */
+    int disk_fd = vfs_open("/t/notes.txt", VFS_O_CREAT);
+    int ram_fd = vfs_open("/notes.txt", VFS_O_CREAT);
+    char buf[16];
+    errors += disk_fd < 0 || ram_fd < 0;
+    errors += fd_write(disk_fd, "hello world", 11) != 11 || fd_write(ram_fd, "ram", 3) != 3;
+    errors += vfs_seek(disk_fd, 6) < 0 || fd_read(disk_fd, buf, sizeof(buf)) != 5 || buf[0] != 'w' || buf[4] != 'd';
+    errors += vfs_fsize(disk_fd) != 11 || vfs_fsize(ram_fd) != 3;
+    errors += btree_fs_read(&fs, "notes.txt", buf, sizeof(buf)) != 11 || fs_read("notes.txt", buf, 3) != 3 || buf[2] != 'm';
+    printf("Read, write and seek on both filesystems: %s\n", errors == 0 ? "PASS" : "FAIL");
+
+    /* Longest prefix wins: "/tx" is not under "/t" */
+    errors = vfs_create("/tx") < 0 || !fs_exists("tx") || vfs_unlink("/tx") < 0;
+    errors += vfs_open("/t/missing", 0) >= 0;
+
+    /* Open files hold their filesystem and their file */
+    errors += vfs_umount("/t") >= 0 || fs_delete("notes.txt") >= 0 || vfs_unlink("/t/notes.txt") >= 0;
+    fd_close(disk_fd);
+    fd_close(ram_fd);
+    struct btree_file *bf = btree_file_open(&fs, "notes.txt");
+    errors += !bf || btree_fs_delete(&fs, "notes.txt") >= 0;
+    if (bf) {
+        btree_file_close(bf);
+    }
+    errors += vfs_unlink("/t/notes.txt") < 0 || btree_fs_open(&fs, "notes.txt") >= 0;
+    errors += vfs_unlink("/notes.txt") < 0 || fs_exists("notes.txt");
+    errors += vfs_umount("/t") < 0 || vfs_open("/t/notes.txt", 0) >= 0;
+    printf("Mount resolution, unlink and busy checks: %s\n", errors == 0 ? "PASS" : "FAIL");
+
+    /* Listing "/t" shows "/t/a" but not "/tx" or "/t/a/b"; paths inside a mount are refused */
+    errors = vfs_mount("/t", &btree_vfs_ops, &fs) < 0;
+    const char *others[3] = { "/tx", "/t/a/b", "/t/a" };
+    for (int i = 0; i < 3; i++) {
+        errors += vfs_mount(others[i], &ramfs_vfs_ops, NULL) < 0;
+        errors += vfs_list("/t") != (i == 2);
+        errors += vfs_umount(others[i]) < 0;
+    }
+    errors += vfs_list("/t/notes") >= 0;
+    errors += vfs_umount("/t") < 0;
+    printf("Listing mount points: %s\n", errors == 0 ? "PASS" : "FAIL");
+
+    inode_fs_unmount(&fs);
+    ramdisk_destroy(dev);
+
+    printf("\nVFS test completed!\n");
+}
+
 /* B-Tree Filesystem Test */
 extern void test_btree_filesystem(void);
 
@@ -197,9 +1071,20 @@ void test_all_features(void) {
     printf("  Testing All Features\n");
     printf("========================================\n");
 
+    test_console();
     test_rbtree();
     test_cfs();
+    test_context_switch();
+    test_round_robin();
     test_epoll();
+    test_trace();
+    test_vectored_fds();
+    test_io_uring();
+    test_mem_ops();
+    test_string_ops();
+    test_snprintf();
+    test_ramfs();
+    test_vfs();
     test_btree_filesystem();
 
     printf("\n");
@@ -0,0 +1,73 @@
+// 호스트용 mkfs: 빈 B-트리 파일시스템 디스크 이미지 생성
+// 사용법: mkfs <image> [size_mb] [nocsum]   (기본 8MB, 블록 체크섬 사용)
+// 디스크 형식은 리틀 엔디언이며 커널과 같은 fs_format.h를 사용함
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../fs_format.h"
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <image> [size_mb] [nocsum]\n", argv[0]);
+        return 1;
+    }
+
+    uint32_t size_mb = argc > 2 ? (uint32_t)atoi(argv[2]) : 8;
+    uint32_t total_blocks = size_mb * 1024 * 1024 / FS_DISK_BLOCK_SIZE;
+    uint32_t data_start = FS_DATA_START(total_blocks);
+    if (size_mb == 0 || data_start >= total_blocks) {
+        fprintf(stderr, "mkfs: %u MB is too small\n", size_mb);
+        return 1;
+    }
+
+    uint8_t *image = calloc(total_blocks, FS_DISK_BLOCK_SIZE);
+    if (!image) {
+        perror("mkfs");
+        return 1;
+    }
+
+    struct fs_superblock *sb = (struct fs_superblock *)image;
+    sb->magic = FS_MAGIC;
+    sb->version = FS_VERSION;
+    sb->block_size = FS_DISK_BLOCK_SIZE;
+    sb->total_blocks = total_blocks;
+    sb->inode_count = FS_DISK_INODES;
+    sb->block_bitmap_start = FS_BLOCK_BITMAP_START;
+    sb->block_bitmap_blocks = FS_BITMAP_BLOCKS(total_blocks);
+    sb->inode_bitmap_start = FS_INODE_BITMAP_START(total_blocks);
+    sb->inode_bitmap_blocks = FS_BITMAP_BLOCKS(FS_DISK_INODES);
+    sb->inode_table_start = FS_INODE_TABLE_START(total_blocks);
+    sb->inode_table_blocks = FS_INODE_TABLE_BLOCKS;
+    sb->data_start = data_start;
+    sb->name_index_root = 0;
+    sb->free_blocks = total_blocks - data_start;
+    sb->free_inodes = FS_DISK_INODES;
+    sb->mount_count = 0;
+    sb->journal_start = FS_JOURNAL_START(total_blocks);
+    sb->journal_blocks = FS_JOURNAL_BLOCKS(total_blocks);
+    sb->journal_seq = 1;
+    sb->features = argc > 3 && strcmp(argv[3], "nocsum") == 0 ? 0 : FS_FEATURE_CSUM;
+    sb->csum_start = FS_CSUM_START(total_blocks);
+    sb->csum_blocks = FS_CSUM_BLOCKS(total_blocks);
+
+    // Metadata blocks are marked used; the i-node table, i-node bitmap, journal and
+    // checksum table stay zero
+    uint8_t *bitmap = image + FS_BLOCK_BITMAP_START * FS_DISK_BLOCK_SIZE;
+    for (uint32_t b = 0; b < data_start; b++) {
+        bitmap[b / 8] |= (uint8_t)(1 << (b % 8));
+    }
+
+    FILE *f = fopen(argv[1], "wb");
+    if (!f || fwrite(image, FS_DISK_BLOCK_SIZE, total_blocks, f) != total_blocks || fclose(f) != 0) {
+        perror(argv[1]);
+        return 1;
+    }
+    free(image);
+
+    printf("mkfs: %s: %u blocks (%u MB), %u i-nodes, data starts at block %u\n",
+           argv[1], total_blocks, size_mb, FS_DISK_INODES, data_start);
+    return 0;
+}
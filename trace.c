@@ -0,0 +1,70 @@
+#include "trace.h"
+
+struct trace_ring trace_rings[MAX_HARTS];
+
+// 이벤트 이름과 인자 형식 (enum trace_event_id 순서)
+static const struct {
+    const char *name;
+    const char *format;
+} trace_formats[TRACE_EVENT_COUNT] = {
+    [TRACE_SCHED_SWITCH] = { "sched_switch", "pid %d -> %d" },
+    [TRACE_PROC_CREATE]  = { "proc_create", "pid %u" },
+    [TRACE_CFS_ENQUEUE]  = { "cfs_enqueue", "pid %u vruntime=%u weight=%u" },
+    [TRACE_CFS_DEQUEUE]  = { "cfs_dequeue", "pid %u" },
+    [TRACE_CFS_UPDATE]   = { "cfs_update", "pid %u vruntime=%u delta=%u" },
+    [TRACE_CFS_PICK]     = { "cfs_pick", "pid %u vruntime=%u" },
+    [TRACE_CFS_PREEMPT]  = { "cfs_preempt", "pid %u -> %u" },
+    [TRACE_FD_ALLOC]     = { "fd_alloc", "fd %u type=%u" },
+    [TRACE_FD_CLOSE]     = { "fd_close", "fd %u" },
+    [TRACE_EPOLL_CTL]    = { "epoll_ctl", "epfd %d op=%u fd %u" },
+    [TRACE_EPOLL_READY]  = { "epoll_ready", "fd %u events=%x" },
+    [TRACE_EPOLL_WAIT]   = { "epoll_wait", "epfd %d ready=%u timeout=%d" },
+};
+
+// 링에 남아 있는 이벤트 수
+static uint32_t ring_held(struct trace_ring *ring) {
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    return head < TRACE_RING_SIZE ? head : TRACE_RING_SIZE;
+}
+
+void trace_dump(uint32_t max_events) {
+    for (int hart = 0; hart < MAX_HARTS; hart++) {
+        struct trace_ring *ring = &trace_rings[hart];
+        uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        uint32_t count = ring_held(ring);
+        if (count > max_events) {
+            count = max_events;
+        }
+        if (count == 0) {
+            continue;
+        }
+
+        printf("=== Trace: hart %d, %u of %u events ===\n", hart, count, head);
+        uint64_t start = ring->events[(head - count) & (TRACE_RING_SIZE - 1)].time;
+        for (uint32_t i = head - count; i != head; i++) {
+            struct trace_event *ev = &ring->events[i & (TRACE_RING_SIZE - 1)];
+            uint32_t delta = (uint32_t)(ev->time - start);
+            if (ev->id >= TRACE_EVENT_COUNT) {
+                printf("+%u event %u\n", delta, ev->id);
+                continue;
+            }
+            printf("+%u %s: ", delta, trace_formats[ev->id].name);
+            printf(trace_formats[ev->id].format, ev->args[0], ev->args[1], ev->args[2]);
+            printf("\n");
+        }
+    }
+}
+
+void trace_clear(void) {
+    for (int hart = 0; hart < MAX_HARTS; hart++) {
+        __atomic_store_n(&trace_rings[hart].head, 0, __ATOMIC_RELEASE);
+    }
+}
+
+uint32_t trace_count(void) {
+    uint32_t total = 0;
+    for (int hart = 0; hart < MAX_HARTS; hart++) {
+        total += ring_held(&trace_rings[hart]);
+    }
+    return total;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "kernel.h"
+
+// 바이너리 트레이스: 하트마다 링 하나, 이벤트는 시각/번호/인자 세 개를 저장만 하고
+// 사람이 읽는 형식으로 바꾸는 일은 나중에 셸의 trace 명령(trace_dump)에서 함
+// 링은 자기 하트만 쓰므로 잠금 없이 저장한 뒤 head를 올림 (가득 차면 오래된 것부터 덮어씀)
+
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED 1
+#endif
+
+#define TRACE_RING_SIZE 256                      // Events per hart (power of two)
+
+// 이벤트 번호 (trace.c의 이름/형식 표와 같은 순서)
+enum trace_event_id {
+    TRACE_SCHED_SWITCH,                          // pid from, pid to
+    TRACE_PROC_CREATE,                           // pid
+    TRACE_CFS_ENQUEUE,                           // pid, vruntime (low word), weight
+    TRACE_CFS_DEQUEUE,                           // pid
+    TRACE_CFS_UPDATE,                            // pid, vruntime, delta
+    TRACE_CFS_PICK,                              // pid, vruntime
+    TRACE_CFS_PREEMPT,                           // pid out, pid in
+    TRACE_FD_ALLOC,                              // fd, type
+    TRACE_FD_CLOSE,                              // fd
+    TRACE_EPOLL_CTL,                             // epfd, op, fd
+    TRACE_EPOLL_READY,                           // fd, events
+    TRACE_EPOLL_WAIT,                            // epfd, ready, timeout
+    TRACE_EVENT_COUNT
+};
+
+struct trace_event {
+    uint64_t time;                               // read_time() ticks
+    uint16_t id;
+    uint16_t hart;
+    uint32_t args[3];
+};
+
+struct trace_ring {
+    uint32_t head;                               // Events ever written; slot = head % size
+    struct trace_event events[TRACE_RING_SIZE];
+};
+
+extern struct trace_ring trace_rings[MAX_HARTS];
+
+#if TRACE_ENABLED
+static inline void trace(uint32_t id, uint32_t a0, uint32_t a1, uint32_t a2) {
+    uint32_t hart = cpu_id() % MAX_HARTS;
+    struct trace_ring *ring = &trace_rings[hart];
+    uint32_t head = ring->head;
+    struct trace_event *ev = &ring->events[head & (TRACE_RING_SIZE - 1)];
+    ev->time = read_time();
+    ev->id = (uint16_t)id;
+    ev->hart = (uint16_t)hart;
+    ev->args[0] = a0;
+    ev->args[1] = a1;
+    ev->args[2] = a2;
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
+#else
+static inline void trace(uint32_t id, uint32_t a0, uint32_t a1, uint32_t a2) {
+    (void)id;
+    (void)a0;
+    (void)a1;
+    (void)a2;
+}
+#endif
+
+void trace_dump(uint32_t max_events);            // Decode the newest events of every hart, oldest first
+void trace_clear(void);
+uint32_t trace_count(void);                      // Events currently held in all rings
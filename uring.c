@@ -0,0 +1,250 @@
+#include "uring.h"
+#include "common.h"
+
+/* worker가 돌아볼 링들 */
+static struct io_uring *rings[MAX_IO_URINGS];
+
+/* 링 생성 */
+struct io_uring *io_uring_setup(uint32_t entries, uint32_t flags) {
+    if (entries == 0 || entries > IORING_MAX_ENTRIES) {
+        printf("Error: Invalid ring size %u\n", entries);
+        return NULL;
+    }
+    uint32_t size = 1;
+    while (size < entries) {
+        size <<= 1;
+    }
+
+    int slot = -1;
+    for (int i = 0; i < MAX_IO_URINGS && slot < 0; i++) {
+        if (!rings[i]) {
+            slot = i;
+        }
+    }
+    if (slot < 0) {
+        printf("Error: No free io_uring slots\n");
+        return NULL;
+    }
+
+    struct io_uring *ring = (struct io_uring *)kmalloc(sizeof(struct io_uring));
+    struct io_uring_sqe *sqes = (struct io_uring_sqe *)kmalloc(size * sizeof(struct io_uring_sqe));
+    struct io_uring_cqe *cqes = (struct io_uring_cqe *)kmalloc(2 * size * sizeof(struct io_uring_cqe));
+    if (!ring || !sqes || !cqes) {
+        printf("Error: No memory for an io_uring\n");
+        kfree(ring);
+        kfree(sqes);
+        kfree(cqes);
+        return NULL;
+    }
+
+    memset(ring, 0, sizeof(struct io_uring));
+    ring->sq_mask = size - 1;
+    ring->sqes = sqes;
+    ring->cq_mask = 2 * size - 1;
+    ring->cqes = cqes;
+    ring->flags = flags;
+    rings[slot] = ring;
+    return ring;
+}
+
+/* 등록된 링 찾기: 시스템 콜 인자는 믿을 수 없으므로 rings[]에 있는 주소만 받아들임 */
+struct io_uring *io_uring_lookup(uint32_t addr) {
+    for (int i = 0; i < MAX_IO_URINGS; i++) {
+        if (rings[i] && (uint32_t)(uintptr_t)rings[i] == addr) {
+            return rings[i];
+        }
+    }
+    return NULL;
+}
+
+/* 링 해제 (대기 중인 요청은 완료 없이 버림) */
+void io_uring_destroy(struct io_uring *ring) {
+    if (!ring) {
+        return;
+    }
+    for (int i = 0; i < MAX_IO_URINGS; i++) {
+        if (rings[i] == ring) {
+            rings[i] = NULL;
+        }
+    }
+    kfree(ring->sqes);
+    kfree(ring->cqes);
+    kfree(ring);
+}
+
+static uint32_t cq_space(struct io_uring *ring) {
+    uint32_t head = __atomic_load_n(&ring->cq_head, __ATOMIC_ACQUIRE);
+    return ring->cq_mask + 1 - (ring->cq_tail - head);
+}
+
+/* CQE 하나 올리기 (요청을 가져갈 때 자리를 확인하므로 넘치지 않음) */
+static void io_uring_complete(struct io_uring *ring, uint64_t user_data, int32_t res) {
+    struct io_uring_cqe *cqe = &ring->cqes[ring->cq_tail & ring->cq_mask];
+    cqe->user_data = user_data;
+    cqe->res = res;
+    cqe->flags = 0;
+    __atomic_store_n(&ring->cq_tail, ring->cq_tail + 1, __ATOMIC_RELEASE);
+    ring->stats.completed++;
+}
+
+/* 요청 실행: 끝났으면 1과 결과, 아직 기다려야 하면 0 */
+static int io_uring_execute(const struct io_uring_sqe *sqe, int32_t *res) {
+    switch (sqe->opcode) {
+    case IORING_OP_NOP:
+        *res = 0;
+        return 1;
+    case IORING_OP_READ:
+        *res = fd_read(sqe->fd, sqe->addr, sqe->len);
+        return 1;
+    case IORING_OP_WRITE:
+        *res = fd_write(sqe->fd, sqe->addr, sqe->len);
+        return 1;
+    case IORING_OP_READV:
+        *res = fd_readv(sqe->fd, (const struct iovec *)sqe->addr, sqe->len);
+        return 1;
+    case IORING_OP_WRITEV:
+        *res = fd_writev(sqe->fd, (const struct iovec *)sqe->addr, sqe->len);
+        return 1;
+    case IORING_OP_FSYNC:
+        *res = fd_fsync(sqe->fd);
+        return 1;
+    case IORING_OP_POLL_ADD: {
+        if (!fd_get(sqe->fd)) {
+            *res = -1;
+            return 1;
+        }
+        int flags = fd_poll(sqe->fd) & sqe->poll_events;
+        *res = flags;
+        return flags != 0;
+    }
+    default:
+        *res = -1;
+        return 1;
+    }
+}
+
+/* 기다리던 요청을 다시 확인해 끝난 것을 완료, 완료한 수 반환 */
+static int io_uring_reap(struct io_uring *ring) {
+    int done = 0;
+    for (int i = 0; i < IORING_MAX_INFLIGHT && ring->inflight > 0; i++) {
+        struct io_uring_req *req = &ring->reqs[i];
+        int32_t res;
+        if (req->in_use && io_uring_execute(&req->sqe, &res)) {
+            io_uring_complete(ring, req->sqe.user_data, res);
+            req->in_use = 0;
+            ring->inflight--;
+            done++;
+        }
+    }
+    return done;
+}
+
+/* SQ에서 최대 max개를 가져가 실행 (완료할 자리와 대기 슬롯이 있을 때만) */
+static int io_uring_consume(struct io_uring *ring, uint32_t max) {
+    uint32_t tail = __atomic_load_n(&ring->sq_tail, __ATOMIC_ACQUIRE);
+    uint32_t taken = 0;
+
+    while (taken < max && ring->sq_head != tail &&
+           cq_space(ring) > ring->inflight && ring->inflight < IORING_MAX_INFLIGHT) {
+        struct io_uring_sqe sqe = ring->sqes[ring->sq_head & ring->sq_mask];
+        __atomic_store_n(&ring->sq_head, ring->sq_head + 1, __ATOMIC_RELEASE);
+        taken++;
+        ring->stats.submitted++;
+
+        int32_t res;
+        if (io_uring_execute(&sqe, &res)) {
+            io_uring_complete(ring, sqe.user_data, res);
+            continue;
+        }
+
+        // Not ready yet: park it until a later pass sees the event
+        for (int i = 0; i < IORING_MAX_INFLIGHT; i++) {
+            if (!ring->reqs[i].in_use) {
+                ring->reqs[i].sqe = sqe;
+                ring->reqs[i].in_use = 1;
+                break;
+            }
+        }
+        ring->inflight++;
+        ring->stats.polls_waited++;
+    }
+
+    return (int)taken;
+}
+
+/* 제출된 요청 처리 */
+int io_uring_enter(struct io_uring *ring, uint32_t to_submit, uint32_t min_complete) {
+    if (!ring) {
+        return -1;
+    }
+    ring->stats.enters++;
+
+    int taken = io_uring_consume(ring, to_submit);
+
+    // No wait queues to sleep on: keep re-checking while passes make progress
+    while (ring->inflight > 0 &&
+           ring->cq_tail - __atomic_load_n(&ring->cq_head, __ATOMIC_ACQUIRE) < min_complete) {
+        if (io_uring_reap(ring) == 0) {
+            break;
+        }
+    }
+
+    return taken;
+}
+
+/* 커널 worker */
+void io_uring_worker(void) {
+    for (int i = 0; i < MAX_IO_URINGS; i++) {
+        struct io_uring *ring = rings[i];
+        if (!ring) {
+            continue;
+        }
+        io_uring_reap(ring);
+        if (ring->flags & IORING_SETUP_SQPOLL) {
+            io_uring_consume(ring, ring->sq_mask + 1);
+        }
+    }
+}
+
+/* 요청하는 쪽: 다음 빈 SQE */
+struct io_uring_sqe *io_uring_get_sqe(struct io_uring *ring) {
+    uint32_t head = __atomic_load_n(&ring->sq_head, __ATOMIC_ACQUIRE);
+    if (ring->sq_local_tail - head > ring->sq_mask) {
+        return NULL;
+    }
+
+    struct io_uring_sqe *sqe = &ring->sqes[ring->sq_local_tail & ring->sq_mask];
+    ring->sq_local_tail++;
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+    return sqe;
+}
+
+/* 채운 SQE를 한 번에 올리고 enter 한 번으로 넘김 (SQPOLL 링은 worker가 가져가므로 올리기만 함) */
+int io_uring_submit(struct io_uring *ring) {
+    uint32_t count = ring->sq_local_tail - ring->sq_tail;
+    __atomic_store_n(&ring->sq_tail, ring->sq_local_tail, __ATOMIC_RELEASE);
+    if (ring->flags & IORING_SETUP_SQPOLL) {
+        return (int)count;
+    }
+    return io_uring_enter(ring, count, 0);
+}
+
+struct io_uring_cqe *io_uring_peek_cqe(struct io_uring *ring) {
+    uint32_t tail = __atomic_load_n(&ring->cq_tail, __ATOMIC_ACQUIRE);
+    if (ring->cq_head == tail) {
+        return NULL;
+    }
+    return &ring->cqes[ring->cq_head & ring->cq_mask];
+}
+
+void io_uring_cqe_seen(struct io_uring *ring) {
+    __atomic_store_n(&ring->cq_head, ring->cq_head + 1, __ATOMIC_RELEASE);
+}
+
+void io_uring_prep_rw(struct io_uring_sqe *sqe, int op, int fd, void *addr, uint32_t len, uint64_t user_data) {
+    sqe->opcode = (uint8_t)op;
+    sqe->fd = fd;
+    sqe->addr = addr;
+    sqe->len = len;
+    sqe->user_data = user_data;
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include "kernel.h"
+#include "fd.h"
+
+/* io_uring 방식 비동기 I/O: 제출 큐(SQ)와 완료 큐(CQ)를 요청하는 쪽과 커널이 함께 씀 */
+/* 요청하는 쪽은 SQE를 채우고 sq_tail을 올린 뒤 io_uring_enter 한 번으로 모아서 넘기고, */
+/* 커널 worker가 처리해 CQE를 cq_tail에 올림. 완료는 cq_head까지 읽고 올려서 돌려줌 */
+/* 읽기/쓰기는 fd의 현재 위치에서 제출 순서대로 진행됨 */
+
+#define IORING_MAX_ENTRIES  256
+#define IORING_MAX_INFLIGHT 32   /* 아직 완료되지 않은 요청 (POLL_ADD 대기 등) */
+#define MAX_IO_URINGS 8
+
+/* 연산 */
+#define IORING_OP_NOP      0
+#define IORING_OP_READ     1
+#define IORING_OP_WRITE    2
+#define IORING_OP_READV    3     /* addr = struct iovec 배열, len = 조각 수 */
+#define IORING_OP_WRITEV   4
+#define IORING_OP_FSYNC    5
+#define IORING_OP_POLL_ADD 6     /* poll_events 중 하나가 켜지면 완료, res = 켜진 FD_* 플래그 */
+
+/* io_uring_setup 플래그 */
+#define IORING_SETUP_SQPOLL (1 << 0)  /* worker가 enter 없이도 SQ를 가져감 */
+
+/* 제출 항목 */
+struct io_uring_sqe {
+    uint8_t opcode;          /* IORING_OP_* */
+    uint8_t flags;
+    uint16_t reserved;
+    int32_t fd;
+    void *addr;              /* 버퍼 또는 iovec 배열 */
+    uint32_t len;            /* 바이트 수 또는 조각 수 */
+    uint32_t poll_events;    /* POLL_ADD: 기다릴 FD_* 플래그 */
+    uint64_t user_data;      /* CQE로 그대로 돌려줌 */
+};
+
+/* 완료 항목 */
+struct io_uring_cqe {
+    uint64_t user_data;
+    int32_t res;             /* 전송한 바이트 수, 플래그 또는 음수 오류 */
+    uint32_t flags;
+};
+
+/* 처리 중인 요청 (worker가 SQ에서 꺼낸 뒤 완료될 때까지) */
+struct io_uring_req {
+    struct io_uring_sqe sqe;
+    int in_use;
+};
+
+struct io_uring_stats {
+    uint32_t enters;         /* io_uring_enter 호출 수 */
+    uint32_t submitted;      /* SQ에서 가져간 요청 */
+    uint32_t completed;      /* CQ에 올린 완료 */
+    uint32_t polls_waited;   /* 바로 끝나지 않아 대기한 POLL_ADD */
+};
+
+/* 링: 머리/꼬리는 양쪽이 함께 보므로 __atomic으로 읽고 씀 */
+struct io_uring {
+    /* 제출 큐: 요청하는 쪽이 sq_tail, 커널이 sq_head를 올림 */
+    uint32_t sq_head;
+    uint32_t sq_tail;
+    uint32_t sq_mask;
+    struct io_uring_sqe *sqes;
+
+    /* 완료 큐: 커널이 cq_tail, 요청하는 쪽이 cq_head를 올림 */
+    uint32_t cq_head;
+    uint32_t cq_tail;
+    uint32_t cq_mask;
+    struct io_uring_cqe *cqes;
+
+    /* 커널 쪽 상태 */
+    uint32_t flags;          /* IORING_SETUP_* */
+    uint32_t sq_local_tail;  /* io_uring_get_sqe로 채웠지만 아직 올리지 않은 꼬리 */
+    uint32_t inflight;
+    struct io_uring_req reqs[IORING_MAX_INFLIGHT];
+    struct io_uring_stats stats;
+};
+
+/* 링 생성 (entries는 2의 거듭제곱으로 올림, CQ는 그 두 배) / 해제 */
+struct io_uring *io_uring_setup(uint32_t entries, uint32_t flags);
+void io_uring_destroy(struct io_uring *ring);
+
+/* 시스템 콜이 넘긴 주소가 살아 있는 링이면 그 링, 아니면 NULL */
+struct io_uring *io_uring_lookup(uint32_t addr);
+
+/* SQ에 올라온 요청을 최대 to_submit개 가져가 처리하고, 완료가 min_complete개 쌓일 때까지 */
+/* 대기 중인 요청을 다시 확인함 (진행할 수 없으면 그냥 반환). 가져간 요청 수 반환 */
+int io_uring_enter(struct io_uring *ring, uint32_t to_submit, uint32_t min_complete);
+
+/* 커널 worker 한 번 실행: 모든 링의 대기 요청을 확인하고, SQPOLL 링은 SQ도 가져감 */
+void io_uring_worker(void);
+
+/* 요청하는 쪽 도우미 */
+struct io_uring_sqe *io_uring_get_sqe(struct io_uring *ring);   /* SQ가 가득 차면 NULL */
+int io_uring_submit(struct io_uring *ring);                      /* 채운 SQE를 올리고 enter */
+struct io_uring_cqe *io_uring_peek_cqe(struct io_uring *ring);  /* 완료가 없으면 NULL */
+void io_uring_cqe_seen(struct io_uring *ring);
+
+void io_uring_prep_rw(struct io_uring_sqe *sqe, int op, int fd, void *addr, uint32_t len, uint64_t user_data);
@@ -0,0 +1,311 @@
+#include "vfs.h"
+
+static struct vfs_mount mounts[VFS_MAX_MOUNTS];
+
+// path가 prefix의 앞 len바이트로 시작하는지
+static int path_prefix(const char *path, const char *prefix, uint32_t len) {
+    for (uint32_t i = 0; i < len; i++) {
+        if (path[i] != prefix[i]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// 경로를 맡는 마운트 (가장 긴 마운트 지점), rest에 그 아래 경로 ('/' 없이)
+static struct vfs_mount *vfs_resolve(const char *path, const char **rest) {
+    struct vfs_mount *best = NULL;
+    for (int i = 0; i < VFS_MAX_MOUNTS; i++) {
+        struct vfs_mount *mnt = &mounts[i];
+        if (!mnt->in_use || (best && mnt->path_len <= best->path_len)) {
+            continue;
+        }
+        // "/disk" covers "/disk" and "/disk/...", but not "/diskette"; "/" covers everything,
+        // including names without a leading '/'
+        uint32_t len = mnt->path_len;
+        if (len == 1 || (path_prefix(path, mnt->path, len) && (path[len] == '/' || path[len] == '\0'))) {
+            best = mnt;
+        }
+    }
+
+    if (best && rest) {
+        const char *p = path + (best->path_len == 1 ? 0 : best->path_len);
+        while (*p == '/') {
+            p++;
+        }
+        *rest = p;
+    }
+    return best;
+}
+
+int vfs_mount(const char *path, const struct vfs_ops *ops, void *sb) {
+    uint32_t len = 0;
+    while (path[len]) {
+        len++;
+    }
+    if (path[0] != '/' || len >= VFS_MOUNT_PATH_MAX || (len > 1 && path[len - 1] == '/')) {
+        printf("Error: Invalid mount point '%s'\n", path);
+        return -1;
+    }
+
+    struct vfs_mount *slot = NULL;
+    for (int i = 0; i < VFS_MAX_MOUNTS; i++) {
+        if (mounts[i].in_use && mounts[i].path_len == len && path_prefix(path, mounts[i].path, len)) {
+            printf("Error: '%s' is already mounted\n", path);
+            return -1;
+        }
+        if (!mounts[i].in_use && !slot) {
+            slot = &mounts[i];
+        }
+    }
+    if (!slot) {
+        printf("Error: No free mount slots\n");
+        return -1;
+    }
+
+    for (uint32_t i = 0; i <= len; i++) {
+        slot->path[i] = path[i];
+    }
+    slot->path_len = len;
+    slot->ops = ops;
+    slot->sb = sb;
+    slot->open_files = 0;
+    slot->in_use = 1;
+    return 0;
+}
+
+int vfs_umount(const char *path) {
+    struct vfs_mount *mnt = NULL;
+    for (int i = 0; i < VFS_MAX_MOUNTS && !mnt; i++) {
+        if (mounts[i].in_use && path_prefix(path, mounts[i].path, mounts[i].path_len + 1)) {
+            mnt = &mounts[i];
+        }
+    }
+    if (!mnt) {
+        printf("Error: '%s' is not a mount point\n", path);
+        return -1;
+    }
+    if (mnt->open_files > 0) {
+        printf("Error: '%s' has open files\n", path);
+        return -1;
+    }
+    mnt->in_use = 0;
+    return 0;
+}
+
+// fd 연산: 문맥은 열린 파일
+static int vfs_fd_read(void *ctx, void *buf, size_t count) {
+    struct vfs_file *file = (struct vfs_file *)ctx;
+    int n = file->mnt->ops->read(file, buf, count);
+    if (n > 0) {
+        file->offset += n;
+    }
+    return n;
+}
+
+static int vfs_fd_write(void *ctx, const void *buf, size_t count) {
+    struct vfs_file *file = (struct vfs_file *)ctx;
+    int n = file->mnt->ops->write(file, buf, count);
+    if (n > 0) {
+        file->offset += n;
+    }
+    return n;
+}
+
+static int vfs_fd_readv(void *ctx, const struct iovec *iov, int iovcnt) {
+    struct vfs_file *file = (struct vfs_file *)ctx;
+    if (!file->mnt->ops->readv) {
+        int total = 0;
+        for (int i = 0; i < iovcnt; i++) {
+            int n = vfs_fd_read(file, iov[i].iov_base, iov[i].iov_len);
+            if (n < 0) {
+                return total > 0 ? total : n;
+            }
+            total += n;
+            if ((size_t)n < iov[i].iov_len) {
+                break;
+            }
+        }
+        return total;
+    }
+
+    int n = file->mnt->ops->readv(file, iov, iovcnt);
+    if (n > 0) {
+        file->offset += n;
+    }
+    return n;
+}
+
+static int vfs_fd_writev(void *ctx, const struct iovec *iov, int iovcnt) {
+    struct vfs_file *file = (struct vfs_file *)ctx;
+    if (!file->mnt->ops->writev) {
+        int total = 0;
+        for (int i = 0; i < iovcnt; i++) {
+            int n = vfs_fd_write(file, iov[i].iov_base, iov[i].iov_len);
+            if (n < 0) {
+                return total > 0 ? total : n;
+            }
+            total += n;
+            if ((size_t)n < iov[i].iov_len) {
+                break;
+            }
+        }
+        return total;
+    }
+
+    int n = file->mnt->ops->writev(file, iov, iovcnt);
+    if (n > 0) {
+        file->offset += n;
+    }
+    return n;
+}
+
+static int vfs_fd_fsync(void *ctx) {
+    struct vfs_file *file = (struct vfs_file *)ctx;
+    return file->mnt->ops->fsync ? file->mnt->ops->fsync(file) : 0;
+}
+
+static int vfs_fd_poll(void *ctx) {
+    (void)ctx;
+    return FD_READABLE | FD_WRITABLE;
+}
+
+static void vfs_fd_close(void *ctx) {
+    struct vfs_file *file = (struct vfs_file *)ctx;
+    if (file->mnt->ops->release) {
+        file->mnt->ops->release(file);
+    }
+    file->mnt->open_files--;
+    kfree(file);
+}
+
+struct fd_ops vfs_fd_ops = {
+    .read = vfs_fd_read,
+    .write = vfs_fd_write,
+    .readv = vfs_fd_readv,
+    .writev = vfs_fd_writev,
+    .fsync = vfs_fd_fsync,
+    .poll = vfs_fd_poll,
+    .close = vfs_fd_close,
+};
+
+int vfs_open(const char *path, int flags) {
+    const char *rest;
+    struct vfs_mount *mnt = vfs_resolve(path, &rest);
+    if (!mnt || *rest == '\0') {
+        printf("Error: File not found\n");
+        return -1;
+    }
+
+    struct vfs_file *file = (struct vfs_file *)kmalloc(sizeof(struct vfs_file));
+    if (!file) {
+        return -1;
+    }
+    memset(file, 0, sizeof(struct vfs_file));
+    file->mnt = mnt;
+
+    if (mnt->ops->open(mnt, rest, file) < 0) {
+        // Not there yet: create it if asked to, quietly
+        if (!(flags & VFS_O_CREAT) || mnt->ops->create(mnt, rest) < 0 || mnt->ops->open(mnt, rest, file) < 0) {
+            if (!(flags & VFS_O_CREAT)) {
+                printf("Error: File not found\n");
+            }
+            kfree(file);
+            return -1;
+        }
+    }
+
+    int fd = fd_alloc(FD_TYPE_FILE, file, &vfs_fd_ops);
+    if (fd < 0) {
+        if (mnt->ops->release) {
+            mnt->ops->release(file);
+        }
+        kfree(file);
+        return -1;
+    }
+    mnt->open_files++;
+    return fd;
+}
+
+// fd의 열린 파일 (VFS 파일이 아니면 NULL)
+static struct vfs_file *vfs_file_get(int fd) {
+    struct fd *entry = fd_get(fd);
+    if (!entry || entry->ops != &vfs_fd_ops) {
+        return NULL;
+    }
+    return (struct vfs_file *)entry->context;
+}
+
+int vfs_seek(int fd, uint32_t offset) {
+    struct vfs_file *file = vfs_file_get(fd);
+    if (!file) {
+        return -1;
+    }
+    file->offset = offset;
+    return 0;
+}
+
+int vfs_fsize(int fd) {
+    struct vfs_file *file = vfs_file_get(fd);
+    if (!file) {
+        return -1;
+    }
+    return (int)file->mnt->ops->size(file);
+}
+
+int vfs_create(const char *path) {
+    const char *rest;
+    struct vfs_mount *mnt = vfs_resolve(path, &rest);
+    if (!mnt || *rest == '\0') {
+        printf("Error: Invalid path '%s'\n", path);
+        return -1;
+    }
+    return mnt->ops->create(mnt, rest);
+}
+
+int vfs_unlink(const char *path) {
+    const char *rest;
+    struct vfs_mount *mnt = vfs_resolve(path, &rest);
+    if (!mnt || *rest == '\0') {
+        printf("Error: Invalid path '%s'\n", path);
+        return -1;
+    }
+    return mnt->ops->unlink(mnt, rest);
+}
+
+int vfs_list(const char *path) {
+    const char *rest;
+    struct vfs_mount *mnt = vfs_resolve(path, &rest);
+    if (!mnt) {
+        printf("Error: Nothing mounted at '%s'\n", path);
+        return -1;
+    }
+    // ops->list shows a whole filesystem, so directories inside one cannot be listed
+    if (*rest) {
+        printf("Error: '%s' is not a mount point\n", path);
+        return -1;
+    }
+    mnt->ops->list(mnt);
+
+    // Mount points directly below this one show up as directories: "/a/b" under "/a",
+    // but neither "/ab" nor "/a/b/c"
+    uint32_t base = mnt->path_len == 1 ? 0 : mnt->path_len;
+    int shown = 0;
+    for (int i = 0; i < VFS_MAX_MOUNTS; i++) {
+        struct vfs_mount *sub = &mounts[i];
+        if (!sub->in_use || sub == mnt || sub->path_len <= base + 1 ||
+            !path_prefix(sub->path, mnt->path, base) || sub->path[base] != '/') {
+            continue;
+        }
+        const char *name = sub->path + base + 1;
+        int nested = 0;
+        for (const char *p = name; *p; p++) {
+            nested |= *p == '/';
+        }
+        if (!nested) {
+            printf("  %s/ (%s)\n", name, sub->ops->name);
+            shown++;
+        }
+    }
+    return shown;
+}
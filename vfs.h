@@ -0,0 +1,69 @@
+#pragma once
+#include "kernel.h"
+#include "fd.h"
+
+// VFS: 경로의 가장 긴 마운트 지점으로 파일시스템을 고르고, 열린 파일은 FD_TYPE_FILE fd로 다룸
+// 위치(offset)는 열린 파일마다 VFS가 관리하고, 파일시스템은 그 위치에서 읽고 씀
+// 캐시와 미리 읽기는 파일시스템이 열린 파일(node)에 두는 상태로 처리
+
+#define VFS_MAX_MOUNTS 4
+#define VFS_MOUNT_PATH_MAX 32
+
+// vfs_open 플래그
+#define VFS_O_CREAT (1 << 0)                     // Create the file if it does not exist
+
+struct vfs_mount;
+struct vfs_file;
+
+// 파일시스템별 연산 (path는 마운트 지점 아래의 나머지, 앞의 '/'는 뺀 것)
+// readv/writev/fsync는 선택: 없으면 조각마다 read/write, fsync는 할 일 없음
+struct vfs_ops {
+    const char *name;
+    int (*open)(struct vfs_mount *mnt, const char *path, struct vfs_file *file);  // Sets node/ino
+    void (*release)(struct vfs_file *file);
+    int (*read)(struct vfs_file *file, void *buf, uint32_t size);                 // At file->offset
+    int (*write)(struct vfs_file *file, const void *buf, uint32_t size);
+    int (*readv)(struct vfs_file *file, const struct iovec *iov, int iovcnt);
+    int (*writev)(struct vfs_file *file, const struct iovec *iov, int iovcnt);
+    int (*fsync)(struct vfs_file *file);
+    uint32_t (*size)(struct vfs_file *file);
+    int (*create)(struct vfs_mount *mnt, const char *path);
+    int (*unlink)(struct vfs_mount *mnt, const char *path);
+    void (*list)(struct vfs_mount *mnt);
+};
+
+struct vfs_mount {
+    char path[VFS_MOUNT_PATH_MAX];               // "/" or "/disk"
+    uint32_t path_len;
+    const struct vfs_ops *ops;
+    void *sb;                                    // Filesystem instance (struct btree_filesystem, ...)
+    int open_files;                              // Unmount waits until these are closed
+    int in_use;
+};
+
+// 열린 파일
+struct vfs_file {
+    struct vfs_mount *mnt;
+    void *node;                                  // Filesystem's open object
+    uint32_t ino;                                // Or a number, for filesystems that need no object
+    uint32_t offset;                             // Next read or write
+};
+
+int vfs_mount(const char *path, const struct vfs_ops *ops, void *sb);
+int vfs_umount(const char *path);
+
+// 파일 열기: fd 반환 (실패하면 -1), 읽기/쓰기는 fd_read/fd_write/fd_readv/fd_writev/fd_fsync
+int vfs_open(const char *path, int flags);
+int vfs_seek(int fd, uint32_t offset);
+int vfs_fsize(int fd);                           // File size, or -1 if fd is not a VFS file
+
+int vfs_create(const char *path);
+int vfs_unlink(const char *path);
+// 마운트 지점의 파일과 바로 아래 마운트 지점 출력 (마운트 지점만 가능), 보인 마운트 수 반환 (실패하면 -1)
+int vfs_list(const char *path);
+
+extern struct fd_ops vfs_fd_ops;
+
+// 파일시스템 연산 (RAM 파일시스템은 kernel.c, B-Tree 파일시스템은 inode.c)
+extern const struct vfs_ops ramfs_vfs_ops;
+extern const struct vfs_ops btree_vfs_ops;
@@ -0,0 +1,100 @@
+#pragma once
+#include "kernel.h"
+
+// QEMU virt 머신의 virtio-mmio 슬롯 (0x10001000부터 0x1000 간격으로 8개)
+#define VIRTIO_MMIO_BASE   0x10001000
+#define VIRTIO_MMIO_STRIDE 0x1000
+#define VIRTIO_MMIO_SLOTS  8
+
+// virtio-mmio 레지스터 오프셋
+#define VIRTIO_REG_MAGIC               0x000
+#define VIRTIO_REG_VERSION             0x004
+#define VIRTIO_REG_DEVICE_ID           0x008
+#define VIRTIO_REG_DEVICE_FEATURES     0x010
+#define VIRTIO_REG_DEVICE_FEATURES_SEL 0x014
+#define VIRTIO_REG_DRIVER_FEATURES     0x020
+#define VIRTIO_REG_DRIVER_FEATURES_SEL 0x024
+#define VIRTIO_REG_GUEST_PAGE_SIZE     0x028   // legacy only
+#define VIRTIO_REG_QUEUE_SEL           0x030
+#define VIRTIO_REG_QUEUE_NUM_MAX       0x034
+#define VIRTIO_REG_QUEUE_NUM           0x038
+#define VIRTIO_REG_QUEUE_ALIGN         0x03c   // legacy only
+#define VIRTIO_REG_QUEUE_PFN           0x040   // legacy only
+#define VIRTIO_REG_QUEUE_READY         0x044
+#define VIRTIO_REG_QUEUE_NOTIFY        0x050
+#define VIRTIO_REG_INTERRUPT_STATUS    0x060
+#define VIRTIO_REG_INTERRUPT_ACK       0x064
+#define VIRTIO_REG_STATUS              0x070
+#define VIRTIO_REG_QUEUE_DESC_LOW      0x080
+#define VIRTIO_REG_QUEUE_DESC_HIGH     0x084
+#define VIRTIO_REG_QUEUE_DRIVER_LOW    0x090
+#define VIRTIO_REG_QUEUE_DRIVER_HIGH   0x094
+#define VIRTIO_REG_QUEUE_DEVICE_LOW    0x0a0
+#define VIRTIO_REG_QUEUE_DEVICE_HIGH   0x0a4
+#define VIRTIO_REG_CONFIG              0x100
+
+#define VIRTIO_MAGIC     0x74726976            // "virt"
+#define VIRTIO_DEVICE_BLK 2
+
+// 장치 상태 비트
+#define VIRTIO_STATUS_ACK         1
+#define VIRTIO_STATUS_DRIVER      2
+#define VIRTIO_STATUS_DRIVER_OK   4
+#define VIRTIO_STATUS_FEATURES_OK 8
+
+// VIRTIO_F_VERSION_1 (기능 비트 32: 두 번째 기능 워드의 0번 비트)
+#define VIRTIO_F_VERSION_1_HIGH (1 << 0)
+
+// VIRTIO_BLK_F_FLUSH (기능 비트 9): 쓰기 캐시를 비우는 요청 지원
+#define VIRTIO_BLK_F_FLUSH (1 << 9)
+
+// 디스크립터 플래그
+#define VIRTQ_DESC_F_NEXT  1
+#define VIRTQ_DESC_F_WRITE 2
+
+#define VIRTQ_ENTRY_NUM 16
+
+struct virtq_desc {
+    uint64_t addr;
+    uint32_t len;
+    uint16_t flags;
+    uint16_t next;
+} __attribute__((packed));
+
+struct virtq_avail {
+    uint16_t flags;
+    uint16_t index;
+    uint16_t ring[VIRTQ_ENTRY_NUM];
+} __attribute__((packed));
+
+struct virtq_used_elem {
+    uint32_t id;
+    uint32_t len;
+} __attribute__((packed));
+
+struct virtq_used {
+    uint16_t flags;
+    uint16_t index;
+    struct virtq_used_elem ring[VIRTQ_ENTRY_NUM];
+} __attribute__((packed));
+
+// legacy 레이아웃: 디스크립터와 avail 링 다음 페이지 경계에 used 링
+struct virtio_virtq {
+    struct virtq_desc descs[VIRTQ_ENTRY_NUM];
+    struct virtq_avail avail;
+    struct virtq_used used __attribute__((aligned(PAGE_SIZE)));
+    uint16_t last_used_index;
+} __attribute__((packed));
+
+// virtio-blk 요청
+#define VIRTIO_BLK_T_IN  0
+#define VIRTIO_BLK_T_OUT 1
+#define VIRTIO_BLK_T_FLUSH 4
+#define VIRTIO_BLK_S_OK  0
+#define VIRTIO_BLK_SECTOR_SIZE 512
+
+struct virtio_blk_req_header {
+    uint32_t type;
+    uint32_t reserved;
+    uint64_t sector;
+} __attribute__((packed));
@@ -0,0 +1,231 @@
+#include "blkdev.h"
+#include "virtio.h"
+
+// virtio-blk 드라이버 (virtio-mmio, legacy와 modern 모두 지원)
+// 요청은 디스크립터 체인(헤더 -> 데이터 조각들 -> 상태)으로 보내고 완료될 때까지 폴링함
+// 커널은 물리 주소를 그대로 쓰므로 호출자의 버퍼로 바로 DMA함
+
+struct virtio_blk {
+    uint32_t base;                               // MMIO base address
+    uint32_t version;                            // 1 = legacy, 2 = modern
+    struct virtio_virtq *vq;                     // Request queue (queue 0)
+    struct virtio_blk_req_header *header;        // Request header (device-readable)
+    volatile uint8_t *status;                    // Request status (device-writable)
+    int has_flush;                               // VIRTIO_BLK_F_FLUSH negotiated
+    struct spinlock lock;                        // One request in flight at a time
+    struct block_device dev;
+};
+
+static struct virtio_blk virtio_blk_dev;
+
+static uint32_t virtio_reg_read(struct virtio_blk *blk, uint32_t offset) {
+    return *((volatile uint32_t *)(blk->base + offset));
+}
+
+static void virtio_reg_write(struct virtio_blk *blk, uint32_t offset, uint32_t value) {
+    *((volatile uint32_t *)(blk->base + offset)) = value;
+}
+
+static void virtio_reg_or(struct virtio_blk *blk, uint32_t offset, uint32_t value) {
+    virtio_reg_write(blk, offset, virtio_reg_read(blk, offset) | value);
+}
+
+static const char *virtio_blk_type_name(uint32_t type) {
+    switch (type) {
+    case VIRTIO_BLK_T_IN: return "read";
+    case VIRTIO_BLK_T_OUT: return "write";
+    default: return "flush";
+    }
+}
+
+// 요청 하나를 보내고 완료될 때까지 대기 (데이터 조각이 없으면 flush)
+static int virtio_blk_request(struct virtio_blk *blk, uint32_t type, uint32_t sector,
+                              const struct blkdev_segment *segs, int nsegs) {
+    spin_lock(&blk->lock);
+
+    struct virtio_virtq *vq = blk->vq;
+    blk->header->type = type;
+    blk->header->reserved = 0;
+    blk->header->sector = sector;
+    *blk->status = 0xff;
+
+    vq->descs[0].addr = (uint32_t)blk->header;
+    vq->descs[0].len = sizeof(struct virtio_blk_req_header);
+    vq->descs[0].flags = VIRTQ_DESC_F_NEXT;
+    vq->descs[0].next = 1;
+
+    int d = 1;
+    for (int i = 0; i < nsegs; i++, d++) {
+        vq->descs[d].addr = (uint32_t)segs[i].buf;
+        vq->descs[d].len = segs[i].count * VIRTIO_BLK_SECTOR_SIZE;
+        vq->descs[d].flags = VIRTQ_DESC_F_NEXT | (type == VIRTIO_BLK_T_IN ? VIRTQ_DESC_F_WRITE : 0);
+        vq->descs[d].next = d + 1;
+    }
+
+    vq->descs[d].addr = (uint32_t)blk->status;
+    vq->descs[d].len = 1;
+    vq->descs[d].flags = VIRTQ_DESC_F_WRITE;
+    vq->descs[d].next = 0;
+
+    // Publish the chain head, then the new avail index, then notify
+    vq->avail.ring[vq->avail.index % VIRTQ_ENTRY_NUM] = 0;
+    __sync_synchronize();
+    vq->avail.index++;
+    __sync_synchronize();
+    virtio_reg_write(blk, VIRTIO_REG_QUEUE_NOTIFY, 0);
+
+    vq->last_used_index++;
+    while (*((volatile uint16_t *)&vq->used.index) != vq->last_used_index) {}
+    __sync_synchronize();
+
+    // Completion is polled, so just acknowledge the interrupt
+    virtio_reg_write(blk, VIRTIO_REG_INTERRUPT_ACK, virtio_reg_read(blk, VIRTIO_REG_INTERRUPT_STATUS));
+
+    uint8_t status = *blk->status;
+    spin_unlock(&blk->lock);
+
+    if (status != VIRTIO_BLK_S_OK) {
+        printf("Error: virtio-blk: %s of sector %u failed (status=%d)\n",
+               virtio_blk_type_name(type), sector, status);
+        return -1;
+    }
+    return 0;
+}
+
+static int virtio_blk_read(struct block_device *dev, uint32_t block, uint32_t count, void *buf) {
+    struct blkdev_segment seg = { buf, count };
+    return virtio_blk_request((struct virtio_blk *)dev->ctx, VIRTIO_BLK_T_IN, block, &seg, 1);
+}
+
+static int virtio_blk_write(struct block_device *dev, uint32_t block, uint32_t count, const void *buf) {
+    struct blkdev_segment seg = { (void *)buf, count };
+    return virtio_blk_request((struct virtio_blk *)dev->ctx, VIRTIO_BLK_T_OUT, block, &seg, 1);
+}
+
+static int virtio_blk_read_segments(struct block_device *dev, uint32_t block,
+                                    const struct blkdev_segment *segs, int nsegs) {
+    return virtio_blk_request((struct virtio_blk *)dev->ctx, VIRTIO_BLK_T_IN, block, segs, nsegs);
+}
+
+static int virtio_blk_write_segments(struct block_device *dev, uint32_t block,
+                                     const struct blkdev_segment *segs, int nsegs) {
+    return virtio_blk_request((struct virtio_blk *)dev->ctx, VIRTIO_BLK_T_OUT, block, segs, nsegs);
+}
+
+static int virtio_blk_flush(struct block_device *dev) {
+    struct virtio_blk *blk = (struct virtio_blk *)dev->ctx;
+    if (!blk->has_flush) {
+        return 0;
+    }
+    return virtio_blk_request(blk, VIRTIO_BLK_T_FLUSH, 0, NULL, 0);
+}
+
+static struct block_device_ops virtio_blk_ops = {
+    .read = virtio_blk_read,
+    .write = virtio_blk_write,
+    .read_segments = virtio_blk_read_segments,
+    .write_segments = virtio_blk_write_segments,
+    .flush = virtio_blk_flush,
+};
+
+// 장치 초기화 순서: reset -> ACK -> DRIVER -> 기능 협상 -> 큐 설정 -> DRIVER_OK
+static int virtio_blk_init(struct virtio_blk *blk) {
+    virtio_reg_write(blk, VIRTIO_REG_STATUS, 0);
+    virtio_reg_or(blk, VIRTIO_REG_STATUS, VIRTIO_STATUS_ACK);
+    virtio_reg_or(blk, VIRTIO_REG_STATUS, VIRTIO_STATUS_DRIVER);
+
+    // Only the cache flush command is negotiated from the low feature word
+    virtio_reg_write(blk, VIRTIO_REG_DEVICE_FEATURES_SEL, 0);
+    uint32_t features = virtio_reg_read(blk, VIRTIO_REG_DEVICE_FEATURES) & VIRTIO_BLK_F_FLUSH;
+    blk->has_flush = features != 0;
+
+    if (blk->version == 2) {
+        // Modern devices must be offered VIRTIO_F_VERSION_1
+        virtio_reg_write(blk, VIRTIO_REG_DEVICE_FEATURES_SEL, 1);
+        if (!(virtio_reg_read(blk, VIRTIO_REG_DEVICE_FEATURES) & VIRTIO_F_VERSION_1_HIGH)) {
+            printf("Error: virtio-blk: device does not offer VERSION_1\n");
+            return -1;
+        }
+        virtio_reg_write(blk, VIRTIO_REG_DRIVER_FEATURES_SEL, 0);
+        virtio_reg_write(blk, VIRTIO_REG_DRIVER_FEATURES, features);
+        virtio_reg_write(blk, VIRTIO_REG_DRIVER_FEATURES_SEL, 1);
+        virtio_reg_write(blk, VIRTIO_REG_DRIVER_FEATURES, VIRTIO_F_VERSION_1_HIGH);
+    } else {
+        virtio_reg_write(blk, VIRTIO_REG_DRIVER_FEATURES, features);
+        virtio_reg_write(blk, VIRTIO_REG_GUEST_PAGE_SIZE, PAGE_SIZE);
+    }
+
+    virtio_reg_or(blk, VIRTIO_REG_STATUS, VIRTIO_STATUS_FEATURES_OK);
+    if (!(virtio_reg_read(blk, VIRTIO_REG_STATUS) & VIRTIO_STATUS_FEATURES_OK)) {
+        printf("Error: virtio-blk: feature negotiation failed\n");
+        return -1;
+    }
+
+    // Request queue
+    virtio_reg_write(blk, VIRTIO_REG_QUEUE_SEL, 0);
+    if (virtio_reg_read(blk, VIRTIO_REG_QUEUE_NUM_MAX) < VIRTQ_ENTRY_NUM) {
+        printf("Error: virtio-blk: queue too small\n");
+        return -1;
+    }
+    virtio_reg_write(blk, VIRTIO_REG_QUEUE_NUM, VIRTQ_ENTRY_NUM);
+
+    uint32_t vq_pages = (sizeof(struct virtio_virtq) + PAGE_SIZE - 1) / PAGE_SIZE;
+    blk->vq = (struct virtio_virtq *)alloc_pages(vq_pages);
+    blk->vq->last_used_index = 0;
+
+    if (blk->version == 2) {
+        virtio_reg_write(blk, VIRTIO_REG_QUEUE_DESC_LOW, (uint32_t)blk->vq->descs);
+        virtio_reg_write(blk, VIRTIO_REG_QUEUE_DESC_HIGH, 0);
+        virtio_reg_write(blk, VIRTIO_REG_QUEUE_DRIVER_LOW, (uint32_t)&blk->vq->avail);
+        virtio_reg_write(blk, VIRTIO_REG_QUEUE_DRIVER_HIGH, 0);
+        virtio_reg_write(blk, VIRTIO_REG_QUEUE_DEVICE_LOW, (uint32_t)&blk->vq->used);
+        virtio_reg_write(blk, VIRTIO_REG_QUEUE_DEVICE_HIGH, 0);
+        virtio_reg_write(blk, VIRTIO_REG_QUEUE_READY, 1);
+    } else {
+        virtio_reg_write(blk, VIRTIO_REG_QUEUE_ALIGN, PAGE_SIZE);
+        virtio_reg_write(blk, VIRTIO_REG_QUEUE_PFN, (uint32_t)blk->vq / PAGE_SIZE);
+    }
+
+    // Header and status share one page
+    uint8_t *req_page = (uint8_t *)alloc_pages(1);
+    blk->header = (struct virtio_blk_req_header *)req_page;
+    blk->status = req_page + sizeof(struct virtio_blk_req_header);
+    spin_init(&blk->lock);
+
+    virtio_reg_or(blk, VIRTIO_REG_STATUS, VIRTIO_STATUS_DRIVER_OK);
+
+    // Capacity is a 64-bit sector count; anything past 32 bits is unreachable here
+    uint32_t capacity = virtio_reg_read(blk, VIRTIO_REG_CONFIG);
+    if (virtio_reg_read(blk, VIRTIO_REG_CONFIG + 4) != 0) {
+        capacity = 0xFFFFFFFF;
+    }
+
+    blk->dev.name = "virtio-blk";
+    blk->dev.block_count = capacity;
+    blk->dev.ops = &virtio_blk_ops;
+    blk->dev.ctx = blk;
+    return 0;
+}
+
+struct block_device *virtio_blk_probe(void) {
+    for (int slot = 0; slot < VIRTIO_MMIO_SLOTS; slot++) {
+        struct virtio_blk *blk = &virtio_blk_dev;
+        blk->base = VIRTIO_MMIO_BASE + slot * VIRTIO_MMIO_STRIDE;
+
+        if (virtio_reg_read(blk, VIRTIO_REG_MAGIC) != VIRTIO_MAGIC ||
+            virtio_reg_read(blk, VIRTIO_REG_DEVICE_ID) != VIRTIO_DEVICE_BLK) {
+            continue;
+        }
+
+        blk->version = virtio_reg_read(blk, VIRTIO_REG_VERSION);
+        if (virtio_blk_init(blk) < 0) {
+            return NULL;
+        }
+
+        printf("virtio-blk: found at 0x%x (version %u), %u sectors (%u KB)\n",
+               blk->base, blk->version, blk->dev.block_count, blk->dev.block_count / 2);
+        return &blk->dev;
+    }
+
+    return NULL;
+}
@@ -0,0 +1,281 @@
+#include "vm.h"
+#include "inode.h"
+
+extern char __free_ram_end[];
+
+struct vm_space *vm_current;
+
+// 해제된 페이지 테이블 (alloc_pages는 돌려받지 않으므로 여기서 다시 씀, 첫 워드가 다음 항목)
+static uint32_t *free_tables;
+
+static uint32_t *vm_alloc_table(void) {
+    uint32_t *table = free_tables;
+    if (table) {
+        free_tables = (uint32_t *)table[0];
+        memset(table, 0, PAGE_SIZE);
+        return table;
+    }
+    return (uint32_t *)alloc_pages(1);
+}
+
+static void vm_free_table(uint32_t *table) {
+    table[0] = (uint32_t)free_tables;
+    free_tables = table;
+}
+
+static uint32_t pte_make(paddr_t paddr, uint32_t flags) {
+    return ((paddr / PAGE_SIZE) << 10) | flags;
+}
+
+static paddr_t pte_paddr(uint32_t pte) {
+    return (pte >> 10) * PAGE_SIZE;
+}
+
+static void vm_flush_tlb(void) {
+    __asm__ __volatile__("sfence.vma" ::: "memory");
+}
+
+// 가상 주소의 L0 항목 (alloc이면 L0 테이블을 만듦, 없으면 NULL)
+static uint32_t *vm_pte(struct vm_space *vm, vaddr_t addr, int alloc) {
+    uint32_t *l1 = &vm->page_table[addr >> 22];
+    if (!(*l1 & PTE_V)) {
+        if (!alloc) {
+            return NULL;
+        }
+        uint32_t *table = vm_alloc_table();
+        *l1 = pte_make((paddr_t)table, PTE_V);
+    }
+    uint32_t *l0 = (uint32_t *)pte_paddr(*l1);
+    return &l0[(addr >> 12) & (VM_PTES_PER_TABLE - 1)];
+}
+
+static struct vm_area *vm_find_area(struct vm_space *vm, vaddr_t addr) {
+    for (int i = 0; i < VM_MAX_AREAS; i++) {
+        struct vm_area *area = &vm->areas[i];
+        if (area->in_use && addr >= area->start && addr < area->end) {
+            return area;
+        }
+    }
+    return NULL;
+}
+
+struct vm_space *vm_create(void) {
+    struct vm_space *vm = (struct vm_space *)kmalloc(sizeof(struct vm_space));
+    if (!vm) {
+        printf("Error: No memory for an address space\n");
+        return NULL;
+    }
+    memset(vm, 0, sizeof(struct vm_space));
+    vm->page_table = vm_alloc_table();
+    vm->mmap_next = VM_MMAP_BASE;
+
+    // The kernel keeps running at the same addresses: RAM and MMIO as global megapages
+    uint32_t kernel_flags = PTE_V | PTE_R | PTE_W | PTE_X | PTE_G | PTE_A | PTE_D;
+    for (paddr_t addr = VM_KERNEL_BASE; addr < (paddr_t)__free_ram_end && addr >= VM_KERNEL_BASE;
+         addr += VM_MEGAPAGE_SIZE) {
+        vm->page_table[addr >> 22] = pte_make(addr, kernel_flags);
+    }
+    vm->page_table[VM_MMIO_BASE >> 22] = pte_make(VM_MMIO_BASE, PTE_V | PTE_R | PTE_W | PTE_G | PTE_A | PTE_D);
+    return vm;
+}
+
+void vm_destroy(struct vm_space *vm) {
+    if (!vm) {
+        return;
+    }
+    if (vm_current == vm) {
+        vm_activate(NULL);
+    }
+    for (int i = 0; i < VM_MAX_AREAS; i++) {
+        if (vm->areas[i].in_use) {
+            vm_munmap(vm, (void *)vm->areas[i].start);
+        }
+    }
+
+    // L0 tables only exist below the kernel megapages
+    for (uint32_t i = 0; i < VM_KERNEL_BASE >> 22; i++) {
+        uint32_t pte = vm->page_table[i];
+        if ((pte & PTE_V) && !(pte & (PTE_R | PTE_W | PTE_X))) {
+            vm_free_table((uint32_t *)pte_paddr(pte));
+        }
+    }
+    vm_free_table(vm->page_table);
+    kfree(vm);
+}
+
+void vm_activate(struct vm_space *vm) {
+    vm_current = vm;
+    WRITE_CSR(satp, vm ? SATP_SV32 | ((paddr_t)vm->page_table / PAGE_SIZE) : 0);
+}
+
+void *vm_mmap(struct vm_space *vm, struct btree_filesystem *fs, const char *path,
+              uint32_t offset, uint32_t length, uint32_t prot) {
+    if (offset % PAGE_SIZE || length == 0 || !(prot & VM_PROT_READ)) {
+        printf("Error: Invalid mapping\n");
+        return NULL;
+    }
+
+    int inode_num = btree_fs_open(fs, path);
+    struct inode *inode = inode_num < 0 ? NULL : inode_get(fs, inode_num);
+    if (!inode || inode->type == INODE_TYPE_DIR) {
+        printf("Error: File not found\n");
+        return NULL;
+    }
+
+    uint32_t size = (length + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+    struct vm_area *area = NULL;
+    for (int i = 0; i < VM_MAX_AREAS && !area; i++) {
+        if (!vm->areas[i].in_use) {
+            area = &vm->areas[i];
+        }
+    }
+    if (!area || size > VM_MMAP_END - vm->mmap_next) {
+        printf("Error: No room for another mapping\n");
+        return NULL;
+    }
+
+    // Pages come from the page cache, so inline data has to move to a block first
+    if ((inode->flags & INODE_FLAG_INLINE) && inode_promote(fs, inode) < 0) {
+        return NULL;
+    }
+
+    area->start = vm->mmap_next;
+    area->end = area->start + size;
+    area->fs = fs;
+    area->inode = inode;
+    area->offset = offset;
+    area->prot = prot;
+    area->in_use = 1;
+    vm->mmap_next = area->end;
+    inode->mmaps++;
+    return (void *)area->start;
+}
+
+// 매핑된 페이지 순회: 쓸 수 있게 매핑된 페이지는 더티로 표시하고, unmap이면 항목을 지우고 고정을 풂
+static void vm_sync_area(struct vm_space *vm, struct vm_area *area, int unmap) {
+    for (vaddr_t addr = area->start; addr < area->end; addr += PAGE_SIZE) {
+        uint32_t *pte = vm_pte(vm, addr, 0);
+        if (!pte || !(*pte & PTE_V)) {
+            continue;
+        }
+
+        uint32_t index = (area->offset + (addr - area->start)) / PAGE_SIZE;
+        if (*pte & PTE_W) {
+            page_cache_map_dirty(area->inode, index);
+        }
+        if (unmap) {
+            page_cache_unmap(area->inode, index);
+            *pte = 0;
+        } else {
+            // Write-protect again so the next store is seen
+            *pte &= ~(PTE_W | PTE_D);
+        }
+    }
+    vm_flush_tlb();
+}
+
+int vm_munmap(struct vm_space *vm, void *addr) {
+    struct vm_area *area = vm_find_area(vm, (vaddr_t)addr);
+    if (!area || area->start != (vaddr_t)addr) {
+        printf("Error: No mapping at %x\n", (vaddr_t)addr);
+        return -1;
+    }
+
+    vm_sync_area(vm, area, 1);
+    area->inode->mmaps--;
+    area->in_use = 0;
+    if (area->end == vm->mmap_next) {
+        vm->mmap_next = area->start;
+    }
+    return 0;
+}
+
+int vm_msync(struct vm_space *vm, void *addr) {
+    struct vm_area *area = vm_find_area(vm, (vaddr_t)addr);
+    if (!area) {
+        printf("Error: No mapping at %x\n", (vaddr_t)addr);
+        return -1;
+    }
+
+    vm_sync_area(vm, area, 0);
+    return inode_fsync(area->fs, area->inode);
+}
+
+// 쓰기로 매핑할 페이지의 구멍에 블록 할당 (페이지는 이미 0으로 채워져 있음, 압축 파일은 write-back에서 할당)
+static int vm_alloc_blocks(struct vm_area *area, uint32_t index) {
+    struct inode *inode = area->inode;
+    if (inode->flags & INODE_FLAG_COMPRESS) {
+        return 0;
+    }
+
+    uint32_t first = index * (PAGE_SIZE / FS_BLOCK_SIZE);
+    uint32_t end = (inode->size + FS_BLOCK_SIZE - 1) / FS_BLOCK_SIZE;
+    for (uint32_t b = first; b < first + PAGE_SIZE / FS_BLOCK_SIZE && b < end; b++) {
+        if (inode_bmap(area->fs, inode, b, 0) == 0 && inode_bmap(area->fs, inode, b, 1) == 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int vm_handle_fault(struct vm_space *vm, vaddr_t addr, int write) {
+    if (!vm) {
+        return -1;
+    }
+    struct vm_area *area = vm_find_area(vm, addr);
+    if (!area || (write && !(area->prot & VM_PROT_WRITE))) {
+        return -1;
+    }
+
+    // Nothing to map past the end of the file
+    vaddr_t page_addr = addr & ~(PAGE_SIZE - 1);
+    uint32_t index = (area->offset + (page_addr - area->start)) / PAGE_SIZE;
+    if (index >= (area->inode->size + PAGE_SIZE - 1) / PAGE_SIZE) {
+        return -1;
+    }
+
+    uint32_t *pte = vm_pte(vm, page_addr, 1);
+    if (*pte & PTE_V) {
+        // A store to a page mapped for reading: it becomes dirty from here on
+        if (!write || (*pte & PTE_W) || vm_alloc_blocks(area, index) < 0) {
+            return -1;
+        }
+        page_cache_map_dirty(area->inode, index);
+        *pte |= PTE_W | PTE_D;
+        vm_flush_tlb();
+        vm->faults++;
+        return 0;
+    }
+
+    // The cached page itself is mapped; it stays pinned until unmapped.
+    // Reads map it read-only so the first store is seen and dirties it
+    uint8_t *frame = page_cache_map(area->fs, area->inode, index);
+    if (!frame) {
+        return -1;
+    }
+    uint32_t flags = PTE_V | PTE_R | PTE_A;
+    if (write) {
+        if (vm_alloc_blocks(area, index) < 0) {
+            page_cache_unmap(area->inode, index);
+            return -1;
+        }
+        page_cache_map_dirty(area->inode, index);
+        flags |= PTE_W | PTE_D;
+    }
+    *pte = pte_make((paddr_t)frame, flags);
+    vm_flush_tlb();
+    vm->faults++;
+    return 0;
+}
+
+paddr_t vm_translate(struct vm_space *vm, vaddr_t addr) {
+    uint32_t l1 = vm->page_table[addr >> 22];
+    if (!(l1 & PTE_V)) {
+        return 0;
+    }
+    if (l1 & (PTE_R | PTE_W | PTE_X)) {
+        return pte_paddr(l1) + (addr & (VM_MEGAPAGE_SIZE - 1));
+    }
+    uint32_t *pte = vm_pte(vm, addr, 0);
+    return (*pte & PTE_V) ? pte_paddr(*pte) + (addr & (PAGE_SIZE - 1)) : 0;
+}
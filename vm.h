@@ -0,0 +1,75 @@
+#pragma once
+#include "kernel.h"
+
+struct btree_filesystem;
+struct inode;
+
+// Sv32 페이징: 2단계 페이지 테이블 (L1 항목 하나가 4MB, L0 항목 하나가 4KB)
+// 커널 영역(RAM과 MMIO)은 모든 주소 공간에 4MB 메가페이지로 같은 주소에 매핑하고,
+// 그 아래 VM_MMAP_BASE부터 파일 매핑을 둠
+#define SATP_SV32 (1u << 31)
+
+#define PTE_V (1 << 0)
+#define PTE_R (1 << 1)
+#define PTE_W (1 << 2)
+#define PTE_X (1 << 3)
+#define PTE_U (1 << 4)
+#define PTE_G (1 << 5)
+#define PTE_A (1 << 6)
+#define PTE_D (1 << 7)
+
+#define VM_PTES_PER_TABLE 1024
+#define VM_MEGAPAGE_SIZE (4 * 1024 * 1024)
+#define VM_KERNEL_BASE 0x80000000                // RAM on the virt machine
+#define VM_MMIO_BASE 0x10000000                  // UART and virtio-mmio, one megapage
+#define VM_MMAP_BASE 0x40000000                  // File mappings are placed from here up
+#define VM_MMAP_END 0x80000000
+
+#define VM_MAX_AREAS 8
+
+// 매핑 권한
+#define VM_PROT_READ  0x1
+#define VM_PROT_WRITE 0x2
+
+// 파일 매핑 하나: [start, end)가 파일의 offset부터 이어짐 (페이지는 처음 접근할 때 매핑)
+struct vm_area {
+    vaddr_t start;
+    vaddr_t end;
+    struct btree_filesystem *fs;
+    struct inode *inode;
+    uint32_t offset;                             // File offset of start (page aligned)
+    uint32_t prot;                               // VM_PROT_*
+    int in_use;
+};
+
+// 주소 공간: 프로세스마다 하나 (NULL이면 페이징 없이 실행)
+struct vm_space {
+    uint32_t *page_table;                        // L1 table (one page)
+    struct vm_area areas[VM_MAX_AREAS];
+    vaddr_t mmap_next;                           // Where the next mapping is placed
+    uint32_t faults;                             // Demand faults served
+};
+
+// 지금 satp에 올라가 있는 주소 공간 (페이지 폴트를 처리할 곳)
+extern struct vm_space *vm_current;
+
+struct vm_space *vm_create(void);
+void vm_destroy(struct vm_space *vm);
+
+// satp 교체 (vm이 NULL이면 페이징 끔)
+void vm_activate(struct vm_space *vm);
+
+// 파일의 [offset, offset + length)를 매핑하고 시작 주소 반환 (실패하면 NULL)
+// 페이지는 접근할 때 페이지 캐시의 프레임이 그대로 매핑되므로 복사가 없음
+void *vm_mmap(struct vm_space *vm, struct btree_filesystem *fs, const char *path,
+              uint32_t offset, uint32_t length, uint32_t prot);
+int vm_munmap(struct vm_space *vm, void *addr);
+
+// 매핑으로 쓴 내용을 파일에 기록 (이후의 쓰기는 다시 폴트로 잡음)
+int vm_msync(struct vm_space *vm, void *addr);
+
+// 페이지 폴트 처리: 매핑 안의 주소면 페이지를 연결하고 0, 아니면 -1
+int vm_handle_fault(struct vm_space *vm, vaddr_t addr, int write);
+
+// 가상 주소의 물리 주소 (매핑되지 않았으면 0)
+paddr_t vm_translate(struct vm_space *vm, vaddr_t addr);